@@ -65,16 +65,23 @@ class PRAutoMap : public minigraph::AutoMapBase<GRAPH_T, CONTEXT_T> {
   static bool kernel_push_border_vertexes(GRAPH_T* graph, const size_t tid,
                                           Bitmap* visited, const size_t step,
                                           Bitmap* global_border_vid_map,
-                                          VDATA_T* global_border_vdata) {
+                                          VDATA_T* global_border_vdata,
+                                          double* update_magnitude) {
+    // Sum of the deltas pushed to other fragments.
+    double local_magnitude = 0;
     for (size_t i = tid; i < graph->get_num_vertexes(); i += step) {
       if (!global_border_vid_map->get_bit(graph->localid2globalid(i))) continue;
       auto u = graph->GetVertexByIndex(i);
       auto global_id = graph->localid2globalid(u.vid);
-      if (*(global_border_vdata + global_id) != u.vdata[0]) {
+      VDATA_T prev = *(global_border_vdata + global_id);
+      if (prev != u.vdata[0]) {
         write_min((global_border_vdata + global_id), u.vdata[0]);
         visited->set_bit(i);
+        local_magnitude += prev > u.vdata[0] ? prev - u.vdata[0]
+                                             : u.vdata[0] - prev;
       }
     }
+    write_add(update_magnitude, local_magnitude);
     return true;
   }
 
@@ -204,11 +211,13 @@ class PRPIE : public minigraph::AutoAppBase<GRAPH_T, CONTEXT_T> {
                                   vid_map, &visited);
       std::swap(in_visited, out_visited);
     }
+    double update_magnitude = 0;
     this->auto_map_->ActiveMap(
         graph, task_runner, &visited,
         PRAutoMap<GRAPH_T, CONTEXT_T>::kernel_push_border_vertexes,
         this->msg_mngr_->GetGlobalBorderVidMap(),
-        this->msg_mngr_->GetGlobalVdata());
+        this->msg_mngr_->GetGlobalVdata(), &update_magnitude);
+    minigraph::ThreadUpdateMagnitude() = update_magnitude;
 
     auto end_time = std::chrono::system_clock::now();
     std::cout << "Gid " << graph.gid_ << ":  PEval elapse time "
@@ -254,11 +263,13 @@ class PRPIE : public minigraph::AutoAppBase<GRAPH_T, CONTEXT_T> {
       out_visited->clear();
     }
 
+    double update_magnitude = 0;
     this->auto_map_->ActiveMap(
         graph, task_runner, visited,
         PRAutoMap<GRAPH_T, CONTEXT_T>::kernel_push_border_vertexes,
         this->msg_mngr_->GetGlobalBorderVidMap(),
-        this->msg_mngr_->GetGlobalVdata());
+        this->msg_mngr_->GetGlobalVdata(), &update_magnitude);
+    minigraph::ThreadUpdateMagnitude() = update_magnitude;
 
     auto end_time = std::chrono::system_clock::now();
     std::cout << "Gid " << graph.gid_ << ":  IncEval elapse time "
@@ -306,7 +317,11 @@ int main(int argc, char* argv[]) {
   minigraph::MiniGraphSys<CSR_T, PRPIE_T> minigraph_sys(
       work_space, num_workers_lc, num_workers_cc, num_workers_dc, num_cores,
       buffer_size, app_wrapper, FLAGS_mode, num_iter);
+  if (FLAGS_trace != "") minigraph_sys.EnableTrace(FLAGS_trace);
+  if (FLAGS_metrics_out != "")
+    minigraph_sys.EnableMetrics(FLAGS_metrics_out, FLAGS_metrics_interval);
   minigraph_sys.RunSys();
+  if (FLAGS_bench_out != "") minigraph_sys.WriteRunInfo(FLAGS_bench_out);
   // minigraph_sys.ShowResult(30);
   gflags::ShutDownCommandLineFlags();
   exit(0);
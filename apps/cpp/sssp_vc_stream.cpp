@@ -49,17 +49,26 @@ class SSSPAutoMap : public minigraph::AutoMapBase<GRAPH_T, CONTEXT_T> {
 
   static void kernel_update(GRAPH_T* graph, const size_t tid, Bitmap* visited,
                             const size_t step, Bitmap* out_visited,
-                            VDATA_T* global_border_vdata) {
+                            VDATA_T* global_border_vdata,
+                            double max_improvement, double* update_magnitude) {
+    // Sum of the distance improvements of vertexes of other fragments, where
+    // reaching a vertex for the first time counts as max_improvement.
+    double local_magnitude = 0;
     for (size_t i = tid; i < graph->get_num_vertexes(); i += step) {
       auto u = graph->GetVertexByIndex(i);
       for (size_t j = 0; j < u.outdegree; ++j) {
-        if (write_min(&global_border_vdata[u.out_edges[j]],
-                      global_border_vdata[graph->localid2globalid(i)] + 1)) {
+        VDATA_T prev = global_border_vdata[u.out_edges[j]];
+        VDATA_T next = global_border_vdata[graph->localid2globalid(i)] + 1;
+        if (write_min(&global_border_vdata[u.out_edges[j]], next)) {
           out_visited->set_bit(u.out_edges[j]);
           visited->set_bit(i);
+          if (graph->IsInGraph(u.out_edges[j])) continue;
+          local_magnitude +=
+              prev == VDATA_MAX ? max_improvement : (double)prev - next;
         }
       }
     }
+    write_add(update_magnitude, local_magnitude);
     return;
   }
 };
@@ -117,14 +126,18 @@ class SSSPPIE : public minigraph::AutoAppBase<GRAPH_T, CONTEXT_T> {
     u.vdata[0] = 0;
     in_visited->set_bit(vid_map[this->context_.root_id]);
     visited.set_bit(vid_map[this->context_.root_id]);
+    double max_improvement = this->msg_mngr_->get_max_vid() + 1;
+    double update_magnitude = 0;
     while (!in_visited->empty()) {
-      this->auto_map_->ActiveMap(graph, task_runner, &visited,
-                                 SSSPAutoMap<GRAPH_T, CONTEXT_T>::kernel_update,
-                                 out_visited,
-                                 this->msg_mngr_->GetGlobalVdata());
+      this->auto_map_->ActiveMap(
+          graph, task_runner, &visited,
+          SSSPAutoMap<GRAPH_T, CONTEXT_T>::kernel_update, out_visited,
+          this->msg_mngr_->GetGlobalVdata(), max_improvement,
+          &update_magnitude);
       std::swap(in_visited, out_visited);
       out_visited->clear();
     }
+    minigraph::ThreadUpdateMagnitude() = update_magnitude;
 
     delete in_visited;
     delete out_visited;
@@ -144,14 +157,18 @@ class SSSPPIE : public minigraph::AutoAppBase<GRAPH_T, CONTEXT_T> {
     Bitmap visited(graph.get_num_vertexes());
     visited.clear();
 
+    double max_improvement = this->msg_mngr_->get_max_vid() + 1;
+    double update_magnitude = 0;
     while (!in_visited->empty()) {
-      this->auto_map_->ActiveMap(graph, task_runner, &visited,
-                                 SSSPAutoMap<GRAPH_T, CONTEXT_T>::kernel_update,
-                                 out_visited,
-                                 this->msg_mngr_->GetGlobalVdata());
+      this->auto_map_->ActiveMap(
+          graph, task_runner, &visited,
+          SSSPAutoMap<GRAPH_T, CONTEXT_T>::kernel_update, out_visited,
+          this->msg_mngr_->GetGlobalVdata(), max_improvement,
+          &update_magnitude);
       std::swap(in_visited, out_visited);
       out_visited->clear();
     }
+    minigraph::ThreadUpdateMagnitude() = update_magnitude;
 
     delete in_visited;
     delete out_visited;
@@ -191,7 +208,11 @@ int main(int argc, char* argv[]) {
   minigraph::MiniGraphSys<CSR_T, SSSPPIE_T> minigraph_sys(
       work_space, num_workers_lc, num_workers_cc, num_workers_dc, num_cores,
       buffer_size, app_wrapper, FLAGS_mode);
+  if (FLAGS_trace != "") minigraph_sys.EnableTrace(FLAGS_trace);
+  if (FLAGS_metrics_out != "")
+    minigraph_sys.EnableMetrics(FLAGS_metrics_out, FLAGS_metrics_interval);
   minigraph_sys.RunSys();
+  if (FLAGS_bench_out != "") minigraph_sys.WriteRunInfo(FLAGS_bench_out);
   // minigraph_sys.ShowResult(3);
   gflags::ShutDownCommandLineFlags();
   exit(0);
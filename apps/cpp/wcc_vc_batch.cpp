@@ -282,7 +282,11 @@ int main(int argc, char* argv[]) {
   minigraph::MiniGraphSys<CSR_T, WCCPIE_T> minigraph_sys(
       work_space, num_workers_lc, num_workers_cc, num_workers_dc, num_cores,
       buffer_size, app_wrapper, FLAGS_mode, FLAGS_niters, FLAGS_scheduler);
+  if (FLAGS_trace != "") minigraph_sys.EnableTrace(FLAGS_trace);
+  if (FLAGS_metrics_out != "")
+    minigraph_sys.EnableMetrics(FLAGS_metrics_out, FLAGS_metrics_interval);
   minigraph_sys.RunSys();
+  if (FLAGS_bench_out != "") minigraph_sys.WriteRunInfo(FLAGS_bench_out);
   gflags::ShutDownCommandLineFlags();
   exit(0);
 }
@@ -16,7 +16,6 @@ esac
 
 # Download third party header libraries.
 # Third party libraries include:
-#   - boost-ext/sml v1.1.4 https://boost-ext.github.io/sml/
 #   - Rapidcsv https://github.com/d99kris/rapidcsv
 echo "Updating Submodules"
 cd $CDIR
@@ -18,10 +18,27 @@
 #include "portability/sys_types.h"
 #include "utility/atomic.h"
 #include "utility/bitmap.h"
+#include "utility/metrics.h"
 #include "utility/thread_pool.h"
 
 namespace minigraph {
 
+// Vertexes ActiveEMap / ActiveVMap found active on the calling thread. CC
+// resets it before each PEval / IncEval, and publishes it after.
+inline size_t& ThreadActiveVertexes() {
+  thread_local size_t num_active_vertexes = 0;
+  return num_active_vertexes;
+}
+
+// Magnitude of the updates the PEval / IncEval on the calling thread sends to
+// other fragments, e.g. the sum of deltas for PageRank or of distance
+// improvements for SSSP. Apps may set it to prioritize the receivers in Async
+// mode; CC resets it to -1 and uses the number of active vertexes if left so.
+inline double& ThreadUpdateMagnitude() {
+  thread_local double update_magnitude = -1;
+  return update_magnitude;
+}
+
 template <typename GRAPH_T, typename CONTEXT_T>
 class AutoMapBase {
   using GID_T = typename GRAPH_T::gid_t;
@@ -53,6 +70,7 @@ class AutoMapBase {
     out_visited->clear();
     std::vector<std::function<void()>> tasks;
     bool global_visited = false;
+    size_t active_vertices = si == nullptr ? 0 : si->num_active_vertexes;
 
     for (size_t tid = 0; tid < task_runner->GetParallelism(); ++tid) {
       auto task = std::bind(&AutoMapBase<GRAPH_T, CONTEXT_T>::ActiveEReduce,
@@ -62,6 +80,13 @@ class AutoMapBase {
       tasks.push_back(task);
     }
     task_runner->Run(tasks, false);
+    if (si != nullptr) {
+      active_vertices = si->num_active_vertexes - active_vertices;
+      ThreadActiveVertexes() += active_vertices;
+      utility::Metrics::Get().Add("minigraph_active_vertexes_total",
+                                  active_vertices,
+                                  utility::Metrics::ThreadSuperstep());
+    }
     return global_visited;
   };
 
@@ -86,6 +111,10 @@ class AutoMapBase {
     // LOG_INFO("AutoMap ActiveVMap Run");
     task_runner->Run(tasks, false);
     // LOG_INFO("# ", active_vertices);
+    ThreadActiveVertexes() += active_vertices;
+    utility::Metrics::Get().Add("minigraph_active_vertexes_total",
+                                active_vertices,
+                                utility::Metrics::ThreadSuperstep());
     return global_visited;
   };
 
@@ -0,0 +1,129 @@
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "2d_pie/auto_map.h"
+#include "benchmarks/random_graph.h"
+#include "executors/scheduled_executor.h"
+#include "graphs/csr_builder.h"
+#include "graphs/immutable_csr.h"
+#include "portability/sys_data_structure.h"
+#include "portability/sys_types.h"
+#include "utility/atomic.h"
+#include "utility/bitmap.h"
+
+namespace minigraph {
+
+using CSR_T = graphs::ImmutableCSR<gid_t, vid_t, vdata_t, edata_t>;
+using VertexInfo = graphs::VertexInfo<vid_t, vdata_t, edata_t>;
+
+constexpr size_t kNumVertexes = 1 << 18;
+constexpr size_t kNumEdges = 1 << 22;
+
+struct Context {};
+
+// Label propagation, as in WCC.
+class MinLabelAutoMap : public AutoMapBase<CSR_T, Context> {
+ public:
+  bool F(const VertexInfo& u, VertexInfo& v, CSR_T* graph = nullptr) override {
+    return write_min(v.vdata, u.vdata[0]);
+  }
+
+  bool F(VertexInfo& u, CSR_T* graph = nullptr,
+         vid_t* vid_map = nullptr) override {
+    bool changed = false;
+    for (size_t i = 0; i < u.outdegree; i++) {
+      auto v = graph->GetVertexByVid(graph->globalid2localid(u.out_edges[i]));
+      changed |= write_min(u.vdata, v.vdata[0]);
+    }
+    return changed;
+  }
+};
+
+// All vertexes are active and labeled by their vid, so that the first round
+// of label propagation is measured on every iteration.
+class AutoMapFixture {
+ public:
+  AutoMapFixture()
+      : executor_(std::thread::hardware_concurrency()),
+        in_visited_(kNumVertexes),
+        out_visited_(kNumVertexes),
+        visited_(kNumVertexes) {
+    auto edges = benchmarks::RandomEdges<vid_t>(kNumVertexes, kNumEdges);
+    graphs::CSRBuilder<gid_t, vid_t, vdata_t, edata_t> csr_builder(
+        edges.data(), kNumEdges, kNumVertexes - 1,
+        std::thread::hardware_concurrency());
+    graph_ = csr_builder.Build(0);
+    labels_.resize(graph_->get_num_vertexes());
+    for (size_t i = 0; i < labels_.size(); i++)
+      labels_[i] = graph_->globalid_by_index_[i];
+    task_runner_ = executor_.RequestTaskRunner(
+        {1, std::thread::hardware_concurrency()});
+  }
+
+  ~AutoMapFixture() {
+    executor_.RecycleTaskRunner(task_runner_);
+    executor_.Stop();
+    delete graph_;
+  }
+
+  void Reset() {
+    memcpy(graph_->vdata_, labels_.data(), sizeof(vdata_t) * labels_.size());
+    in_visited_.fill();
+    visited_.clear();
+    si_ = StatisticInfo();
+  }
+
+  executors::ScheduledExecutor executor_;
+  executors::TaskRunner* task_runner_ = nullptr;
+  CSR_T* graph_ = nullptr;
+  std::vector<vdata_t> labels_;
+  Bitmap in_visited_;
+  Bitmap out_visited_;
+  Bitmap visited_;
+  StatisticInfo si_;
+  MinLabelAutoMap auto_map_;
+};
+
+// Built once and shared by all benchmarks.
+AutoMapFixture& GetFixture() {
+  static auto fixture = new AutoMapFixture;
+  return *fixture;
+}
+
+BENCHMARK(ActiveEMap, iters) {
+  folly::BenchmarkSuspender suspender;
+  auto& fixture = GetFixture();
+  for (size_t i = 0; i < iters; i++) {
+    fixture.Reset();
+    suspender.dismiss();
+    fixture.auto_map_.ActiveEMap(&fixture.in_visited_, &fixture.out_visited_,
+                                 *fixture.graph_, fixture.task_runner_,
+                                 nullptr, &fixture.visited_, &fixture.si_);
+    suspender.rehire();
+  }
+}
+
+BENCHMARK(ActiveVMap, iters) {
+  folly::BenchmarkSuspender suspender;
+  auto& fixture = GetFixture();
+  for (size_t i = 0; i < iters; i++) {
+    fixture.Reset();
+    suspender.dismiss();
+    fixture.auto_map_.ActiveVMap(&fixture.in_visited_, &fixture.out_visited_,
+                                 *fixture.graph_, fixture.task_runner_,
+                                 nullptr, &fixture.visited_);
+    suspender.rehire();
+  }
+}
+
+}  // namespace minigraph
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  gflags::ShutDownCommandLineFlags();
+}
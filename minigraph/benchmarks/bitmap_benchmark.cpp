@@ -0,0 +1,111 @@
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <thread>
+#include <vector>
+
+#include "utility/atomic.h"
+#include "utility/bitmap.h"
+
+namespace minigraph {
+
+constexpr size_t kNumBits = 1 << 24;
+// Multiplicative hashing scatters accesses over the whole bitmap.
+constexpr size_t kScatter = 2654435761;
+
+BENCHMARK(BitmapSetBit, iters) {
+  folly::BenchmarkSuspender suspender;
+  Bitmap bitmap(kNumBits);
+  bitmap.clear();
+  suspender.dismiss();
+  for (size_t i = 0; i < iters; i++) bitmap.set_bit(i * kScatter % kNumBits);
+}
+
+BENCHMARK(BitmapGetBit, iters) {
+  folly::BenchmarkSuspender suspender;
+  Bitmap bitmap(kNumBits);
+  bitmap.clear();
+  for (size_t i = 0; i < kNumBits; i += 2) bitmap.set_bit(i);
+  suspender.dismiss();
+  size_t count = 0;
+  for (size_t i = 0; i < iters; i++)
+    count += bitmap.get_bit(i * kScatter % kNumBits) != 0;
+  folly::doNotOptimizeAway(count);
+}
+
+BENCHMARK(BitmapClear, iters) {
+  folly::BenchmarkSuspender suspender;
+  Bitmap bitmap(kNumBits);
+  suspender.dismiss();
+  for (size_t i = 0; i < iters; i++) bitmap.clear();
+}
+
+BENCHMARK(BitmapFill, iters) {
+  folly::BenchmarkSuspender suspender;
+  Bitmap bitmap(kNumBits);
+  suspender.dismiss();
+  for (size_t i = 0; i < iters; i++) bitmap.fill();
+}
+
+BENCHMARK(BitmapGetNumBit, iters) {
+  folly::BenchmarkSuspender suspender;
+  Bitmap bitmap(kNumBits);
+  bitmap.fill();
+  suspender.dismiss();
+  size_t count = 0;
+  for (size_t i = 0; i < iters; i++) count += bitmap.get_num_bit();
+  folly::doNotOptimizeAway(count);
+}
+
+BENCHMARK_DRAW_LINE();
+
+// iters updates split over num_threads threads, either all on one shared
+// word or each on its own cache line.
+template <typename F>
+void RunContended(const size_t iters, const size_t num_threads,
+                  const bool shared, F&& f) {
+  folly::BenchmarkSuspender suspender;
+  std::vector<unsigned long> words(num_threads * 8, -1ul);
+  std::vector<std::thread> threads;
+  suspender.dismiss();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      unsigned long* word = words.data() + (shared ? 0 : tid * 8);
+      for (size_t i = tid; i < iters; i += num_threads) f(word, i);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  suspender.rehire();
+  folly::doNotOptimizeAway(words);
+}
+
+void WriteMin(size_t iters, size_t num_threads, bool shared) {
+  // Decreasing values, so that most calls write.
+  RunContended(iters, num_threads, shared, [](unsigned long* word, size_t i) {
+    write_min(word, -1ul - i);
+  });
+}
+
+void WriteAdd(size_t iters, size_t num_threads, bool shared) {
+  RunContended(iters, num_threads, shared,
+               [](unsigned long* word, size_t i) { write_add(word, 1ul); });
+}
+
+BENCHMARK_NAMED_PARAM(WriteMin, 1_thread, 1, true)
+BENCHMARK_NAMED_PARAM(WriteMin, 4_threads_shared, 4, true)
+BENCHMARK_NAMED_PARAM(WriteMin, 4_threads_private, 4, false)
+BENCHMARK_NAMED_PARAM(WriteMin, 16_threads_shared, 16, true)
+BENCHMARK_NAMED_PARAM(WriteMin, 16_threads_private, 16, false)
+BENCHMARK_NAMED_PARAM(WriteAdd, 1_thread, 1, true)
+BENCHMARK_NAMED_PARAM(WriteAdd, 4_threads_shared, 4, true)
+BENCHMARK_NAMED_PARAM(WriteAdd, 4_threads_private, 4, false)
+BENCHMARK_NAMED_PARAM(WriteAdd, 16_threads_shared, 16, true)
+BENCHMARK_NAMED_PARAM(WriteAdd, 16_threads_private, 16, false)
+
+}  // namespace minigraph
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  gflags::ShutDownCommandLineFlags();
+}
@@ -0,0 +1,104 @@
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "benchmarks/random_graph.h"
+#include "graphs/edgelist.h"
+#include "graphs/immutable_csr.h"
+#include "portability/sys_types.h"
+#include "utility/io/csr_io_adapter.h"
+
+namespace minigraph {
+
+using CSR_T = graphs::ImmutableCSR<gid_t, vid_t, vdata_t, edata_t>;
+using EDGE_LIST_T = graphs::EdgeList<gid_t, vid_t, vdata_t, edata_t>;
+using CSR_IO_ADAPTER_T = utility::io::CSRIOAdapter<gid_t, vid_t, vdata_t,
+                                                   edata_t>;
+
+constexpr size_t kNumVertexes = 1 << 18;
+constexpr size_t kNumEdges = 1 << 22;
+
+EDGE_LIST_T* NewEdgeList() {
+  auto edges = benchmarks::RandomEdges<vid_t>(kNumVertexes, kNumEdges);
+  return new EDGE_LIST_T(0, kNumEdges, 0, kNumVertexes - 1, edges.data());
+}
+
+std::string GetPt(const std::string& name) {
+  return (std::filesystem::temp_directory_path() /
+          ("minigraph_io_benchmark_" + name + ".bin"))
+      .string();
+}
+
+void EdgeList2CSR(size_t iters, size_t cores) {
+  folly::BenchmarkSuspender suspender;
+  auto edgelist_graph = NewEdgeList();
+  CSR_IO_ADAPTER_T csr_io_adapter;
+  for (size_t i = 0; i < iters; i++) {
+    suspender.dismiss();
+    auto csr_graph = csr_io_adapter.EdgeList2CSR(0, edgelist_graph, cores);
+    suspender.rehire();
+    delete csr_graph;
+  }
+  delete edgelist_graph;
+}
+
+BENCHMARK_PARAM(EdgeList2CSR, 1)
+BENCHMARK_PARAM(EdgeList2CSR, 4)
+BENCHMARK_PARAM(EdgeList2CSR, 16)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(CSRIOAdapterWrite, iters) {
+  folly::BenchmarkSuspender suspender;
+  auto edgelist_graph = NewEdgeList();
+  CSR_IO_ADAPTER_T csr_io_adapter;
+  auto csr_graph = csr_io_adapter.EdgeList2CSR(0, edgelist_graph, 4);
+  delete edgelist_graph;
+  suspender.dismiss();
+  for (size_t i = 0; i < iters; i++)
+    csr_io_adapter.Write(*csr_graph, csr_bin, false, GetPt("meta"),
+                         GetPt("data"), GetPt("vdata"));
+  suspender.rehire();
+  delete csr_graph;
+}
+
+BENCHMARK(CSRIOAdapterWriteVdata, iters) {
+  folly::BenchmarkSuspender suspender;
+  auto edgelist_graph = NewEdgeList();
+  CSR_IO_ADAPTER_T csr_io_adapter;
+  auto csr_graph = csr_io_adapter.EdgeList2CSR(0, edgelist_graph, 4);
+  delete edgelist_graph;
+  suspender.dismiss();
+  for (size_t i = 0; i < iters; i++)
+    csr_io_adapter.Write(*csr_graph, csr_bin, true, GetPt("meta"),
+                         GetPt("data"), GetPt("vdata"));
+  suspender.rehire();
+  delete csr_graph;
+}
+
+// Reads the files written by CSRIOAdapterWrite, from the page cache.
+BENCHMARK(CSRIOAdapterRead, iters) {
+  folly::BenchmarkSuspender suspender;
+  CSR_IO_ADAPTER_T csr_io_adapter;
+  for (size_t i = 0; i < iters; i++) {
+    auto csr_graph = new CSR_T;
+    suspender.dismiss();
+    csr_io_adapter.Read(csr_graph, csr_bin, 0, GetPt("meta"), GetPt("data"),
+                        GetPt("vdata"));
+    suspender.rehire();
+    delete csr_graph;
+  }
+  for (auto name : {"meta", "data", "vdata"}) remove(GetPt(name).c_str());
+}
+
+}  // namespace minigraph
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  gflags::ShutDownCommandLineFlags();
+}
@@ -0,0 +1,25 @@
+#ifndef MINIGRAPH_BENCHMARKS_RANDOM_GRAPH_H
+#define MINIGRAPH_BENCHMARKS_RANDOM_GRAPH_H
+
+#include <random>
+#include <vector>
+
+namespace minigraph {
+namespace benchmarks {
+
+// Interleaved <src, dst> edges of a uniform random graph, the same on every
+// run.
+template <typename VID_T>
+std::vector<VID_T> RandomEdges(const size_t num_vertexes,
+                               const size_t num_edges) {
+  std::mt19937_64 engine(0);
+  std::uniform_int_distribution<size_t> vid(0, num_vertexes - 1);
+  std::vector<VID_T> edges(num_edges * 2);
+  for (auto& v : edges) v = vid(engine);
+  return edges;
+}
+
+}  // namespace benchmarks
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_BENCHMARKS_RANDOM_GRAPH_H
@@ -0,0 +1,54 @@
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <thread>
+#include <vector>
+
+#include "executors/scheduled_executor.h"
+#include "executors/task_runner.h"
+
+namespace minigraph {
+namespace executors {
+
+// Overhead of dispatching batches of batch_size empty tasks through a
+// Throttle, per task.
+void ThrottleRun(size_t iters, size_t batch_size,
+                 ScheduledExecutor::Backend backend) {
+  folly::BenchmarkSuspender suspender;
+  unsigned parallelism = std::thread::hardware_concurrency();
+  ScheduledExecutor executor(parallelism, backend);
+  auto task_runner = executor.RequestTaskRunner({1, parallelism});
+  std::vector<Task> tasks(batch_size, [] {});
+  size_t num_batches = (iters + batch_size - 1) / batch_size;
+  suspender.dismiss();
+  for (size_t i = 0; i < num_batches; i++) task_runner->Run(tasks, false);
+  suspender.rehire();
+  executor.RecycleTaskRunner(task_runner);
+  executor.Stop();
+}
+
+void ThrottleRunThreadPool(size_t iters, size_t batch_size) {
+  ThrottleRun(iters, batch_size, ScheduledExecutor::Backend::kThreadPool);
+}
+
+void ThrottleRunWorkStealing(size_t iters, size_t batch_size) {
+  ThrottleRun(iters, batch_size, ScheduledExecutor::Backend::kWorkStealing);
+}
+
+BENCHMARK_PARAM(ThrottleRunThreadPool, 1)
+BENCHMARK_RELATIVE_PARAM(ThrottleRunWorkStealing, 1)
+BENCHMARK_PARAM(ThrottleRunThreadPool, 16)
+BENCHMARK_RELATIVE_PARAM(ThrottleRunWorkStealing, 16)
+BENCHMARK_PARAM(ThrottleRunThreadPool, 256)
+BENCHMARK_RELATIVE_PARAM(ThrottleRunWorkStealing, 256)
+BENCHMARK_PARAM(ThrottleRunThreadPool, 4096)
+BENCHMARK_RELATIVE_PARAM(ThrottleRunWorkStealing, 4096)
+
+}  // namespace executors
+}  // namespace minigraph
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  gflags::ShutDownCommandLineFlags();
+}
@@ -2,6 +2,7 @@
 #ifndef MINIGRAPH_COMPONENT_BASE_H
 #define MINIGRAPH_COMPONENT_BASE_H
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 
@@ -72,6 +73,16 @@ class ComponentBase {
     return gid;
   }
 
+  // Largest superstep any fragment has reached.
+  size_t get_max_superstep() {
+    this->super_step_by_gid_mtx_->lock();
+    size_t step = 0;
+    for (auto& iter : *superstep_by_gid_)
+      step = std::max(step, iter.second->load());
+    this->super_step_by_gid_mtx_->unlock();
+    return step;
+  }
+
   size_t get_global_superstep() {
     global_superstep_mtx_->lock();
     auto global_superstep = global_superstep_->load(std::memory_order_acquire);
@@ -1,23 +1,35 @@
 #ifndef MINIGRAPH_COMPUTING_COMPONENT_H
 #define MINIGRAPH_COMPUTING_COMPONENT_H
 
-#include <condition_variable>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
-#include <folly/ProducerConsumerQueue.h>
-
+#include "2d_pie/auto_app_base.h"
 #include "components/component_base.h"
 #include "executors/scheduled_executor.h"
 #include "executors/scheduler.h"
 #include "executors/task_runner.h"
 #include "graphs/immutable_csr.h"
+#include "portability/sys_data_structure.h"
 #include "utility/io/data_mngr.h"
+#include "utility/metrics.h"
+#include "utility/numa.h"
 #include "utility/thread_pool.h"
+#include "utility/tracer.h"
 
 namespace minigraph {
 namespace components {
 
 static const auto kTotalParallelism = std::thread::hardware_concurrency();
+// How often threads move between fragments evaluated at the same time.
+static const auto kRebalanceInterval = std::chrono::milliseconds(1);
+// Superstep lag beyond which a fragment gets no higher priority.
+static const size_t kMaxSuperstepLag = 3;
 
 template <typename GRAPH_T, typename AUTOAPP_T>
 class ComputingComponent : public ComponentBase<typename GRAPH_T::gid_t> {
@@ -37,26 +49,27 @@ class ComputingComponent : public ComponentBase<typename GRAPH_T::gid_t> {
       std::unordered_map<GID_T, std::atomic<size_t>*>* superstep_by_gid,
       std::atomic<size_t>* global_superstep,
       utility::StateMachine<GID_T>* state_machine,
-      folly::ProducerConsumerQueue<GID_T>* task_queue,
-      std::queue<GID_T>* partial_result_queue,
       utility::io::DataMngr<GRAPH_T>* data_mngr,
       AppWrapper<AUTOAPP_T, GRAPH_T>* app_wrapper,
-      std::unique_lock<std::mutex>* task_queue_lck,
-      std::condition_variable* task_queue_cv,
-      std::condition_variable* partial_result_cv)
+      std::function<void(GID_T)> discharge)
       : ComponentBase<GID_T>(thread_pool, superstep_by_gid, global_superstep,
                              state_machine) {
     num_workers_ = num_workers;
     num_cores_ = num_cores;
     data_mngr_ = data_mngr;
-    task_queue_ = task_queue;
-    partial_result_queue_ = partial_result_queue;
     app_wrapper_ = app_wrapper;
-    task_queue_lck_ = task_queue_lck;
-    task_queue_cv_ = task_queue_cv;
-    partial_result_cv_ = partial_result_cv;
-    scheduled_executor_ =
-        std::make_unique<executors::ScheduledExecutor>(kTotalParallelism);
+    discharge_ = std::move(discharge);
+    // One executor per NUMA node, whose threads are pinned to the node, so
+    // that fragments are computed where DataMngr placed them.
+    const size_t num_nodes = utility::NumNUMANodes();
+    for (size_t node = 0; node < num_nodes; node++) {
+      scheduled_executors_.push_back(
+          std::make_unique<executors::ScheduledExecutor>(
+              std::max(kTotalParallelism / num_nodes, (size_t)1),
+              executors::ScheduledExecutor::Backend::kWorkStealing,
+              num_nodes > 1 ? (int)node : -1));
+      scheduled_executors_.back()->EnableRebalance(kRebalanceInterval);
+    }
     p_ = (size_t*)malloc(sizeof(size_t) * superstep_by_gid->size());
     for (size_t i = 0; i < superstep_by_gid->size(); i++)
       p_[i] = (size_t)num_cores / num_workers;
@@ -67,55 +80,110 @@ class ComputingComponent : public ComponentBase<typename GRAPH_T::gid_t> {
 
   ~ComputingComponent() = default;
 
-  void Run() override {
-    LOG_INFO("Run CC");
-    folly::NativeSemaphore sem(num_workers_);
-    std::queue<GID_T> que_gid;
-    while (this->switch_) {
-      std::vector<GID_T> vec_gid;
-      GID_T gid = MINIGRAPH_GID_MAX;
-      task_queue_cv_->wait(*task_queue_lck_, [&] {
-        return !task_queue_->isEmpty() || !this->switch_;
-      });
-      if (!this->switch_) return;
-      while (!task_queue_->read(gid))
-        ;
-      vec_gid.push_back(gid);
-      que_gid.push(gid);
-      while (!que_gid.empty()) {
-        gid = que_gid.front();
-        que_gid.pop();
-        // sem.try_wait();
-        auto task = std::bind(
-            &components::ComputingComponent<GRAPH_T, AUTOAPP_T>::ProcessGraph,
-            this, gid, sem);
-        this->thread_pool_->Commit(task);
-      }
-    }
+  // CC has no loop of its own: LC submits fragments as soon as they are
+  // read, and each one is evaluated by a task of the thread pool.
+  void Run() override { LOG_INFO("Run CC"); }
+
+  void Submit(const GID_T gid) {
+    if (!this->switch_) return;
+    utility::Metrics::Get().Set("minigraph_task_queue_depth",
+                                num_submitted_.fetch_add(1) + 1);
+    this->thread_pool_->Commit([this, gid]() { ProcessGraph(gid); });
   }
 
   void Stop() override { this->switch_ = false; }
 
+  // Write one csv line per PEval / IncEval run so far, for
+  // graph_repartition to find hot and cold fragments.
+  bool WriteSuperstepInfo(const std::string& pt) {
+    std::ofstream fout(pt);
+    if (!fout) {
+      XLOG(ERR, "Write file fault: ", pt);
+      return false;
+    }
+    std::lock_guard<std::mutex> lck(superstep_info_mtx_);
+    fout << "gid,superstep,inc_type,changed,elapsed_time" << std::endl;
+    for (auto& info : superstep_info_)
+      fout << info.gid << "," << info.superstep << "," << info.inc_type << ","
+           << info.changed << "," << info.elapsed_time << std::endl;
+    return true;
+  }
+
+  // Time in seconds spent in PEval (inc_type = 0) or IncEval (inc_type = 1),
+  // summed over fragments.
+  double GetEvalTime(const size_t inc_type) {
+    std::lock_guard<std::mutex> lck(superstep_info_mtx_);
+    double elapsed_time = 0;
+    for (auto& info : superstep_info_)
+      if (info.inc_type == inc_type) elapsed_time += info.elapsed_time;
+    return elapsed_time;
+  }
+
  private:
-  void ProcessGraph(const GID_T& gid, folly::NativeSemaphore& sem) {
+  void ProcessGraph(const GID_T gid) {
     LOG_INFO("ProcessGraph", gid);
+    utility::Tracer::Get().Dequeue(utility::Tracer::kComputeWait, gid);
+    utility::Metrics::Get().Set("minigraph_task_queue_depth",
+                                num_submitted_.fetch_sub(1) - 1);
     GRAPH_T* graph = (GRAPH_T*)data_mngr_->GetGraph(gid);
-    executors::TaskRunner* task_runner =
-        scheduled_executor_->RequestTaskRunner({1, (unsigned)p_[gid]});
-    if (this->get_superstep_via_gid(gid) == 0) {
+    // Edges expected to be visited: all of them by PEval, those of the
+    // vertexes active in the last evaluation by IncEval. Fragments with more
+    // get more cores, so that a superstep is not held up by the largest.
+    StatisticInfo si = app_wrapper_->msg_mngr_->GetStatisticInfo(gid);
+    double expected_work = si.num_edges;
+    if (si.elapsed_time > 0 && si.num_vertexes > 0)
+      expected_work *= (double)si.num_active_vertexes / si.num_vertexes;
+    SuperstepInfo info;
+    info.gid = gid;
+    info.superstep = this->get_superstep_via_gid(gid);
+    // Fragments lagging behind the most advanced one hold the others back,
+    // hence get threads first, and a larger share of them.
+    size_t lag = this->get_max_superstep() - info.superstep;
+    unsigned priority = 1 + (unsigned)std::min(lag, kMaxSuperstepLag);
+    auto& scheduled_executor = scheduled_executors_[utility::NUMANodeOf(gid)];
+    executors::TaskRunner* task_runner = scheduled_executor->RequestTaskRunner(
+        {priority, (unsigned)p_[gid], expected_work});
+    utility::Metrics::ThreadSuperstep() = info.superstep;
+    app_wrapper_->msg_mngr_->ClearIncomingMessages(gid);
+    ThreadActiveVertexes() = 0;
+    ThreadUpdateMagnitude() = -1;
+    auto start_time = std::chrono::system_clock::now();
+    if (info.superstep == 0) {
+      utility::TraceSpan span("PEval", "CC", gid);
       app_wrapper_->auto_app_->Init(*graph, task_runner);
       app_wrapper_->auto_app_->PEval(*graph, task_runner);
-      this->state_machine_->ProcessEvent(gid, CHANGED);
+      info.changed = true;
     } else {
-      app_wrapper_->auto_app_->IncEval(*graph, task_runner)
-          ? this->state_machine_->ProcessEvent(gid, CHANGED)
-          : this->state_machine_->ProcessEvent(gid, NOTHINGCHANGED);
+      utility::TraceSpan span("IncEval", "CC", gid);
+      info.inc_type = 1;
+      info.changed = app_wrapper_->auto_app_->IncEval(*graph, task_runner);
     }
-    scheduled_executor_->RecycleTaskRunner(task_runner);
+    info.elapsed_time = std::chrono::duration<float>(
+                            std::chrono::system_clock::now() - start_time)
+                            .count();
+    utility::Metrics::Get().Observe("minigraph_compute_seconds",
+                                    info.elapsed_time, info.inc_type);
+    // Apps not counting active vertexes through AutoMap are taken as active
+    // on all vertexes as long as they change something.
+    size_t num_active_vertexes = ThreadActiveVertexes();
+    if (num_active_vertexes == 0 && info.changed)
+      num_active_vertexes = graph->get_num_vertexes();
+    double update_magnitude = ThreadUpdateMagnitude() >= 0
+                                  ? ThreadUpdateMagnitude()
+                                  : num_active_vertexes;
+    app_wrapper_->msg_mngr_->UpdateStatisticInfo(
+        gid, num_active_vertexes, info.elapsed_time, info.superstep,
+        info.changed, update_magnitude);
+    info.changed ? this->state_machine_->ProcessEvent(gid, CHANGED)
+                 : this->state_machine_->ProcessEvent(gid, NOTHINGCHANGED);
+    {
+      std::lock_guard<std::mutex> lck(superstep_info_mtx_);
+      superstep_info_.push_back(info);
+    }
+    scheduled_executor->RecycleTaskRunner(task_runner);
     this->add_superstep_via_gid(gid);
-    partial_result_queue_->push(gid);
-    partial_result_cv_->notify_all();
-    // sem.post();
+    utility::Tracer::Get().Enqueue(utility::Tracer::kDischargeWait, gid);
+    discharge_(gid);
     return;
   }
 
@@ -124,9 +192,11 @@ class ComputingComponent : public ComponentBase<typename GRAPH_T::gid_t> {
   size_t* p_ = nullptr;
   bool switch_ = true;
 
-  // task_queue.
-  folly::ProducerConsumerQueue<GID_T>* task_queue_ = nullptr;
-  std::queue<GID_T>* partial_result_queue_ = nullptr;
+  // Fragments submitted and not being evaluated yet.
+  std::atomic<size_t> num_submitted_{0};
+
+  // Next stage: DC.
+  std::function<void(GID_T)> discharge_;
 
   // data manager.
   utility::io::DataMngr<GRAPH_T>* data_mngr_ = nullptr;
@@ -134,12 +204,14 @@ class ComputingComponent : public ComponentBase<typename GRAPH_T::gid_t> {
   // 2D-PIE app wrapper.
   APP_WARP* app_wrapper_ = nullptr;
   // cv && lck.
-  std::unique_ptr<executors::ScheduledExecutor> scheduled_executor_ = nullptr;
-  std::unique_lock<std::mutex>* task_queue_lck_;
-  std::condition_variable* partial_result_cv_ = nullptr;
-  std::condition_variable* task_queue_cv_ = nullptr;
+  std::vector<std::unique_ptr<executors::ScheduledExecutor>>
+      scheduled_executors_;
 
   std::unique_ptr<std::mutex> executor_mtx_;
+
+  // One entry per PEval / IncEval.
+  std::mutex superstep_info_mtx_;
+  std::vector<SuperstepInfo> superstep_info_;
 };
 
 }  // namespace components
@@ -1,12 +1,17 @@
 #ifndef MINIGRAPH_DISCHARGE_COMPONENT_H
 #define MINIGRAPH_DISCHARGE_COMPONENT_H
 
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "components/component_base.h"
 #include "portability/sys_data_structure.h"
 #include "utility/io/csr_io_adapter.h"
+#include "utility/metrics.h"
 #include "utility/thread_pool.h"
+#include "utility/tracer.h"
 
 namespace minigraph {
 namespace components {
@@ -29,33 +34,24 @@ class DischargeComponent : public ComponentBase<typename GRAPH_T::gid_t> {
       std::unordered_map<GID_T, std::atomic<size_t>*>* superstep_by_gid,
       std::atomic<size_t>* global_superstep,
       utility::StateMachine<GID_T>* state_machine,
-      std::queue<GID_T>* partial_result_queue,
-      folly::ProducerConsumerQueue<GID_T>* task_queue,
       std::queue<GID_T>* read_trigger,
       std::unordered_map<GID_T, Path>* pt_by_gid,
       utility::io::DataMngr<GRAPH_T>* data_mngr,
       message::DefaultMessageManager<GRAPH_T>* msg_mngr,
-      std::unique_lock<std::mutex>* partial_result_lck,
-      std::condition_variable* partial_result_cv,
-      std::condition_variable* task_queue_cv,
-      std::condition_variable* read_trigger_cv,
+      std::mutex* read_trigger_mtx, std::condition_variable* read_trigger_cv,
       std::atomic<bool>* system_switch,
       std::unique_lock<std::mutex>* system_switch_lck,
       std::condition_variable* system_switch_cv, const size_t num_iter,
       std::string mode = "Default")
       : ComponentBase<GID_T>(thread_pool, superstep_by_gid, global_superstep,
                              state_machine) {
-    task_queue_ = task_queue;
     load_sem_ = load_sem;
     num_workers_ = num_workers;
-    partial_result_queue_ = partial_result_queue;
     pt_by_gid_ = pt_by_gid;
     read_trigger_ = read_trigger;
     data_mngr_ = data_mngr;
-    task_queue_cv_ = task_queue_cv;
-    partial_result_lck_ = partial_result_lck;
+    read_trigger_mtx_ = read_trigger_mtx;
     read_trigger_cv_ = read_trigger_cv;
-    partial_result_cv_ = partial_result_cv;
     system_switch_ = system_switch;
     system_switch_lck_ = system_switch_lck;
     system_switch_cv_ = system_switch_cv;
@@ -68,65 +64,124 @@ class DischargeComponent : public ComponentBase<typename GRAPH_T::gid_t> {
 
   ~DischargeComponent() = default;
 
-  void Run() override {
-    LOG_INFO("Run DC");
-    std::queue<GID_T> que_gid;
-    folly::NativeSemaphore sem(num_workers_);
-    while (this->switch_.load()) {
-      GID_T gid = MINIGRAPH_GID_MAX;
-      partial_result_cv_->wait(*partial_result_lck_, [&] { return true; });
-      while (!partial_result_queue_->empty()) {
-        gid = partial_result_queue_->front();
-        partial_result_queue_->pop();
-        que_gid.push(gid);
-      }
+  // DC has no loop of its own: fragments evaluated by CC, or short cut by
+  // LC, reach Process() through a Stage, one at a time.
+  void Run() override { LOG_INFO("Run DC"); }
 
-      while (!que_gid.empty()) {
-        gid = que_gid.front();
-        que_gid.pop();
-        if (mode_ != "NoShort") CheckRTRule(gid);
-
-        ReleaseGraphX(gid);
-        LOG_INFO("post: ", gid);
-        load_sem_->post();
-        if (this->TrySync()) {
-          LOG_INFO("Sync");
-          this->state_machine_->ShowAllState();
-          LOG_INFO("step: ", this->get_global_superstep(), " ", num_iter_);
-          if (this->state_machine_->IsTerminated() ||
-              this->get_global_superstep() > num_iter_) {
-            system_switch_cv_->wait(*system_switch_lck_,
-                                    [&] { return system_switch_->load(); });
-            system_switch_->store(false);
-            system_switch_cv_->notify_all();
-            LOG_INFO("DC exit");
-            return;
-          } else {
-            CallNextIteration(gid);
-          }
-        }
+  void Process(const GID_T gid) {
+    if (!this->switch_.load()) return;
+    utility::Tracer::Get().Dequeue(utility::Tracer::kDischargeWait, gid);
+    if (mode_ != "NoShort") CheckRTRule(gid);
+
+    ReleaseGraphX(gid);
+    if (mode_ == "Async") {
+      bool quiescent = TriggerPending(gid);
+      load_sem_->post();
+      if (quiescent) {
+        LOG_INFO("Quiescent, step: ", this->get_global_superstep());
+        Exit();
+      }
+      return;
+    }
+    LOG_INFO("post: ", gid);
+    load_sem_->post();
+    if (this->TrySync()) {
+      LOG_INFO("Sync");
+      this->state_machine_->ShowAllState();
+      LOG_INFO("step: ", this->get_global_superstep(), " ", num_iter_);
+      if (this->state_machine_->IsTerminated() ||
+          this->get_global_superstep() > num_iter_) {
+        Exit();
+      } else {
+        CallNextIteration(gid);
       }
     }
-    return;
   }
 
   void Stop() override { this->switch_.store(false); }
 
  private:
   void ReleaseGraphX(const GID_T gid, bool terminate = false) {
+    auto start_time = std::chrono::system_clock::now();
     if (IsSameType<GRAPH_T, CSR_T>()) {
       if (this->state_machine_->GraphIs(gid, RTS)) {
         Path& path = pt_by_gid_->find(gid)->second;
-        data_mngr_->WriteGraph(gid, path, csr_bin, true);
-        data_mngr_->EraseGraph(gid);
+        WriteGraph(gid, path);
+        EraseGraph(gid);
       } else if (this->state_machine_->GraphIs(gid, RT)) {
-        data_mngr_->EraseGraph(gid);
+        EraseGraph(gid);
       } else if (this->state_machine_->GraphIs(gid, RC)) {
         Path& path = pt_by_gid_->find(gid)->second;
-        data_mngr_->WriteGraph(gid, path, csr_bin, true);
-        data_mngr_->EraseGraph(gid);
+        WriteGraph(gid, path);
+        EraseGraph(gid);
       }
     }
+    utility::Metrics::Get().Observe(
+        "minigraph_discharge_seconds",
+        std::chrono::duration<double>(std::chrono::system_clock::now() -
+                                      start_time)
+            .count());
+  }
+
+  void WriteGraph(const GID_T gid, const Path& path) {
+    utility::TraceSpan span("Write", "DC", gid);
+    data_mngr_->WriteGraph(gid, path, csr_bin, true);
+  }
+
+  void EraseGraph(const GID_T gid) {
+    utility::TraceSpan span("Erase", "DC", gid);
+    data_mngr_->EraseGraph(gid);
+  }
+
+  void Exit() {
+    // Fragments still in flight are no longer processed.
+    this->switch_.store(false);
+    system_switch_cv_->wait(*system_switch_lck_,
+                            [&] { return system_switch_->load(); });
+    system_switch_->store(false);
+    system_switch_cv_->notify_all();
+    LOG_INFO("DC exit");
+  }
+
+  // Async mode replaces supersteps: once released, gid goes back to Idle,
+  // and every fragment not in flight that received messages since its last
+  // evaluation started, gid included, is triggered right away. The run ends
+  // on quiescence, when no fragment is in flight, hence no message pending.
+  // Fragments past num_iter_ evaluations are no longer triggered.
+  bool TriggerPending(const GID_T gid) {
+    size_t num_graphs = pt_by_gid_->size();
+    if (in_flight_.empty()) {
+      // All fragments are triggered at start.
+      in_flight_.assign(num_graphs, true);
+      num_in_flight_ = num_graphs;
+    }
+    // gid is still Idle if LC failed to read it, in which case it is not
+    // triggered again on its own messages.
+    bool evaluated = !this->state_machine_->GraphIs(gid, IDLE);
+    this->state_machine_->EvokeX(gid, this->state_machine_->GetState(gid));
+    in_flight_[gid] = false;
+    num_in_flight_--;
+
+    bool triggered = false;
+    {
+      std::lock_guard<std::mutex> grd(*read_trigger_mtx_);
+      for (GID_T y = 0; y < num_graphs; y++) {
+        if (in_flight_[y] || !msg_mngr_->HasIncomingMessages(y)) continue;
+        if (this->get_superstep_via_gid(y) > num_iter_) continue;
+        if (y == gid && !evaluated) continue;
+        in_flight_[y] = true;
+        num_in_flight_++;
+        read_trigger_->push(y);
+        triggered = true;
+      }
+    }
+    if (triggered) read_trigger_cv_->notify_all();
+
+    // Report the number of evaluations of the busiest fragment as supersteps.
+    size_t superstep = this->get_superstep_via_gid(gid);
+    while (this->get_global_superstep() < superstep)
+      this->add_global_superstep();
+    return num_in_flight_ == 0;
   }
 
   void CallNextIteration(const GID_T current_gid) {
@@ -139,6 +194,7 @@ class DischargeComponent : public ComponentBase<typename GRAPH_T::gid_t> {
     auto out_rc_ = this->state_machine_->GetAllinStateX(RC);
     auto out_rt_ = this->state_machine_->GetAllinStateX(RT);
     auto out_rts_ = this->state_machine_->GetAllinStateX(RTS);
+    std::lock_guard<std::mutex> grd(*read_trigger_mtx_);
     for (auto& iter : out_rc_) {
       this->state_machine_->EvokeX(iter, RC);
       GID_T gid = iter;
@@ -178,7 +234,6 @@ class DischargeComponent : public ComponentBase<typename GRAPH_T::gid_t> {
   folly::NativeSemaphore* load_sem_ = nullptr;
 
   std::atomic<bool> switch_ = true;
-  std::queue<GID_T>* partial_result_queue_ = nullptr;
   std::queue<GID_T>* read_trigger_ = nullptr;
 
   utility::io::DataMngr<GRAPH_T>* data_mngr_ = nullptr;
@@ -186,11 +241,8 @@ class DischargeComponent : public ComponentBase<typename GRAPH_T::gid_t> {
 
   std::unordered_map<GID_T, Path>* pt_by_gid_ = nullptr;
 
-  std::unique_lock<std::mutex>* partial_result_lck_ = nullptr;
-  folly::ProducerConsumerQueue<GID_T>* task_queue_ = nullptr;
+  std::mutex* read_trigger_mtx_ = nullptr;
   std::condition_variable* read_trigger_cv_ = nullptr;
-  std::condition_variable* task_queue_cv_ = nullptr;
-  std::condition_variable* partial_result_cv_ = nullptr;
   std::unique_lock<std::mutex>* system_switch_lck_ = nullptr;
   std::condition_variable* system_switch_cv_ = nullptr;
 
@@ -201,6 +253,10 @@ class DischargeComponent : public ComponentBase<typename GRAPH_T::gid_t> {
   bool* communication_matrix_;
 
   size_t num_iter_ = 0;
+
+  // Async mode: whether each fragment is triggered and not yet released.
+  std::vector<bool> in_flight_;
+  size_t num_in_flight_ = 0;
 };
 
 }  // namespace components
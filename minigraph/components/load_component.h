@@ -6,16 +6,24 @@
 #include "scheduler/fifo_scheduler.h"
 #include "scheduler/hash_scheduler.h"
 #include "scheduler/large_first_scheduler.h"
+#include "scheduler/learned_scheduler.h"
+#include "scheduler/locality_scheduler.h"
+#include "scheduler/priority_scheduler.h"
 #include "scheduler/small_first_scheduler.h"
 #include "scheduler/subgraph_scheduler_base.h"
 #include "utility/io/csr_io_adapter.h"
 #include "utility/io/data_mngr.h"
+#include "utility/metrics.h"
 #include "utility/state_machine.h"
 #include "utility/thread_pool.h"
-#include <folly/ProducerConsumerQueue.h>
+#include "utility/tracer.h"
 #include <folly/synchronization/NativeSemaphore.h>
+#include <chrono>
 #include <condition_variable>
+#include <fstream>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 
@@ -42,16 +50,13 @@ class LoadComponent : public ComponentBase<typename GRAPH_T::gid_t> {
       std::atomic<size_t>* global_superstep,
       utility::StateMachine<GID_T>* state_machine,
       std::queue<GID_T>* read_trigger,
-      folly::ProducerConsumerQueue<GID_T>* task_queue,
-      std::queue<GID_T>* partial_result_queue,
       std::unordered_map<GID_T, Path>* pt_by_gid,
       utility::io::DataMngr<GRAPH_T>* data_mngr,
       message::DefaultMessageManager<GRAPH_T>* msg_mngr,
-      std::unique_lock<std::mutex>* read_trigger_lck,
-      std::condition_variable* read_trigger_cv,
-      std::condition_variable* task_queue_cv,
-      std::condition_variable* partial_result_cv, std::string mode = "Default",
-      std::string scheduler = "FIFO")
+      std::mutex* read_trigger_mtx, std::condition_variable* read_trigger_cv,
+      std::function<void(GID_T)> compute,
+      std::function<void(GID_T)> discharge, std::string mode = "Default",
+      std::string scheduler = "FIFO", const std::string cost_model_pt = "")
       : ComponentBase<GID_T>(thread_pool, superstep_by_gid, global_superstep,
                              state_machine) {
     load_sem_ = load_sem;
@@ -59,13 +64,11 @@ class LoadComponent : public ComponentBase<typename GRAPH_T::gid_t> {
     pt_by_gid_ = pt_by_gid;
     data_mngr_ = data_mngr;
     msg_mngr_ = msg_mngr;
-    task_queue_ = task_queue;
-    partial_result_queue_ = partial_result_queue;
     read_trigger_ = read_trigger;
-    read_trigger_lck_ = read_trigger_lck;
+    read_trigger_mtx_ = read_trigger_mtx;
     read_trigger_cv_ = read_trigger_cv;
-    task_queue_cv_ = task_queue_cv;
-    partial_result_cv_ = partial_result_cv;
+    compute_ = std::move(compute);
+    discharge_ = std::move(discharge);
     mode_ = mode;
 
     if (scheduler == "FIFO") {
@@ -78,6 +81,20 @@ class LoadComponent : public ComponentBase<typename GRAPH_T::gid_t> {
     } else if (scheduler == "small_first") {
       scheduler_ = new scheduler::SmallFirstScheduler<GID_T>(
           msg_mngr_->GetStatisticInfo());
+    } else if (scheduler == "locality") {
+      scheduler_ = new scheduler::LocalityScheduler<GID_T>(
+          msg_mngr_->GetCommunicationMatrix(), pt_by_gid_->size());
+    } else if (scheduler == "priority") {
+      scheduler_ = new scheduler::PriorityScheduler<GID_T>(
+          msg_mngr_->GetStatisticInfo());
+    } else if (scheduler == "learned") {
+      utility::CostModel cost_model;
+      if (!std::ifstream(cost_model_pt).good() ||
+          !cost_model.Load(cost_model_pt))
+        LOG_INFO("No cost model at ", cost_model_pt,
+                 ", fall back to the default one.");
+      scheduler_ = new scheduler::LearnedScheduler<GID_T>(
+          msg_mngr_->GetStatisticInfo(), cost_model);
     } else {
       scheduler_ = new scheduler::FIFOScheduler<GID_T>();
     }
@@ -89,22 +106,39 @@ class LoadComponent : public ComponentBase<typename GRAPH_T::gid_t> {
     folly::NativeSemaphore sem(buffer_size_);
     while (switch_) {
       GID_T gid = MINIGRAPH_GID_MAX;
-      read_trigger_cv_->wait(*read_trigger_lck_, [&] {
-        return !read_trigger_->empty() || !switch_;
-      });
-      if (!switch_) return;
-
-      std::queue<GID_T> que_gid;
       std::vector<GID_T> vec_gid;
-      while (!read_trigger_->empty()) {
-        gid = read_trigger_->front();
-        que_gid.push(gid);
-        vec_gid.push_back(gid);
-        read_trigger_->pop();
+      {
+        // DC pushes to read_trigger_ from its own threads.
+        std::unique_lock<std::mutex> lck(*read_trigger_mtx_);
+        read_trigger_cv_->wait(
+            lck, [&] { return !read_trigger_->empty() || !switch_; });
+        if (!switch_) return;
+        while (!read_trigger_->empty()) {
+          vec_gid.push_back(read_trigger_->front());
+          read_trigger_->pop();
+        }
       }
       while (!vec_gid.empty()) {
-        gid = scheduler_->ChooseOne(vec_gid);
-        load_sem_->wait();
+        if (mode_ == "Async") {
+          // Wait first, so that the choice also covers the fragments
+          // triggered meanwhile, with their latest priorities.
+          {
+            utility::TraceSpan span("WaitLoadSem", "LC");
+            load_sem_->wait();
+          }
+          {
+            std::lock_guard<std::mutex> grd(*read_trigger_mtx_);
+            while (!read_trigger_->empty()) {
+              vec_gid.push_back(read_trigger_->front());
+              read_trigger_->pop();
+            }
+          }
+          gid = scheduler_->ChooseOne(vec_gid);
+        } else {
+          gid = scheduler_->ChooseOne(vec_gid);
+          utility::TraceSpan span("WaitLoadSem", "LC", gid);
+          load_sem_->wait();
+        }
         // sem.try_wait();
         ProcessGraph(gid, sem, mode_);
       }
@@ -131,34 +165,47 @@ class LoadComponent : public ComponentBase<typename GRAPH_T::gid_t> {
       }
     }
 
-    if (mode_ == "NoShort") read = true;
+    if (mode_ == "NoShort" || mode_ == "Async") read = true;
     if (read) {
       Path& path = pt_by_gid_->find(gid)->second;
       auto tag = false;
-      if (typeid(GRAPH_T) == typeid(CSR_T)) {
-        tag = this->data_mngr_->ReadGraph(gid, path, csr_bin);
-      } else if (typeid(GRAPH_T) == typeid(RELATION_T)) {
-        tag = this->data_mngr_->ReadGraph(gid, path, relation_bin);
-      } else if (typeid(GRAPH_T) == typeid(EDGE_LIST_T)) {
-        tag = this->data_mngr_->ReadGraph(gid, path, edgelist_bin);
+      auto start_time = std::chrono::system_clock::now();
+      {
+        utility::TraceSpan span("Read", "LC", gid);
+        if (typeid(GRAPH_T) == typeid(CSR_T)) {
+          tag = this->data_mngr_->ReadGraph(gid, path, csr_bin);
+        } else if (typeid(GRAPH_T) == typeid(RELATION_T)) {
+          tag = this->data_mngr_->ReadGraph(gid, path, relation_bin);
+        } else if (typeid(GRAPH_T) == typeid(EDGE_LIST_T)) {
+          tag = this->data_mngr_->ReadGraph(gid, path, edgelist_bin);
+        }
       }
+      utility::Metrics::Get().Observe(
+          "minigraph_load_seconds",
+          std::chrono::duration<double>(std::chrono::system_clock::now() -
+                                        start_time)
+              .count());
       if (tag) {
         this->state_machine_->ProcessEvent(gid, LOAD);
-        while (!task_queue_->write(gid))
-          ;
-        task_queue_cv_->notify_all();
+        utility::Tracer::Get().Enqueue(utility::Tracer::kComputeWait, gid);
+        compute_(gid);
       } else {
         this->state_machine_->ProcessEvent(gid, UNLOAD);
         LOG_ERROR("Read graph fault: ", gid);
+        // Still released by DC, which gives its slot in the buffer back, and
+        // in Async mode, takes it out of the fragments in flight.
+        utility::Tracer::Get().Enqueue(utility::Tracer::kDischargeWait, gid);
+        discharge_(gid);
       }
       sem.post();
       // LOG_INFO("post", gid);
     } else {
       LOG_INFO("LC ShortCut", gid);
       this->add_superstep_via_gid(gid);
-      partial_result_queue_->push(gid);
+      utility::Tracer::Get().Enqueue(utility::Tracer::kDischargeWait, gid);
       this->state_machine_->ProcessEvent(gid, SHORTCUTREAD);
-      partial_result_cv_->notify_all();
+      utility::Metrics::Get().Add("minigraph_shortcut_reads_total", 1);
+      discharge_(gid);
     }
     LOG_INFO("finished");
     return;
@@ -168,18 +215,18 @@ class LoadComponent : public ComponentBase<typename GRAPH_T::gid_t> {
 
   std::queue<GID_T>* read_trigger_ = nullptr;
   folly::NativeSemaphore* load_sem_ = nullptr;
-  folly::ProducerConsumerQueue<GID_T>* task_queue_ = nullptr;
-  std::queue<GID_T>* partial_result_queue_ = nullptr;
   std::unordered_map<GID_T, Path>* pt_by_gid_ = nullptr;
 
   utility::io::DataMngr<GRAPH_T>* data_mngr_ = nullptr;
   message::DefaultMessageManager<GRAPH_T>* msg_mngr_ = nullptr;
 
   bool switch_ = true;
-  std::unique_lock<std::mutex>* read_trigger_lck_ = nullptr;
+  std::mutex* read_trigger_mtx_ = nullptr;
   std::condition_variable* read_trigger_cv_ = nullptr;
-  std::condition_variable* task_queue_cv_ = nullptr;
-  std::condition_variable* partial_result_cv_ = nullptr;
+
+  // Next stages: fragments read go to CC, those short cut go to DC.
+  std::function<void(GID_T)> compute_;
+  std::function<void(GID_T)> discharge_;
 
   std::string mode_ = "default";
 
@@ -0,0 +1,61 @@
+#ifndef MINIGRAPH_STAGE_H
+#define MINIGRAPH_STAGE_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <queue>
+
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace components {
+
+// A stage of the pipeline that processes the items pushed to it one at a
+// time, in order, without a thread of its own. Push() enqueues an item, and
+// if the stage is idle, commits a task to the shared thread pool that drains
+// the queue and returns. No thread is blocked while the stage has nothing
+// to do.
+template <typename T>
+class Stage {
+ public:
+  Stage(utility::EDFThreadPool* thread_pool, std::function<void(T)> process)
+      : thread_pool_(thread_pool), process_(std::move(process)) {}
+
+  void Push(const T& item) {
+    {
+      std::lock_guard<std::mutex> lck(mtx_);
+      items_.push(item);
+    }
+    // Only the push finding the stage idle starts a drain.
+    if (num_pending_.fetch_add(1) == 0)
+      thread_pool_->Commit([this]() { Drain(); });
+  }
+
+  // Items pushed and not yet processed.
+  size_t Size() const { return num_pending_.load(); }
+
+ private:
+  void Drain() {
+    do {
+      T item;
+      {
+        std::lock_guard<std::mutex> lck(mtx_);
+        item = items_.front();
+        items_.pop();
+      }
+      process_(item);
+    } while (num_pending_.fetch_sub(1) > 1);
+  }
+
+  utility::EDFThreadPool* thread_pool_ = nullptr;
+  std::function<void(T)> process_;
+
+  std::mutex mtx_;
+  std::queue<T> items_;
+  std::atomic<size_t> num_pending_{0};
+};
+
+}  // namespace components
+}  // namespace minigraph
+#endif  // MINIGRAPH_STAGE_H
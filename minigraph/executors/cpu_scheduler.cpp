@@ -1,6 +1,8 @@
 #include "executors/cpu_scheduler.h"
 
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 #include "utility/logging.h"
 
@@ -41,23 +43,18 @@ std::unique_ptr<Throttle> CPUScheduler::AllocateNew(
     const SchedulableFactory<Throttle>* factory,
     Schedulable::Metadata&& metadata, const size_t initial_parallelism) {
   std::lock_guard<std::mutex> grd(mtx_);
-  if (num_free_threads_ > initial_parallelism) {
-    std::unique_ptr<Throttle> throttle = factory->New(
-        initial_parallelism, std::forward<Schedulable::Metadata>(metadata));
-    q_.push_back(throttle.get());
-    LOG_INFO("num_free_threads", num_free_threads_);
-    num_free_threads_ -= initial_parallelism;
-    LOG_INFO("num_free_threads", num_free_threads_);
-    return throttle;
-  } else if (num_free_threads_ > 0 && num_free_threads_ < initial_parallelism) {
-    std::unique_ptr<Throttle> throttle = factory->New(
-        num_free_threads_, std::forward<Schedulable::Metadata>(metadata));
-    Throttle* t = throttle.get();
-    q_.push_back(t);
-    if (next_in_queue_ == nullptr) next_in_queue_ = t;
-    num_free_threads_ = 0;
-    return throttle;
-  }
+  // Threads short of initial_parallelism come from later recycling or
+  // rebalancing.
+  const size_t parallelism = std::min(num_free_threads_, initial_parallelism);
+  std::unique_ptr<Throttle> throttle = factory->New(
+      parallelism, std::forward<Schedulable::Metadata>(metadata));
+  Throttle* t = throttle.get();
+  q_.push_back(t);
+  if (parallelism < initial_parallelism && next_in_queue_ == nullptr)
+    next_in_queue_ = t;
+  num_free_threads_ -= parallelism;
+  LOG_INFO("num_free_threads", num_free_threads_);
+  return throttle;
 }
 
 void CPUScheduler::RecycleOneThread(Throttle* recycler) {
@@ -69,7 +66,88 @@ void CPUScheduler::RecycleAllThreads(Throttle* recycler) {
     LOG_ERROR("CPU::Scheduler::RecycleAllThread() called with nullptr.");
     return;
   }
-  RecycleNThreads(recycler, recycler->GetParallelism());
+  RecycleNThreads(recycler, std::numeric_limits<size_t>::max());
+}
+
+void CPUScheduler::Rebalance() {
+  std::lock_guard<std::mutex> grd(mtx_);
+  struct Demand {
+    // A snapshot of pending packages, which change as tasks complete.
+    size_t pending;
+    double weight;
+    Throttle* throttle;
+  };
+  std::vector<Demand> busy;
+  bool has_expected_work = true;
+  for (auto t : q_) {
+    const size_t pending = t->PendingPackages();
+    if (pending == 0) {
+      // Idle Throttles keep one thread, for their next Run() to start.
+      const size_t parallelism = t->GetParallelism();
+      if (parallelism > 1)
+        num_free_threads_ += t->TryDecrementParallelism(parallelism - 1);
+      continue;
+    }
+    busy.push_back({pending, 0, t});
+    has_expected_work &= t->metadata().expected_work > 0;
+  }
+  if (busy.empty()) return;
+
+  // Shares follow the expected work, such that Throttles started together
+  // finish together, or the pending packages if some lack an estimate.
+  double total_weight = 0;
+  for (auto& demand : busy) {
+    const auto& metadata = demand.throttle->metadata();
+    demand.weight =
+        std::max(metadata.priority, 1u) *
+        (has_expected_work ? metadata.expected_work : (double)demand.pending);
+    total_weight += demand.weight;
+  }
+  // The critical path, i.e. the most urgent and the most work, goes first.
+  std::sort(busy.begin(), busy.end(), [](const Demand& a, const Demand& b) {
+    const auto& x = a.throttle->metadata();
+    const auto& y = b.throttle->metadata();
+    if (x.priority != y.priority) return x.priority > y.priority;
+    if (x.expected_work != y.expected_work)
+      return x.expected_work > y.expected_work;
+    return a.pending > b.pending;
+  });
+
+  size_t num_threads = num_free_threads_;
+  for (auto& demand : busy) num_threads += demand.throttle->GetParallelism();
+
+  std::vector<size_t> targets(busy.size());
+  size_t num_assigned = 0;
+  for (size_t i = 0; i < busy.size(); i++) {
+    const size_t pending = busy[i].pending;
+    targets[i] = std::min(
+        (size_t)(num_threads * busy[i].weight / total_weight), pending);
+    targets[i] = std::max(
+        targets[i], std::min(busy[i].throttle->GetParallelism(), (size_t)1));
+    num_assigned += targets[i];
+  }
+  // Threads left by rounding or caps go along the critical path.
+  for (size_t i = 0; i < busy.size() && num_assigned < num_threads; i++) {
+    if (targets[i] >= busy[i].pending) continue;
+    const size_t delta =
+        std::min(num_threads - num_assigned, busy[i].pending - targets[i]);
+    targets[i] += delta;
+    num_assigned += delta;
+  }
+
+  for (size_t i = 0; i < busy.size(); i++) {
+    const size_t parallelism = busy[i].throttle->GetParallelism();
+    if (parallelism > targets[i])
+      num_free_threads_ +=
+          busy[i].throttle->TryDecrementParallelism(parallelism - targets[i]);
+  }
+  for (size_t i = 0; i < busy.size() && num_free_threads_ > 0; i++) {
+    const size_t parallelism = busy[i].throttle->GetParallelism();
+    if (parallelism >= targets[i]) continue;
+    const size_t delta = std::min(targets[i] - parallelism, num_free_threads_);
+    busy[i].throttle->IncreaseParallelism(delta);
+    num_free_threads_ -= delta;
+  }
 }
 
 void CPUScheduler::RecycleNThreads(Throttle* recycler, size_t num_threads) {
@@ -78,11 +156,14 @@ void CPUScheduler::RecycleNThreads(Throttle* recycler, size_t num_threads) {
     return;
   }
 
+  // Under the lock, so that Rebalance() does not move threads of recycler
+  // in the meantime.
+  std::lock_guard<std::mutex> grd(mtx_);
+  num_threads = std::min(num_threads, recycler->GetParallelism());
   for (size_t i = 0; i < num_threads; i++) {
     recycler->DecrementParallelism();
   }
 
-  std::lock_guard<std::mutex> grd(mtx_);
   auto it = q_.cbegin();
   while (it != q_.cend()) {
     if (*it != recycler) {
@@ -44,6 +44,18 @@ class CPUScheduler final : public Scheduler<Throttle> {
   // Throttle waiting for more threads.
   void RecycleAllThreads(Throttle* recycler) override;
 
+  // Move threads from Throttles with little work left to those with much,
+  // and hand out free threads. Each Throttle running tasks is targeted a
+  // share of all threads proportional to its priority times its expected
+  // work, or its pending packages if not all Throttles have an estimate,
+  // yet no more than its pending packages, and keeps at least one thread it
+  // already has. Threads left over go to the highest priority first, then
+  // to the most expected work, which is the critical path to the end of a
+  // superstep. Only threads no task is running on are taken back, so that
+  // the call never blocks on task completion. Meant to be called
+  // periodically.
+  void Rebalance() override;
+
  protected:
   // Remove throttle from being managed by this Scheduler. Callable from the
   // destructor of a throttle only, which is a friend function.
@@ -0,0 +1,43 @@
+#ifndef MINIGRAPH_EXECUTORS_LATCH_H_
+#define MINIGRAPH_EXECUTORS_LATCH_H_
+
+#include <folly/synchronization/Baton.h>
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace minigraph {
+namespace executors {
+
+// A single-use countdown latch.
+//
+// The count is an atomic counter, so that counting down takes no lock. Only
+// the thread bringing the count to 0 touches the Baton, which Wait() spins
+// on briefly before parking on a futex.
+class Latch {
+ public:
+  explicit Latch(size_t count) : count_(count) {
+    if (count == 0) baton_.post();
+  }
+
+  Latch(const Latch&) = delete;
+  Latch& operator=(const Latch&) = delete;
+
+  // Decrement the count by 1, and release the waiter once it reaches 0.
+  void CountDown() {
+    if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) baton_.post();
+  }
+
+  // Block until the count reaches 0.
+  void Wait() { baton_.wait(); }
+
+ private:
+  std::atomic<size_t> count_;
+  folly::Baton<> baton_;
+};
+
+}  // namespace executors
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_EXECUTORS_LATCH_H_
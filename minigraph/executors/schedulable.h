@@ -18,10 +18,13 @@ class Schedulable {
 
   // Metadata information for effective scheduling.
   struct Metadata {
+    // Throttles of higher priority get more threads, and get them first.
     unsigned priority = 1;
     unsigned parallelism = 1;
 
-    //TODO: add more fields to allow scheduler to do some strategic work.
+    // Estimated work of all tasks to be run, e.g. edges to be visited, or 0
+    // if unknown. Threads are shared in proportion to it.
+    double expected_work = 0;
   };
 
  public:
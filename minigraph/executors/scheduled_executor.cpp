@@ -28,10 +28,20 @@ void ScheduledExecutor::ThreadPool::StopAndJoin() {
   internal_pool_.join();
 }
 
-ScheduledExecutor::ScheduledExecutor(unsigned int num_threads)
+ScheduledExecutor::ScheduledExecutor(unsigned int num_threads,
+                                     Backend backend, int numa_node)
     : scheduler_(std::make_unique<CPUScheduler>(num_threads)),
-      thread_pool_(num_threads),
-      factory_(scheduler_.get(), &thread_pool_) {
+      thread_pool_(backend == Backend::kThreadPool
+                       ? std::make_unique<ThreadPool>(num_threads)
+                       : nullptr),
+      work_stealing_pool_(backend == Backend::kWorkStealing
+                              ? std::make_unique<WorkStealingPool>(
+                                    num_threads, numa_node)
+                              : nullptr),
+      factory_(scheduler_.get(),
+               thread_pool_ != nullptr
+                   ? static_cast<TaskRunner*>(thread_pool_.get())
+                   : work_stealing_pool_.get()) {
   std::lock_guard<std::mutex> grd(map_mtx_);
   throttles_.reserve(1024);
 }
@@ -75,9 +85,41 @@ void ScheduledExecutor::RecycleTaskRunner(TaskRunner* runner) {
   }
   throttles_.erase(id);
   //  throttle will destruct here, and get removed from Scheduler automatically.
+  // Hand its threads to the Throttles left.
+  scheduler_->Rebalance();
 }
 
-void ScheduledExecutor::Stop() { thread_pool_.StopAndJoin(); }
+void ScheduledExecutor::EnableRebalance(std::chrono::microseconds interval) {
+  std::lock_guard<std::mutex> grd(rebalance_mtx_);
+  if (rebalance_thread_ != nullptr) return;
+  rebalance_switch_ = true;
+  rebalance_thread_ = std::make_unique<std::thread>([this, interval]() {
+    std::unique_lock<std::mutex> lck(rebalance_mtx_);
+    while (!rebalance_cv_.wait_for(lck, interval,
+                                   [this] { return !rebalance_switch_; }))
+      scheduler_->Rebalance();
+  });
+}
+
+ScheduledExecutor::~ScheduledExecutor() { StopRebalance(); }
+
+void ScheduledExecutor::StopRebalance() {
+  {
+    std::lock_guard<std::mutex> grd(rebalance_mtx_);
+    rebalance_switch_ = false;
+  }
+  rebalance_cv_.notify_all();
+  if (rebalance_thread_ != nullptr) {
+    rebalance_thread_->join();
+    rebalance_thread_.reset();
+  }
+}
+
+void ScheduledExecutor::Stop() {
+  StopRebalance();
+  if (thread_pool_ != nullptr) thread_pool_->StopAndJoin();
+  if (work_stealing_pool_ != nullptr) work_stealing_pool_->StopAndJoin();
+}
 
 }  // namespace executors
 }  // namespace minigraph
@@ -5,8 +5,15 @@
 #include <folly/executors/EDFThreadPoolExecutor.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "executors/scheduler.h"
 #include "executors/throttle.h"
+#include "executors/work_stealing_pool.h"
 
 
 namespace minigraph {
@@ -54,11 +61,20 @@ class ScheduledExecutor {
   };
 
  public:
+  // The thread pool the Throttles hand tasks to.
+  //   kThreadPool: a folly::CPUThreadPoolExecutor, with a queue shared by all
+  //     threads.
+  //   kWorkStealing: a WorkStealingPool, with a deque per thread, for runs
+  //     that submit many small batches.
+  enum class Backend { kThreadPool, kWorkStealing };
+
   // Create a ScheduledExecutor, with `num_threads` of threads in the thread
-  // pool.
+  // pool. If `numa_node` is set, the threads of a kWorkStealing pool are
+  // pinned to that NUMA node.
   explicit ScheduledExecutor(
-      unsigned int num_threads = std::thread::hardware_concurrency());
-  virtual ~ScheduledExecutor() = default;
+      unsigned int num_threads = std::thread::hardware_concurrency(),
+      Backend backend = Backend::kThreadPool, int numa_node = -1);
+  virtual ~ScheduledExecutor();
 
   // Use the ScheduledExecutor to create a Throttle instance such that
   // the client can submit tasks via the returned TaskRunner.
@@ -72,6 +88,11 @@ class ScheduledExecutor {
   // all tasks are done with the Throttle.
   void RecycleTaskRunner(TaskRunner* runner);
 
+  // Rebalance threads among the Throttles every `interval`, until Stop(),
+  // so that threads move to those with the most pending tasks. Threads of a
+  // recycled Throttle are rebalanced right away regardless.
+  void EnableRebalance(std::chrono::microseconds interval);
+
   // Stop the Executor.
   void Stop();
 
@@ -79,9 +100,13 @@ class ScheduledExecutor {
   // A convenient alias. Its use is restricted to internal implementation use.
   using ThrottlePtr = std::unique_ptr<Throttle>;
 
+  void StopRebalance();
+
   std::unique_ptr<ThrottleScheduler> scheduler_;
 
-  ThreadPool thread_pool_;
+  // Exactly one of the two is set, according to the Backend.
+  std::unique_ptr<ThreadPool> thread_pool_;
+  std::unique_ptr<WorkStealingPool> work_stealing_pool_;
 
   ThrottleFactory factory_;
 
@@ -92,6 +117,11 @@ class ScheduledExecutor {
   std::mutex map_mtx_;
   std::mutex erase_mtx_;
   std::unordered_map<Schedulable::ID_Type, ThrottlePtr> throttles_;
+
+  std::unique_ptr<std::thread> rebalance_thread_;
+  bool rebalance_switch_ = false;
+  std::mutex rebalance_mtx_;
+  std::condition_variable rebalance_cv_;
 };
 
 } // executors
@@ -43,6 +43,10 @@ class Scheduler {
   // Call to release all allocated threads in recycler to Scheduler.
   virtual void RecycleAllThreads(Schedulable_T* recycler) = 0;
 
+  // Call to move allocated threads between schedulables according to their
+  // current demand. Schedulers not supporting it do nothing.
+  virtual void Rebalance() {}
+
  protected:
   Schedulable::Metadata metadata_;
 
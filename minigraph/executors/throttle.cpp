@@ -2,6 +2,7 @@
 #include <utility>
 
 #include "executors/throttle.h"
+#include "executors/latch.h"
 #include "executors/scheduler.h"
 #include "utility/logging.h"
 
@@ -17,7 +18,8 @@ Throttle::Throttle(ID_Type id, Scheduler<Throttle>* scheduler,
       metadata_(),
       sem_(max_parallelism),
       original_parallelism_(max_parallelism),
-      allocated_parallelism_(max_parallelism) {}
+      allocated_parallelism_(max_parallelism),
+      pending_packages_(0) {}
 
 Throttle::~Throttle() {
   // Recycle resources, if it has not done so.
@@ -34,25 +36,18 @@ Throttle::~Throttle() {
 }
 
 void Throttle::Run(Task&& task, bool release_resource) {
-  std::mutex mtx;
-  bool task_completed = false;
-  std::condition_variable finish_cv;
-
+  Latch latch(1);
+  pending_packages_.fetch_add(1);
   sem_.wait();
   downstream_->Run(
-      [this, &task_completed, &finish_cv, &mtx, t = std::move(task)]() {
+      [this, &latch, t = std::move(task)]() {
         t();
         sem_.post();
-        std::lock_guard grd(mtx);
-        task_completed = true;
-        finish_cv.notify_one();
+        pending_packages_.fetch_sub(1);
+        latch.CountDown();
       },
       false);
-
-  std::unique_lock<std::mutex> lck(mtx);
-  while (!task_completed) {
-    finish_cv.wait(lck);
-  }
+  latch.Wait();
 
   if (release_resource) scheduler_->RecycleOneThread(this);
 }
@@ -60,26 +55,24 @@ void Throttle::Run(Task&& task, bool release_resource) {
 void Throttle::Run(const std::vector<Task>& tasks, bool release_resource) {
   const std::vector<size_t> indices = PackagedTaskIndices(tasks.size());
   const size_t num_packages = indices.size() - 1;
-  std::mutex mtx;
-  std::atomic<size_t> pending_packages(num_packages);
-  std::condition_variable finish_cv;
+  // Packages count down as they finish, taking no lock. The last one wakes
+  // up the caller.
+  Latch latch(num_packages);
+  pending_packages_.fetch_add(num_packages);
   for (size_t i = num_packages; i > 0; i--) {
     sem_.wait();
     downstream_->Run(
-        [this, &indices, &tasks, &mtx, &pending_packages, &finish_cv,
-         index = i]() {
+        [this, &indices, &tasks, &latch, index = i]() {
           for (size_t j = indices[index - 1]; j < indices[index]; j++)
             tasks[j]();
-
-          std::lock_guard grd(mtx);
           sem_.post();
-          if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+          pending_packages_.fetch_sub(1);
+          latch.CountDown();
         },
         false);
   }
 
-  std::unique_lock<std::mutex> lck(mtx);
-  finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+  latch.Wait();
   //   Final cleaning.
   if (release_resource && GetParallelism() > 0) {
     scheduler_->RecycleAllThreads(this);
@@ -154,6 +147,18 @@ size_t Throttle::DecrementParallelism() {
   return before - 1;
 }
 
+size_t Throttle::TryDecrementParallelism(size_t max_delta) {
+  size_t delta = 0;
+  // A free count of the semaphore is a thread no task is running on.
+  while (delta < max_delta && sem_.try_wait()) {
+    allocated_parallelism_.fetch_sub(1);
+    delta++;
+  }
+  return delta;
+}
+
+size_t Throttle::PendingPackages() const { return pending_packages_.load(); }
+
 const Schedulable::Metadata& Throttle::metadata() const { return metadata_; }
 
 Schedulable::Metadata* Throttle::mutable_metadata() { return &metadata_; }
@@ -114,6 +114,18 @@ class Throttle final : public TaskRunner, public Schedulable {
   // Return a mutable pointer to the internal metadata object.
   Schedulable::Metadata* mutable_metadata();
 
+  // Decrement the limit on parallelism by up to `max_delta`, taking back only
+  // threads that no task is running on.
+  // Return the number of threads taken back.
+  //
+  // Unlike DecrementParallelism(), the call will return immediately.
+  size_t TryDecrementParallelism(size_t max_delta);
+
+  // Get the number of packages submitted via Run() and not completed yet,
+  // including those waiting for a thread. Compared with the parallelism, it
+  // tells how much the Throttle could make use of more threads.
+  size_t PendingPackages() const;
+
  private:
   // A helper function for Run() implementation.
   std::vector<size_t> PackagedTaskIndices(size_t total_tasks) const;
@@ -134,6 +146,8 @@ class Throttle final : public TaskRunner, public Schedulable {
   // Used to track the allowed parallelism, and to identify illegal operations,
   // e.g., reducing the maximum parallelism below 0.
   std::atomic_size_t allocated_parallelism_;
+
+  std::atomic_size_t pending_packages_;
 };
 
 // A companion factory class for Throttle.
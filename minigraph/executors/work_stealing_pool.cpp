@@ -0,0 +1,160 @@
+#include "executors/work_stealing_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "utility/numa.h"
+
+
+namespace minigraph {
+namespace executors {
+
+namespace {
+
+// Rounds of stealing before an idle worker parks.
+constexpr size_t kSpinRounds = 64;
+
+// The pool and the index of the worker running on this thread, if any.
+thread_local const WorkStealingPool* this_pool = nullptr;
+thread_local size_t this_worker = 0;
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned int num_threads, int numa_node) {
+  num_threads = std::max(num_threads, 1u);
+  for (unsigned int i = 0; i < num_threads; i++)
+    workers_.push_back(std::make_unique<Worker>());
+  for (unsigned int i = 0; i < num_threads; i++)
+    threads_.emplace_back([this, i, numa_node] {
+      if (numa_node >= 0) utility::PinThreadToNUMANode(numa_node);
+      Loop(i);
+    });
+}
+
+WorkStealingPool::~WorkStealingPool() { StopAndJoin(); }
+
+void WorkStealingPool::Run(Task&& task, bool /*release_resource*/) {
+  size_t index = ThisWorker();
+  if (index == workers_.size())
+    index = next_worker_.fetch_add(1, std::memory_order_relaxed) %
+            workers_.size();
+  auto& worker = *workers_[index];
+  worker.Lock();
+  worker.tasks.push_back(std::move(task));
+  worker.Unlock();
+  Notify(1);
+}
+
+void WorkStealingPool::Run(const std::vector<Task>& tasks,
+                           bool /*release_resource*/) {
+  if (tasks.empty()) return;
+  size_t index = ThisWorker();
+  if (index != workers_.size()) {
+    // Left for the idle workers to steal.
+    auto& worker = *workers_[index];
+    worker.Lock();
+    worker.tasks.insert(worker.tasks.end(), tasks.begin(), tasks.end());
+    worker.Unlock();
+    Notify(tasks.size());
+    return;
+  }
+
+  const size_t num_ranges = std::min(workers_.size(), tasks.size());
+  const size_t first = next_worker_.fetch_add(1, std::memory_order_relaxed);
+  for (size_t i = 0; i < num_ranges; i++) {
+    auto begin = tasks.begin() + tasks.size() * i / num_ranges;
+    auto end = tasks.begin() + tasks.size() * (i + 1) / num_ranges;
+    auto& worker = *workers_[(first + i) % workers_.size()];
+    worker.Lock();
+    worker.tasks.insert(worker.tasks.end(), begin, end);
+    worker.Unlock();
+  }
+  Notify(tasks.size());
+}
+
+size_t WorkStealingPool::GetParallelism() const { return threads_.size(); }
+
+void WorkStealingPool::StopAndJoin() {
+  {
+    std::lock_guard<std::mutex> grd(sleep_mtx_);
+    stop_.store(true);
+  }
+  sleep_cv_.notify_all();
+  for (auto& t : threads_)
+    if (t.joinable()) t.join();
+}
+
+void WorkStealingPool::Loop(size_t index) {
+  this_pool = this;
+  this_worker = index;
+  size_t idle_rounds = 0;
+  while (true) {
+    Task task;
+    if (TryGet(index, &task)) {
+      task();
+      idle_rounds = 0;
+      continue;
+    }
+    if (stop_.load()) break;
+    if (++idle_rounds < kSpinRounds) {
+      std::this_thread::yield();
+      continue;
+    }
+    // Notify() reads num_sleeping_ after adding to num_pending_, so either
+    // the new tasks are seen here, or the submitter wakes this worker up.
+    std::unique_lock<std::mutex> lck(sleep_mtx_);
+    num_sleeping_.fetch_add(1);
+    sleep_cv_.wait(lck, [this] { return num_pending_.load() > 0 || stop_; });
+    num_sleeping_.fetch_sub(1);
+    idle_rounds = 0;
+  }
+}
+
+bool WorkStealingPool::TryGet(size_t index, Task* task) {
+  // LIFO on its own deque, for the tasks still being warm in cache.
+  auto& own = *workers_[index];
+  own.Lock();
+  if (!own.tasks.empty()) {
+    *task = std::move(own.tasks.back());
+    own.tasks.pop_back();
+    own.Unlock();
+    num_pending_.fetch_sub(1);
+    return true;
+  }
+  own.Unlock();
+
+  // FIFO on the others, taking the tasks their owners are least likely to
+  // reach soon.
+  for (size_t i = 1; i < workers_.size(); i++) {
+    auto& victim = *workers_[(index + i) % workers_.size()];
+    victim.Lock();
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      victim.Unlock();
+      num_pending_.fetch_sub(1);
+      return true;
+    }
+    victim.Unlock();
+  }
+  return false;
+}
+
+void WorkStealingPool::Notify(size_t num_tasks) {
+  num_pending_.fetch_add(num_tasks);
+  if (num_sleeping_.load() == 0) return;
+  // Taking the lock makes sure a worker that saw no pending tasks is
+  // already waiting on sleep_cv_.
+  { std::lock_guard<std::mutex> grd(sleep_mtx_); }
+  if (num_tasks == 1)
+    sleep_cv_.notify_one();
+  else
+    sleep_cv_.notify_all();
+}
+
+size_t WorkStealingPool::ThisWorker() const {
+  return this_pool == this ? this_worker : workers_.size();
+}
+
+}  // namespace executors
+}  // namespace minigraph
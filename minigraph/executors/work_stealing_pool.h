@@ -0,0 +1,97 @@
+#ifndef MINIGRAPH_EXECUTORS_WORK_STEALING_POOL_H_
+#define MINIGRAPH_EXECUTORS_WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "executors/task_runner.h"
+
+
+namespace minigraph {
+namespace executors {
+
+// A thread pool, where each worker owns a deque of tasks.
+//
+// A worker pops tasks from the back of its own deque, and once it runs dry,
+// steals from the front of the others. Batches are split into contiguous
+// ranges, one per worker, so that submitting a batch takes one short
+// critical section per worker rather than one per task, and there is no
+// queue shared by all workers. Idle workers park on a condition variable
+// only after a round of stealing fails.
+//
+// Tasks submitted from a worker thread go to the deque of that worker.
+class WorkStealingPool final : public TaskRunner {
+ public:
+  // Parameter `num_threads` determines the number of threads in the pool.
+  // If `numa_node` is set, the threads are pinned to the cpus of that NUMA
+  // node.
+  explicit WorkStealingPool(unsigned int num_threads, int numa_node = -1);
+  ~WorkStealingPool();
+
+  // Submit a task to the thread pool and return *immediately*.
+  //
+  // `release_resource` does not make a difference here.
+  [[deprecated("Superseded by the overloads with a release_resource option.")]]
+  void Run(Task&& task) override {
+    Run(std::move(task), false);
+  }
+  void Run(Task&& task, bool release_resource) override;
+
+  // Submit a batch of tasks to the thread pool and return *immediately*.
+  //
+  // `release_resource` does not make a difference here.
+  void Run(const std::vector<Task>& tasks, bool release_resource) override;
+
+  // Get the total number of threads within the thread pool.
+  size_t GetParallelism() const override;
+
+  // Run the tasks left, then stop the thread pool and join all threads.
+  void StopAndJoin();
+
+ private:
+  // A deque guarded by a spin lock, which is only held to push or pop.
+  struct Worker {
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    std::deque<Task> tasks;
+
+    void Lock() {
+      while (lock.test_and_set(std::memory_order_acquire))
+        std::this_thread::yield();
+    }
+    void Unlock() { lock.clear(std::memory_order_release); }
+  };
+
+  void Loop(size_t index);
+
+  // Pop a task of worker `index`, or steal one from the others.
+  bool TryGet(size_t index, Task* task);
+
+  // Account for `num_tasks` new tasks, and wake up parked workers.
+  void Notify(size_t num_tasks);
+
+  // Index of the worker running on the calling thread in this pool, or
+  // the number of workers if there is none.
+  size_t ThisWorker() const;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  // Tasks submitted and not taken by any worker yet.
+  std::atomic<size_t> num_pending_{0};
+  // Workers parked, or about to park, on sleep_cv_.
+  std::atomic<size_t> num_sleeping_{0};
+  std::atomic<size_t> next_worker_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex sleep_mtx_;
+  std::condition_variable sleep_cv_;
+};
+
+}  // namespace executors
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_EXECUTORS_WORK_STEALING_POOL_H_
@@ -0,0 +1,338 @@
+#ifndef MINIGRAPH_GRAPHS_CSR_BUILDER_H
+#define MINIGRAPH_GRAPHS_CSR_BUILDER_H
+
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+#include "graphs/immutable_csr.h"
+#include "portability/sys_types.h"
+#include "utility/atomic.h"
+#include "utility/bitmap.h"
+#include "utility/logging.h"
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace graphs {
+
+// CSRBuilder turns an edge list into ImmutableCSR fragments without building
+// a VertexInfo per vertex. The constructor counts the degree of every vertex,
+// turns degrees into offsets with a parallel scan and scatters the edges into
+// two global adjacency arrays, one for in-edges and one for out-edges.
+// Build() then cuts a fragment out of them: the vid range is split into one
+// block per core, a scan over the per-block sizes gives each block its first
+// local id and its first in/out offset, and each block copies its adjacency
+// straight into the final buf_graph_. Local ids follow the order of global
+// ids, as ImmutableCSR's VertexInfo constructor does.
+template <typename GID_T, typename VID_T, typename VDATA_T, typename EDATA_T>
+class CSRBuilder {
+  using CSR_T = ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>;
+
+ public:
+  // edges is an interleaved <src, dst> array, e.g. EdgeList::buf_graph_,
+  // and max_vid an upper bound of the vids in it.
+  CSRBuilder(const VID_T* edges, const size_t num_edges, const VID_T max_vid,
+             const size_t cores = 1, const bool skip_self_loops = false) {
+    cores_ = cores == 0 ? 1 : cores;
+    max_vid_ = max_vid;
+    // Arrays indexed by vid hold max_vid + 1 entries, rounded up.
+    aligned_max_vid_ =
+        ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+    vertex_indicator_ = new Bitmap(aligned_max_vid_);
+    vertex_indicator_->clear();
+
+    // in_offset_[v + 1] - in_offset_[v] is the indegree of v.
+    size_t size_offset = (size_t)max_vid_ + 2;
+    in_offset_ = (size_t*)malloc(sizeof(size_t) * size_offset);
+    out_offset_ = (size_t*)malloc(sizeof(size_t) * size_offset);
+    memset(in_offset_, 0, sizeof(size_t) * size_offset);
+    memset(out_offset_, 0, sizeof(size_t) * size_offset);
+
+    LOG_INFO("CSRBuilder: Count degrees. NumEdges: ", num_edges);
+    std::atomic<size_t> num_kept_edges(0);
+    ForEachBlock([&](size_t tid) {
+      size_t begin, end;
+      GetBlock(tid, num_edges, &begin, &end);
+      size_t count = 0;
+      for (size_t j = begin; j < end; j++) {
+        auto src_vid = edges[j * 2];
+        auto dst_vid = edges[j * 2 + 1];
+        if (skip_self_loops && src_vid == dst_vid) continue;
+        assert(src_vid <= max_vid_ && dst_vid <= max_vid_);
+        if (!vertex_indicator_->get_bit(src_vid))
+          vertex_indicator_->set_bit(src_vid);
+        if (!vertex_indicator_->get_bit(dst_vid))
+          vertex_indicator_->set_bit(dst_vid);
+        __sync_fetch_and_add(out_offset_ + src_vid + 1, 1);
+        __sync_fetch_and_add(in_offset_ + dst_vid + 1, 1);
+        count++;
+      }
+      num_kept_edges.fetch_add(count);
+    });
+    num_edges_ = num_kept_edges.load();
+
+    LOG_INFO("CSRBuilder: Scan degrees");
+    InclusiveScan(in_offset_, size_offset);
+    InclusiveScan(out_offset_, size_offset);
+
+    LOG_INFO("CSRBuilder: Scatter edges");
+    in_edges_ = (VID_T*)malloc(sizeof(VID_T) * num_edges_);
+    out_edges_ = (VID_T*)malloc(sizeof(VID_T) * num_edges_);
+    ForEachBlock([&](size_t tid) {
+      size_t begin, end;
+      GetBlock(tid, num_edges, &begin, &end);
+      for (size_t j = begin; j < end; j++) {
+        auto src_vid = edges[j * 2];
+        auto dst_vid = edges[j * 2 + 1];
+        if (skip_self_loops && src_vid == dst_vid) continue;
+        out_edges_[__sync_fetch_and_add(out_offset_ + src_vid, 1)] = dst_vid;
+        in_edges_[__sync_fetch_and_add(in_offset_ + dst_vid, 1)] = src_vid;
+      }
+    });
+    // The cursors of v ended at the offset of v + 1, shift them back.
+    memmove(in_offset_ + 1, in_offset_, sizeof(size_t) * (size_offset - 1));
+    memmove(out_offset_ + 1, out_offset_, sizeof(size_t) * (size_offset - 1));
+    in_offset_[0] = 0;
+    out_offset_[0] = 0;
+
+    num_vertexes_ = CountMembers(vertex_indicator_, aligned_max_vid_);
+    LOG_INFO("CSRBuilder: num_vertexes: ", num_vertexes_,
+             " num_edges: ", num_edges_);
+  }
+
+  ~CSRBuilder() {
+    if (in_offset_ != nullptr) free(in_offset_);
+    if (out_offset_ != nullptr) free(out_offset_);
+    if (in_edges_ != nullptr) free(in_edges_);
+    if (out_edges_ != nullptr) free(out_edges_);
+    if (vertex_indicator_ != nullptr) delete vertex_indicator_;
+  }
+
+  // Build a fragment holding the vertexes set in members, together with all
+  // their in- and out-edges. All vertexes of the edge list are taken if
+  // members is nullptr. vid_map, if provided, receives the local id of each
+  // member.
+  CSR_T* Build(const GID_T gid, Bitmap* members = nullptr,
+               VID_T* vid_map = nullptr) {
+    if (members == nullptr) members = vertex_indicator_;
+
+    // The fragment's max_vid is its largest member.
+    VID_T max_vid = 0;
+    for (size_t w = WORD_OFFSET(aligned_max_vid_) + 1; w-- > 0;) {
+      if (members->data_[w] == 0) continue;
+      max_vid = w * 64 + 63 - __builtin_clzl(members->data_[w]);
+      break;
+    }
+    if (max_vid > max_vid_) max_vid = max_vid_;
+    size_t aligned_max_vid =
+        ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+    size_t num_words = WORD_OFFSET(aligned_max_vid) + 1;
+
+    // Per block number of vertexes and edges, scanned into the first local
+    // id and the first in/out offset of each block.
+    size_t* block_vertexes = (size_t*)malloc(sizeof(size_t) * (cores_ + 1));
+    size_t* block_in = (size_t*)malloc(sizeof(size_t) * (cores_ + 1));
+    size_t* block_out = (size_t*)malloc(sizeof(size_t) * (cores_ + 1));
+    memset(block_vertexes, 0, sizeof(size_t) * (cores_ + 1));
+    memset(block_in, 0, sizeof(size_t) * (cores_ + 1));
+    memset(block_out, 0, sizeof(size_t) * (cores_ + 1));
+    ForEachBlock([&](size_t tid) {
+      size_t begin, end;
+      GetBlock(tid, num_words, &begin, &end);
+      for (size_t w = begin; w < end; w++) {
+        for (auto word = members->data_[w]; word != 0; word &= word - 1) {
+          VID_T v = w * 64 + __builtin_ctzl(word);
+          block_vertexes[tid + 1]++;
+          block_in[tid + 1] += in_offset_[v + 1] - in_offset_[v];
+          block_out[tid + 1] += out_offset_[v + 1] - out_offset_[v];
+        }
+      }
+    });
+    for (size_t tid = 0; tid < cores_; tid++) {
+      block_vertexes[tid + 1] += block_vertexes[tid];
+      block_in[tid + 1] += block_in[tid];
+      block_out[tid + 1] += block_out[tid];
+    }
+    size_t num_vertexes = block_vertexes[cores_];
+    size_t sum_in_edges = block_in[cores_];
+    size_t sum_out_edges = block_out[cores_];
+
+    auto graph = new CSR_T(gid, nullptr);
+    graph->num_vertexes_ = num_vertexes;
+    graph->sum_in_edges_ = sum_in_edges;
+    graph->sum_out_edges_ = sum_out_edges;
+    graph->num_edges_ = sum_in_edges + sum_out_edges;
+    graph->max_vid_ = max_vid;
+    graph->aligned_max_vid_ = aligned_max_vid;
+
+    size_t size_globalid = sizeof(VID_T) * num_vertexes;
+    size_t size_degree = sizeof(size_t) * num_vertexes;
+    size_t size_in_edges = sizeof(VID_T) * sum_in_edges;
+    size_t size_out_edges = sizeof(VID_T) * sum_out_edges;
+    size_t size_localid_by_globalid = sizeof(VID_T) * aligned_max_vid;
+    size_t total_size = size_globalid + size_degree * 4 + size_in_edges +
+                        size_out_edges + size_localid_by_globalid;
+    graph->buf_graph_ = (VID_T*)malloc(total_size);
+    char* buf = (char*)graph->buf_graph_;
+    graph->globalid_by_index_ = (VID_T*)buf;
+    graph->indegree_ = (size_t*)(buf + size_globalid);
+    graph->outdegree_ = graph->indegree_ + num_vertexes;
+    graph->in_offset_ = graph->outdegree_ + num_vertexes;
+    graph->out_offset_ = graph->in_offset_ + num_vertexes;
+    graph->in_edges_ = (VID_T*)(graph->out_offset_ + num_vertexes);
+    graph->out_edges_ = graph->in_edges_ + sum_in_edges;
+    graph->localid_by_globalid_ = graph->out_edges_ + sum_out_edges;
+    memset(graph->localid_by_globalid_, 0, size_localid_by_globalid);
+
+    graph->bitmap_ = new Bitmap(aligned_max_vid);
+    graph->bitmap_->clear();
+
+    LOG_INFO("CSRBuilder: Fill fragment ", gid,
+             " num_vertexes: ", num_vertexes, " sum_in_edges: ", sum_in_edges,
+             " sum_out_edges: ", sum_out_edges);
+    ForEachBlock([&](size_t tid) {
+      size_t begin, end;
+      GetBlock(tid, num_words, &begin, &end);
+      size_t local_id = block_vertexes[tid];
+      size_t in_offset = block_in[tid];
+      size_t out_offset = block_out[tid];
+      for (size_t w = begin; w < end; w++) {
+        graph->bitmap_->data_[w] = members->data_[w];
+        for (auto word = members->data_[w]; word != 0; word &= word - 1) {
+          VID_T v = w * 64 + __builtin_ctzl(word);
+          size_t indegree = in_offset_[v + 1] - in_offset_[v];
+          size_t outdegree = out_offset_[v + 1] - out_offset_[v];
+          graph->globalid_by_index_[local_id] = v;
+          graph->localid_by_globalid_[v] = local_id;
+          if (vid_map != nullptr) vid_map[v] = local_id;
+          graph->indegree_[local_id] = indegree;
+          graph->outdegree_[local_id] = outdegree;
+          graph->in_offset_[local_id] = in_offset;
+          graph->out_offset_[local_id] = out_offset;
+          memcpy(graph->in_edges_ + in_offset, in_edges_ + in_offset_[v],
+                 sizeof(VID_T) * indegree);
+          memcpy(graph->out_edges_ + out_offset, out_edges_ + out_offset_[v],
+                 sizeof(VID_T) * outdegree);
+          in_offset += indegree;
+          out_offset += outdegree;
+          local_id++;
+        }
+      }
+    });
+    free(block_vertexes);
+    free(block_in);
+    free(block_out);
+
+    graph->vdata_ = (VDATA_T*)malloc(sizeof(VDATA_T) * num_vertexes);
+    memset(graph->vdata_, 0, sizeof(VDATA_T) * num_vertexes);
+    graph->edata_ = (EDATA_T*)malloc(sizeof(EDATA_T) * sum_out_edges);
+    memset(graph->edata_, 0, sizeof(EDATA_T) * sum_out_edges);
+    graph->is_serialized_ = true;
+    return graph;
+  }
+
+  Bitmap* GetVertexIndicator() const { return vertex_indicator_; }
+
+  inline size_t get_indegree(const VID_T vid) const {
+    return in_offset_[vid + 1] - in_offset_[vid];
+  }
+  inline size_t get_outdegree(const VID_T vid) const {
+    return out_offset_[vid + 1] - out_offset_[vid];
+  }
+  inline const VID_T* get_in_edges(const VID_T vid) const {
+    return in_edges_ + in_offset_[vid];
+  }
+  inline const VID_T* get_out_edges(const VID_T vid) const {
+    return out_edges_ + out_offset_[vid];
+  }
+  inline size_t get_num_vertexes() const { return num_vertexes_; }
+  inline size_t get_num_edges() const { return num_edges_; }
+  inline VID_T get_max_vid() const { return max_vid_; }
+  inline size_t get_aligned_max_vid() const { return aligned_max_vid_; }
+
+ private:
+  size_t cores_ = 1;
+  VID_T max_vid_ = 0;
+  size_t aligned_max_vid_ = 0;
+  size_t num_vertexes_ = 0;
+  size_t num_edges_ = 0;
+  Bitmap* vertex_indicator_ = nullptr;
+
+  size_t* in_offset_ = nullptr;
+  size_t* out_offset_ = nullptr;
+  VID_T* in_edges_ = nullptr;
+  VID_T* out_edges_ = nullptr;
+
+  // Contiguous share of tid in [0, n).
+  void GetBlock(const size_t tid, const size_t n, size_t* begin,
+                size_t* end) const {
+    size_t step = (n + cores_ - 1) / cores_;
+    *begin = tid * step < n ? tid * step : n;
+    *end = *begin + step < n ? *begin + step : n;
+  }
+
+  template <typename F>
+  void ForEachBlock(F&& f) {
+    if (cores_ == 1) {
+      f(0);
+      return;
+    }
+    auto thread_pool = minigraph::utility::CPUThreadPool(cores_, 1);
+    std::mutex mtx;
+    std::condition_variable finish_cv;
+    std::unique_lock<std::mutex> lck(mtx);
+    std::atomic<size_t> pending_packages(cores_);
+    for (size_t tid = 0; tid < cores_; tid++) {
+      thread_pool.Commit([tid, &f, &pending_packages, &finish_cv]() {
+        f(tid);
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
+    }
+    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+  }
+
+  // In-place inclusive prefix sum: sum each block, scan the block sums, then
+  // let each block scan itself starting from its base.
+  void InclusiveScan(size_t* a, const size_t n) {
+    size_t* base = (size_t*)malloc(sizeof(size_t) * (cores_ + 1));
+    memset(base, 0, sizeof(size_t) * (cores_ + 1));
+    ForEachBlock([&](size_t tid) {
+      size_t begin, end;
+      GetBlock(tid, n, &begin, &end);
+      for (size_t i = begin; i < end; i++) base[tid + 1] += a[i];
+    });
+    for (size_t tid = 0; tid < cores_; tid++) base[tid + 1] += base[tid];
+    ForEachBlock([&](size_t tid) {
+      size_t begin, end;
+      GetBlock(tid, n, &begin, &end);
+      size_t sum = base[tid];
+      for (size_t i = begin; i < end; i++) {
+        sum += a[i];
+        a[i] = sum;
+      }
+    });
+    free(base);
+  }
+
+  size_t CountMembers(Bitmap* bitmap, const size_t aligned_max_vid) {
+    std::atomic<size_t> count(0);
+    size_t num_words = WORD_OFFSET(aligned_max_vid) + 1;
+    ForEachBlock([&](size_t tid) {
+      size_t begin, end;
+      GetBlock(tid, num_words, &begin, &end);
+      size_t local_count = 0;
+      for (size_t w = begin; w < end; w++)
+        local_count += __builtin_popcountl(bitmap->data_[w]);
+      count.fetch_add(local_count);
+    });
+    return count.load();
+  }
+};
+
+}  // namespace graphs
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_GRAPHS_CSR_BUILDER_H
@@ -39,7 +39,7 @@ class EdgeList : public Graph<GID_T, VID_T, VDATA_T, EDATA_T> {
     this->num_edges_ = num_edges;
     this->max_vid_ = max_vid;
     this->aligned_max_vid_ =
-        ceil(max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+        ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
     this->num_vertexes_ = num_vertexes;
 
     if (num_vertexes != 0) {
@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "graphs/edgelist.h"
 #include "graphs/graph.h"
@@ -59,7 +60,8 @@ class ImmutableCSR : public Graph<GID_T, VID_T, VDATA_T, EDATA_T> {
     this->max_vid_ = max_vid;
     LOG_INFO("max_vid: ", this->get_max_vid());
     this->aligned_max_vid_ =
-        ceil((float)this->get_max_vid() / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+        ceil(((size_t)this->get_max_vid() + 1) / ALIGNMENT_FACTOR) *
+        ALIGNMENT_FACTOR;
     assert(this->get_max_vid() > 0);
     assert(this->get_aligned_max_vid() > 0);
     this->bitmap_ = new Bitmap(this->get_aligned_max_vid());
@@ -367,26 +369,51 @@ class ImmutableCSR : public Graph<GID_T, VID_T, VDATA_T, EDATA_T> {
     return;
   }
 
+  // Sort all adjacency lists. Lists are handed out in chunks of vertexes and
+  // sorted by one thread each, by insertion sort if tiny and radix sort
+  // otherwise. Hub lists longer than hub_degree are left out and then sorted
+  // one at a time by all cores.
   void Sort(size_t cores = 1) {
     auto thread_pool = minigraph::utility::CPUThreadPool(cores, 1);
-    std::mutex mtx;
-    std::condition_variable finish_cv;
-    std::unique_lock<std::mutex> lck(mtx);
-    std::atomic<size_t> pending_packages(cores);
-
-    pending_packages.store(cores);
-    for (size_t i = 0; i < cores; i++) {
-      thread_pool.Commit([&, i, &cores, &pending_packages, &finish_cv]() {
-        for (size_t j = i; j < this->get_num_vertexes(); j += cores) {
+    const size_t chunk_size = 1024;
+    const size_t hub_degree = std::max(
+        (size_t)1 << 16, (sum_in_edges_ + sum_out_edges_) / (cores * 4));
+    const size_t num_vertexes = this->get_num_vertexes();
+
+    std::atomic<size_t> next_chunk(0);
+    ParallelFor(thread_pool, cores, [&](size_t tid) {
+      std::vector<VID_T> tmp;
+      for (size_t begin = next_chunk.fetch_add(chunk_size);
+           begin < num_vertexes; begin = next_chunk.fetch_add(chunk_size)) {
+        size_t end = std::min(begin + chunk_size, num_vertexes);
+        for (size_t j = begin; j < end; j++) {
           auto u = GetVertexByIndex(j);
-          QuickSort(u.out_edges, 0, u.outdegree - 1);
-          QuickSort(u.in_edges, 0, u.indegree - 1);
+          if (u.outdegree < hub_degree) {
+            if (tmp.size() < u.outdegree) tmp.resize(u.outdegree);
+            AdaptiveSort(u.out_edges, u.outdegree, tmp.data());
+          }
+          if (u.indegree < hub_degree) {
+            if (tmp.size() < u.indegree) tmp.resize(u.indegree);
+            AdaptiveSort(u.in_edges, u.indegree, tmp.data());
+          }
         }
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
+      }
+    });
+
+    std::vector<VID_T> tmp;
+    for (size_t j = 0; j < num_vertexes; j++) {
+      auto u = GetVertexByIndex(j);
+      if (u.outdegree >= hub_degree) {
+        if (tmp.size() < u.outdegree) tmp.resize(u.outdegree);
+        ParallelRadixSort(u.out_edges, u.outdegree, tmp.data(), cores,
+                          thread_pool);
+      }
+      if (u.indegree >= hub_degree) {
+        if (tmp.size() < u.indegree) tmp.resize(u.indegree);
+        ParallelRadixSort(u.in_edges, u.indegree, tmp.data(), cores,
+                          thread_pool);
+      }
     }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
     return;
   }
 
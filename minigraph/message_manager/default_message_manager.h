@@ -6,6 +6,7 @@
 #include "portability/sys_data_structure.h"
 #include "utility/io/data_mngr.h"
 #include <fstream>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -53,7 +54,7 @@ class DefaultMessageManager : public MessageManagerBase {
     max_vid_ = out3.first;
     global_border_vid_map_ = out3.second;
     aligned_max_vid_ =
-        ceil((float)max_vid_ / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+        ceil(((size_t)max_vid_ + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
     global_border_vdata_ = (VDATA_T*)malloc(aligned_max_vid_ * sizeof(VDATA_T));
 
     for (VID_T vid = 0; vid < aligned_max_vid_; vid++)
@@ -114,6 +115,40 @@ class DefaultMessageManager : public MessageManagerBase {
 
   StatisticInfo* GetStatisticInfo() { return si_; }
 
+  // Publish the outcome of a PEval / IncEval on gid, so that schedulers
+  // rank fragments by the current computation. If gid changed, fragments
+  // depending on it receive a message of update_magnitude. Fields are
+  // updated in place: a scheduler reading concurrently may see a mix of two
+  // supersteps, which only affects the order of fragments.
+  void UpdateStatisticInfo(const GID_T gid, const size_t num_active_vertexes,
+                           const float elapsed_time, const size_t superstep,
+                           const bool changed,
+                           const double update_magnitude = 0) {
+    std::lock_guard<std::mutex> lck(si_mtx_);
+    si_[gid].num_active_vertexes = num_active_vertexes;
+    si_[gid].elapsed_time = elapsed_time;
+    si_[gid].current_iter = superstep;
+    if (!changed) return;
+    for (GID_T y = 0; y < num_graphs_; y++) {
+      if (!CheckDependenes(y, gid)) continue;
+      si_[y].num_incoming_messages++;
+      si_[y].pending_updates += update_magnitude;
+    }
+  }
+
+  // Called as the evaluation of gid starts, which consumes its messages.
+  void ClearIncomingMessages(const GID_T gid) {
+    std::lock_guard<std::mutex> lck(si_mtx_);
+    si_[gid].num_incoming_messages = 0;
+    si_[gid].pending_updates = 0;
+  }
+
+  // Whether messages reached gid since its last evaluation started.
+  bool HasIncomingMessages(const GID_T gid) {
+    std::lock_guard<std::mutex> lck(si_mtx_);
+    return si_[gid].num_incoming_messages > 0;
+  }
+
   size_t get_max_vid() { return max_vid_; }
 
   bool WriteStatisticInfo(const std::string pt) {
@@ -141,6 +176,7 @@ class DefaultMessageManager : public MessageManagerBase {
   bool* communication_matrix_ = nullptr;
   char* historical_state_matrix_ = nullptr;
   StatisticInfo* si_ = nullptr;
+  std::mutex si_mtx_;
   std::atomic<size_t> offset_bucket = 0;
 };
 
@@ -5,13 +5,17 @@
 #include "components/computing_component.h"
 #include "components/discharge_component.h"
 #include "components/load_component.h"
+#include "components/stage.h"
 #include "message_manager/default_message_manager.h"
 #include "utility/io/data_mngr.h"
+#include "utility/metrics.h"
 #include "utility/paritioner/edge_cut_partitioner.h"
 #include "utility/state_machine.h"
+#include "utility/tracer.h"
 #include <folly/synchronization/NativeSemaphore.h>
 #include <condition_variable>
 #include <dirent.h>
+#include <sys/resource.h>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -54,7 +58,10 @@ class MiniGraphSys {
              ", num_worker_dc: ", num_workers_dc, ", num_threads: ", num_cores,
              ", buffer size: ", buffer_size);
 
-    num_threads_ = 3;
+    // LC is the only component with a loop of its own, waiting for
+    // fragments to read and for room in the buffer.
+    num_threads_ = 1;
+    work_space_ = work_space;
 
     // init Data Manager.
     data_mngr_ = std::make_unique<utility::io::DataMngr<GRAPH_T>>();
@@ -87,13 +94,6 @@ class MiniGraphSys {
     // init load sem
     load_sem_ = std::make_unique<folly::NativeSemaphore>(buffer_size);
 
-    // init task queue
-    task_queue_ = std::make_unique<folly::ProducerConsumerQueue<GID_T>>(
-        buffer_size >= 2 ? buffer_size : 2);
-
-    // init partial result queue
-    partial_result_queue_ = std::make_unique<std::queue<GID_T>>();
-
     // init thread pool
     thread_pool_ = std::make_unique<utility::EDFThreadPool>(num_threads_);
     lc_thread_pool_ = std::make_unique<utility::EDFThreadPool>(num_workers_lc);
@@ -110,19 +110,8 @@ class MiniGraphSys {
 
     // init mutex, lck and cv
     read_trigger_mtx_ = std::make_unique<std::mutex>();
-    task_queue_mtx_ = std::make_unique<std::mutex>();
-    partial_result_mtx_ = std::make_unique<std::mutex>();
-
-    read_trigger_lck_ = std::make_unique<std::unique_lock<std::mutex>>(
-        *read_trigger_mtx_.get());
-    task_queue_lck_ =
-        std::make_unique<std::unique_lock<std::mutex>>(*task_queue_mtx_.get());
-    partial_result_lck_ = std::make_unique<std::unique_lock<std::mutex>>(
-        *partial_result_mtx_.get());
 
     read_trigger_cv_ = std::make_unique<std::condition_variable>();
-    task_queue_cv_ = std::make_unique<std::condition_variable>();
-    partial_result_cv_ = std::make_unique<std::condition_variable>();
 
     system_switch_ = std::make_unique<std::atomic<bool>>(true);
     system_switch_mtx_ = std::make_unique<std::mutex>();
@@ -131,29 +120,36 @@ class MiniGraphSys {
     system_switch_cv_ = std::make_unique<std::condition_variable>();
 
     // init components
+    // A fragment read by LC is handed to CC, which evaluates it on its thread
+    // pool and hands it to DC, or straight to DC if short cut. DC releases
+    // fragments one at a time, on tasks of its own thread pool.
+    auto compute = [this](GID_T gid) { computing_component_->Submit(gid); };
+    auto discharge = [this](GID_T gid) { discharge_stage_->Push(gid); };
     load_component_ = std::make_unique<components::LoadComponent<GRAPH_T>>(
         buffer_size, load_sem_.get(), lc_thread_pool_.get(), superstep_by_gid_,
         global_superstep_, state_machine_, read_trigger_.get(),
-        task_queue_.get(), partial_result_queue_.get(), pt_by_gid_.get(),
-        data_mngr_.get(), msg_mngr_.get(), read_trigger_lck_.get(),
-        read_trigger_cv_.get(), task_queue_cv_.get(), partial_result_cv_.get(),
-        mode, scheduler);
+        pt_by_gid_.get(), data_mngr_.get(), msg_mngr_.get(),
+        read_trigger_mtx_.get(), read_trigger_cv_.get(), compute, discharge,
+        mode, scheduler, work_space + "minigraph_si/cost_model.yaml");
     computing_component_ =
         std::make_unique<components::ComputingComponent<GRAPH_T, AUTOAPP_T>>(
             num_workers_cc, num_cores, cc_thread_pool_.get(), superstep_by_gid_,
-            global_superstep_, state_machine_, task_queue_.get(),
-            partial_result_queue_.get(), data_mngr_.get(), app_wrapper_.get(),
-            task_queue_lck_.get(), task_queue_cv_.get(),
-            partial_result_cv_.get());
+            global_superstep_, state_machine_, data_mngr_.get(),
+            app_wrapper_.get(), discharge);
     discharge_component_ =
         std::make_unique<components::DischargeComponent<GRAPH_T>>(
             num_workers_dc, load_sem_.get(), dc_thread_pool_.get(),
             superstep_by_gid_, global_superstep_, state_machine_,
-            partial_result_queue_.get(), task_queue_.get(), read_trigger_.get(),
-            pt_by_gid_.get(), data_mngr_.get(), msg_mngr_.get(),
-            partial_result_lck_.get(), partial_result_cv_.get(),
-            task_queue_cv_.get(), read_trigger_cv_.get(), system_switch_.get(),
-            system_switch_lck_.get(), system_switch_cv_.get(), num_iter, mode);
+            read_trigger_.get(), pt_by_gid_.get(), data_mngr_.get(),
+            msg_mngr_.get(), read_trigger_mtx_.get(), read_trigger_cv_.get(),
+            system_switch_.get(), system_switch_lck_.get(),
+            system_switch_cv_.get(), num_iter, mode);
+    discharge_stage_ = std::make_unique<components::Stage<GID_T>>(
+        dc_thread_pool_.get(), [this](GID_T gid) {
+          utility::Metrics::Get().Set("minigraph_partial_result_queue_depth",
+                                      discharge_stage_->Size() - 1);
+          discharge_component_->Process(gid);
+        });
     LOG_INFO("Init MiniGraphSys: Finish.");
   };
 
@@ -165,8 +161,6 @@ class MiniGraphSys {
     computing_component_->Stop();
     discharge_component_->Stop();
     read_trigger_cv_->notify_all();
-    task_queue_cv_->notify_all();
-    partial_result_cv_->notify_all();
     load_component_->~LoadComponent();
     computing_component_->~ComputingComponent();
     discharge_component_->~DischargeComponent();
@@ -176,20 +170,13 @@ class MiniGraphSys {
     LOG_INFO("START MiniGraph.");
     auto task_lc = std::bind(&components::LoadComponent<GRAPH_T>::Run,
                              load_component_.get());
-    auto task_cc =
-        std::bind(&components::ComputingComponent<GRAPH_T, AUTOAPP_T>::Run,
-                  computing_component_.get());
-
-    auto task_dc = std::bind(&components::DischargeComponent<GRAPH_T>::Run,
-                             discharge_component_.get());
-
-    this->thread_pool_->Commit(task_dc);
-    this->thread_pool_->Commit(task_cc);
+    computing_component_->Run();
+    discharge_component_->Run();
     this->thread_pool_->Commit(task_lc);
+    if (metrics_pt_ != "")
+      utility::Metrics::Get().StartDump(metrics_pt_, metrics_interval_);
     auto start_time = std::chrono::system_clock::now();
     read_trigger_cv_->notify_all();
-    task_queue_cv_->notify_all();
-    partial_result_cv_->notify_all();
     system_switch_cv_->wait(*system_switch_lck_,
                             [&] { return !system_switch_->load(); });
     auto end_time = std::chrono::system_clock::now();
@@ -202,11 +189,74 @@ class MiniGraphSys {
                      (double)CLOCKS_PER_SEC
               << ", Superstep: " << this->global_superstep_->load()
               << " ####      " << std::endl;
+    computing_component_->WriteSuperstepInfo(
+        work_space_ + "minigraph_si/supersteps.csv");
+
+    run_info_.elapsed_time =
+        std::chrono::duration<double>(end_time - start_time).count();
+    run_info_.read_time = data_mngr_->get_read_time();
+    run_info_.peval_time = computing_component_->GetEvalTime(0);
+    run_info_.inc_eval_time = computing_component_->GetEvalTime(1);
+    run_info_.write_time = data_mngr_->get_write_time();
+    run_info_.bytes_read = data_mngr_->get_bytes_read();
+    run_info_.bytes_written = data_mngr_->get_bytes_written();
+    run_info_.supersteps = this->global_superstep_->load();
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+      run_info_.peak_rss = usage.ru_maxrss;
+    if (trace_pt_ != "") utility::Tracer::Get().WriteChromeTrace(trace_pt_);
+    if (metrics_pt_ != "") {
+      utility::Metrics::Get().StopDump();
+      utility::Metrics::Get().LogSummary();
+    }
     this->Stop();
     return true;
   }
 
+  const RunInfo& get_run_info() const { return run_info_; }
+
+  // Record spans of the pipeline during RunSys(), and write them to pt as a
+  // Chrome trace at its end.
+  void EnableTrace(const std::string& pt) {
+    trace_pt_ = pt;
+    utility::Tracer::Get().Enable();
+  }
+
+  // Record metrics during RunSys(), dumped to pt in the Prometheus text
+  // format every interval seconds and at its end.
+  void EnableMetrics(const std::string& pt, const size_t interval = 10) {
+    metrics_pt_ = pt;
+    metrics_interval_ = interval;
+    utility::Metrics::Get().Enable();
+  }
+
+  // Write the RunInfo of the last RunSys() as a one line json object, read
+  // back by the benchmark tool.
+  bool WriteRunInfo(const std::string& pt) const {
+    std::ofstream fout(pt);
+    if (!fout) {
+      XLOG(ERR, "Write file fault: ", pt);
+      return false;
+    }
+    fout << "{\"elapsed_time\": " << run_info_.elapsed_time
+         << ", \"read_time\": " << run_info_.read_time
+         << ", \"peval_time\": " << run_info_.peval_time
+         << ", \"inc_eval_time\": " << run_info_.inc_eval_time
+         << ", \"write_time\": " << run_info_.write_time
+         << ", \"bytes_read\": " << run_info_.bytes_read
+         << ", \"bytes_written\": " << run_info_.bytes_written
+         << ", \"supersteps\": " << run_info_.supersteps
+         << ", \"peak_rss\": " << run_info_.peak_rss << "}" << std::endl;
+    return true;
+  }
+
  private:
+  std::string work_space_;
+  RunInfo run_info_;
+  std::string trace_pt_;
+  std::string metrics_pt_;
+  size_t metrics_interval_ = 10;
+
   // file path by gid.
   // folly::AtomicHashMap<GID_T, Path>* pt_by_gid_ = nullptr;
   std::unique_ptr<std::unordered_map<GID_T, Path>> pt_by_gid_ = nullptr;
@@ -228,14 +278,11 @@ class MiniGraphSys {
   // load semaphore
   std::unique_ptr<folly::NativeSemaphore> load_sem_;
 
-  // task queue.
-  std::unique_ptr<folly::ProducerConsumerQueue<GID_T>> task_queue_ = nullptr;
-
   // read trigger queue.
   std::unique_ptr<std::queue<GID_T>> read_trigger_ = nullptr;
 
-  // partial result queue.
-  std::unique_ptr<std::queue<GID_T>> partial_result_queue_ = nullptr;
+  // stage of DC.
+  std::unique_ptr<components::Stage<GID_T>> discharge_stage_ = nullptr;
 
   // components.
   std::unique_ptr<components::LoadComponent<GRAPH_T>> load_component_ = nullptr;
@@ -253,14 +300,7 @@ class MiniGraphSys {
   std::unique_ptr<message::DefaultMessageManager<GRAPH_T>> msg_mngr_ = nullptr;
 
   std::unique_ptr<std::mutex> read_trigger_mtx_ = nullptr;
-  std::unique_ptr<std::mutex> task_queue_mtx_ = nullptr;
-  std::unique_ptr<std::mutex> partial_result_mtx_ = nullptr;
-  std::unique_ptr<std::unique_lock<std::mutex>> read_trigger_lck_ = nullptr;
-  std::unique_ptr<std::unique_lock<std::mutex>> task_queue_lck_ = nullptr;
-  std::unique_ptr<std::unique_lock<std::mutex>> partial_result_lck_ = nullptr;
   std::unique_ptr<std::condition_variable> read_trigger_cv_ = nullptr;
-  std::unique_ptr<std::condition_variable> task_queue_cv_ = nullptr;
-  std::unique_ptr<std::condition_variable> partial_result_cv_ = nullptr;
 
   // system switch
   std::unique_ptr<std::atomic<bool>> system_switch_ = nullptr;
@@ -103,6 +103,11 @@ struct StatisticInfo {
   size_t current_iter = 0;
   size_t sum_active_out_border_vertexes = 0;
   size_t sum_active_in_border_vertexes = 0;
+  // Evaluations of fragments this one depends on that changed something
+  // since its own last evaluation.
+  size_t num_incoming_messages = 0;
+  // Magnitude of these updates, e.g. the sum of deltas for PageRank.
+  double pending_updates = 0;
   size_t sum_out_border_vertexes = 0;
   size_t sum_in_border_vertexes = 0;
   size_t sum_dlv_times_dgv = 0;
@@ -136,6 +141,31 @@ struct StatisticInfo {
 
 };
 
+// SuperstepInfo records one PEval (inc_type = 0) or IncEval (inc_type = 1) of
+// a fragment during a run, and whether it changed the fragment.
+struct SuperstepInfo {
+  size_t gid = 0;
+  size_t superstep = 0;
+  size_t inc_type = 0;
+  bool changed = false;
+  float elapsed_time = 0;
+};
+
+// RunInfo summarizes a run of MiniGraphSys for benchmarking. Times are in
+// seconds; read, PEval, IncEval and write times are summed over threads.
+struct RunInfo {
+  double elapsed_time = 0;
+  double read_time = 0;
+  double peval_time = 0;
+  double inc_eval_time = 0;
+  double write_time = 0;
+  size_t bytes_read = 0;
+  size_t bytes_written = 0;
+  size_t supersteps = 0;
+  // Peak resident set size in KB.
+  size_t peak_rss = 0;
+};
+
 inline std::pair<vid_t, vid_t> SplitEdge(const std::string& str,
                                          char* pattern) {
   char* strc = new char[strlen(str.c_str()) + 1];
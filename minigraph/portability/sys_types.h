@@ -75,15 +75,68 @@ DEFINE_uint64(cc, 1, "the number of executors in ComputingComponent");
 DEFINE_uint64(dc, 1, "the number of executors in DischargeComponent");
 DEFINE_uint64(cores, 4, "the number of cores we used");
 DEFINE_uint64(buffer_size, 1, "buffer size");
+DEFINE_uint64(mem_budget, 0,
+              "memory budget in MB for out-of-core partitioning, 0 means the "
+              "whole graph is partitioned in memory, or 1024 MB for ldg and "
+              "fennel, which always stream edges from disk");
+DEFINE_string(reorder, "",
+              "relabel vertexes before partitioning, include degree, rcm, "
+              "gorder");
+DEFINE_double(hdrf_lambda, 1.0,
+              "weight of balance against replication in the hdrf partitioner");
+DEFINE_string(cost_model, "",
+              "comma separated training data the costbalanced partitioner "
+              "fits its cost model on");
+DEFINE_double(load_bandwidth, 1024,
+              "bandwidth in MB/s the costbalanced partitioner assumes for "
+              "loading fragments");
+DEFINE_double(hot_ratio, 2.0,
+              "fragments taking more than hot_ratio times the mean time are "
+              "split by graph_repartition");
+DEFINE_uint64(cold_supersteps, 1,
+              "fragments changing in at most cold_supersteps supersteps are "
+              "merged by graph_repartition");
+DEFINE_uint64(seed, 0, "seed of the graph generator");
+DEFINE_bool(scramble, false, "scramble vids of generated graphs");
+DEFINE_uint64(max_weight, 0,
+              "generate edge weights in [1, max_weight], none if 0");
+DEFINE_uint64(shards, 1, "the number of files a generated graph is split in");
+DEFINE_string(bench_out, "",
+              "file the results of a run, or of the benchmark, are written to");
+DEFINE_string(bench_format, "csv", "format of benchmark results, csv or json");
+DEFINE_string(bench_apps, "wcc_vc_stream", "comma separated apps to benchmark");
+DEFINE_string(bench_graphs, "",
+              "comma separated graphs to benchmark, edge lists in csv or "
+              "workspaces ending with '/'");
+DEFINE_string(bench_partitioners, "edgecut",
+              "comma separated partitioners to benchmark");
+DEFINE_string(bench_schedulers, "FIFO",
+              "comma separated schedulers to benchmark");
+DEFINE_string(bench_cores, "4",
+              "comma separated numbers of cores to benchmark");
+DEFINE_string(bench_buffer_sizes, "1",
+              "comma separated buffer sizes to benchmark");
+DEFINE_uint64(bench_repeats, 3, "number of runs of each benchmark setting");
+DEFINE_string(bin_dir, "./bin/", "directory of the MiniGraph executables");
+DEFINE_string(trace, "", "file a Chrome trace of the run is written to");
+DEFINE_string(metrics_out, "",
+              "file metrics of the run are dumped to in the Prometheus text "
+              "format");
+DEFINE_uint64(metrics_interval, 10, "seconds between two dumps of metrics");
 DEFINE_uint64(niters, 50, "number of iterations for graph-level while loop");
 DEFINE_uint64(walks_per_source, 5, "walks per source vertex for random walk");
 DEFINE_uint64(inner_niters, 4, "number of iterations for inner while loop");
 DEFINE_string(init_model, "val", "init model for vdata of all vertexes");
-DEFINE_string(mode, "default", "MiniGraph with entire optimization");
+DEFINE_string(mode, "default",
+              "MiniGraph with entire optimization, NoShort without shortcuts, "
+              "or Async to trigger fragments on messages, without supersteps");
 DEFINE_string(partitioner, "edgecut",
-              "graph partition solutions include vertexcut, edgecut");
+              "graph partition solutions include vertexcut, edgecut, "
+              "hybridcut, 2dvc, ldg, fennel, hdrf, multilevel, "
+              "costbalanced");
 DEFINE_string(scheduler, "FIFO",
-              "subgraphs scheduler include FIFO, hash, learned_model");
+              "subgraphs scheduler include FIFO, hash, large_first, "
+              "small_first, learned, priority, locality");
 DEFINE_uint64(init_val, 0, "init value for vdata of all vertexes");
 DEFINE_uint64(walsk_per_source, 1, "walks per vertex for random walks application.");
 DEFINE_uint64(root, 0, "the id of root vertex");
@@ -0,0 +1,74 @@
+#ifndef MINIGRAPH_SUBGRAPH_LEARNED_SCHEDULER_H
+#define MINIGRAPH_SUBGRAPH_LEARNED_SCHEDULER_H
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "portability/sys_data_structure.h"
+#include "scheduler/subgraph_scheduler_base.h"
+#include "utility/cost_model.h"
+#include "utility/logging.h"
+
+namespace minigraph {
+namespace scheduler {
+
+// LearnedScheduler picks the pending fragment with the most benefit per unit
+// of cost. The benefit of a fragment is its active vertexes plus incoming
+// messages, as published by CC after each PEval / IncEval, or all its
+// vertexes before its first evaluation. The cost is the time the
+// CostModel, trained offline by train_cost_model, predicts for a PEval /
+// IncEval on it. Fragments that make the most progress cheaply go first, so
+// their updates reach the others before those are loaded.
+template <typename GID_T>
+class LearnedScheduler : public SubGraphsSchedulerBase<GID_T> {
+ private:
+  StatisticInfo* si_ = nullptr;
+  utility::CostModel cost_model_;
+
+ public:
+  LearnedScheduler(
+      StatisticInfo* si = nullptr,
+      const utility::CostModel& cost_model = utility::CostModel()) {
+    assert(si != nullptr);
+    LOG_INFO("Init learned scheduler.");
+    si_ = si;
+    cost_model_ = cost_model;
+  };
+
+  ~LearnedScheduler() = default;
+
+  size_t ChooseOne(std::vector<GID_T>& vec_gid) {
+    GID_T gid = GID_MAX;
+    double rank_max = -1;
+    size_t index = 0;
+    for (size_t i = 0; i < vec_gid.size(); ++i) {
+      double rank = Rank(si_[vec_gid.at(i)]);
+      if (rank > rank_max) {
+        rank_max = rank;
+        index = i;
+        gid = vec_gid.at(i);
+      }
+    }
+
+    vec_gid.erase(vec_gid.begin() + index);
+    return gid;
+  };
+
+  double Rank(const StatisticInfo& si) const {
+    // elapsed_time is set by the first evaluation.
+    double benefit = si.elapsed_time > 0
+                         ? si.num_active_vertexes + si.num_incoming_messages
+                         : si.num_vertexes;
+    // The next evaluation is an IncEval once the first one is done.
+    StatisticInfo next = si;
+    next.inc_type = si.elapsed_time > 0;
+    // Floor the cost, so that fragments predicted free do not tie at inf.
+    return benefit / std::max(cost_model_.Predict(next), 1e-9);
+  }
+};
+
+}  // namespace scheduler
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_SUBGRAPH_LEARNED_SCHEDULER_H
@@ -0,0 +1,84 @@
+#ifndef MINIGRAPH_SUBGRAPH_LOCALITY_SCHEDULER_H
+#define MINIGRAPH_SUBGRAPH_LOCALITY_SCHEDULER_H
+
+#include <cassert>
+#include <vector>
+
+#include "scheduler/subgraph_scheduler_base.h"
+#include "utility/logging.h"
+
+namespace minigraph {
+namespace scheduler {
+
+// LocalityScheduler orders fragments along the flow of messages, so that
+// within a superstep producers run before their consumers, whose updates
+// then propagate further per round. communication_matrix[x * n + y] is set
+// if x depends on y, i.e. consumes the messages of y. The order is a
+// topological order of this graph, where cycles are broken by placing the
+// fragment with the fewest producers left, preferring consumers of the last
+// placed fragment, as a BFS would, and then smaller gids. ChooseOne() picks
+// the pending fragment that comes first in this order.
+template <typename GID_T>
+class LocalityScheduler : public SubGraphsSchedulerBase<GID_T> {
+ private:
+  std::vector<size_t> rank_;
+
+ public:
+  LocalityScheduler(const bool* communication_matrix = nullptr,
+                    const size_t num_graphs = 0) {
+    assert(communication_matrix != nullptr);
+    LOG_INFO("Init locality scheduler.");
+    rank_ = Order(communication_matrix, num_graphs);
+  };
+
+  ~LocalityScheduler() = default;
+
+  size_t ChooseOne(std::vector<GID_T>& vec_gid) {
+    size_t index = 0;
+    for (size_t i = 1; i < vec_gid.size(); ++i)
+      if (GetRank(vec_gid.at(i)) < GetRank(vec_gid.at(index))) index = i;
+    GID_T gid = vec_gid.at(index);
+    vec_gid.erase(vec_gid.begin() + index);
+    return gid;
+  };
+
+  size_t GetRank(const GID_T gid) const {
+    return gid < rank_.size() ? rank_[gid] : rank_.size() + gid;
+  }
+
+ private:
+  // Rank of each fragment in the order.
+  static std::vector<size_t> Order(const bool* communication_matrix,
+                                   const size_t n) {
+    auto depends = [&](size_t x, size_t y) {
+      return x != y && communication_matrix[x * n + y];
+    };
+    std::vector<size_t> num_producers(n, 0);
+    for (size_t x = 0; x < n; x++)
+      for (size_t y = 0; y < n; y++)
+        if (depends(x, y)) num_producers[x]++;
+
+    std::vector<size_t> rank(n, n);
+    size_t last = n;
+    for (size_t r = 0; r < n; r++) {
+      size_t best = n;
+      for (size_t x = 0; x < n; x++) {
+        if (rank[x] != n) continue;
+        if (best == n || num_producers[x] < num_producers[best] ||
+            (num_producers[x] == num_producers[best] && last != n &&
+             depends(x, last) && !depends(best, last)))
+          best = x;
+      }
+      rank[best] = r;
+      last = best;
+      for (size_t x = 0; x < n; x++)
+        if (rank[x] == n && depends(x, best)) num_producers[x]--;
+    }
+    return rank;
+  }
+};
+
+}  // namespace scheduler
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_SUBGRAPH_LOCALITY_SCHEDULER_H
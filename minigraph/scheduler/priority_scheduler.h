@@ -0,0 +1,55 @@
+#ifndef MINIGRAPH_SUBGRAPH_PRIORITY_SCHEDULER_H
+#define MINIGRAPH_SUBGRAPH_PRIORITY_SCHEDULER_H
+
+#include <cassert>
+#include <vector>
+
+#include "portability/sys_data_structure.h"
+#include "scheduler/subgraph_scheduler_base.h"
+#include "utility/logging.h"
+
+namespace minigraph {
+namespace scheduler {
+
+// PriorityScheduler picks the pending fragment with the largest magnitude of
+// pending updates, as accumulated by the message manager from the fragments
+// it depends on, and breaks ties by the number of incoming messages. Meant
+// for the Async mode, where fragments are triggered as soon as messages
+// reach them, as in Maiter / PrIter.
+template <typename GID_T>
+class PriorityScheduler : public SubGraphsSchedulerBase<GID_T> {
+ private:
+  StatisticInfo* si_ = nullptr;
+
+ public:
+  PriorityScheduler(StatisticInfo* si = nullptr) {
+    assert(si != nullptr);
+    LOG_INFO("Init priority scheduler.");
+    si_ = si;
+  };
+
+  ~PriorityScheduler() = default;
+
+  size_t ChooseOne(std::vector<GID_T>& vec_gid) {
+    GID_T gid = vec_gid.at(0);
+    size_t index = 0;
+    for (size_t i = 1; i < vec_gid.size(); ++i) {
+      auto& si = si_[vec_gid.at(i)];
+      auto& si_max = si_[gid];
+      if (si.pending_updates > si_max.pending_updates ||
+          (si.pending_updates == si_max.pending_updates &&
+           si.num_incoming_messages > si_max.num_incoming_messages)) {
+        index = i;
+        gid = vec_gid.at(i);
+      }
+    }
+
+    vec_gid.erase(vec_gid.begin() + index);
+    return gid;
+  };
+};
+
+}  // namespace scheduler
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_SUBGRAPH_PRIORITY_SCHEDULER_H
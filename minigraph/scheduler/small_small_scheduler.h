@@ -31,7 +31,7 @@ class LargeFirstScheduler : public SubGraphsSchedulerBase<GID_T> {
     double rank_max = 0;
     size_t index = 0;
     for (size_t i = 0; i < vec_gid.size(); ++i) {
-      auto si = si_[i];
+      auto& si = si_[vec_gid.at(i)];
       if (write_max(&rank_max, si.num_active_vertexes)) {
         index = i;
         gid = vec_gid.at(i);
@@ -0,0 +1,234 @@
+#include "2d_pie/auto_app_base.h"
+#include "2d_pie/auto_map.h"
+#include "executors/task_runner.h"
+#include "graphs/graph.h"
+#include "minigraph_sys.h"
+#include "portability/sys_data_structure.h"
+#include "portability/sys_types.h"
+#include "utility/bitmap.h"
+#include "utility/paritioner/edge_cut_partitioner.h"
+#include <filesystem>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+
+using CSR_T = graphs::ImmutableCSR<gid_t, vid_t, vdata_t, edata_t>;
+using EDGE_LIST_T = graphs::EdgeList<gid_t, vid_t, vdata_t, edata_t>;
+
+// A ring 0 -> 1 -> ... -> 11 -> 0, and chords 0 -> 6, 3 -> 9.
+static const vid_t kEdges[] = {0, 1, 1, 2, 2,  3,  3,  4, 4, 5, 5, 6,
+                               6, 7, 7, 8, 8,  9,  9,  10, 10, 11, 11, 0,
+                               0, 6, 3, 9};
+static const size_t kNumEdges = 14;
+static const size_t kNumVertexes = 12;
+static const vid_t kMaxVid = 11;
+static const std::string kWorkSpace = "/tmp/minigraph_async_test/";
+
+struct Context {
+  vid_t root_id = 0;
+};
+
+// Hops from the root, kept in the global vdata of the message manager, as
+// sssp_vc_stream.
+template <typename GRAPH_T, typename CONTEXT_T>
+class HopAutoMap : public AutoMapBase<GRAPH_T, CONTEXT_T> {
+  using VID_T = typename GRAPH_T::vid_t;
+  using VDATA_T = typename GRAPH_T::vdata_t;
+  using VertexInfo = graphs::VertexInfo<typename GRAPH_T::vid_t,
+                                        typename GRAPH_T::vdata_t,
+                                        typename GRAPH_T::edata_t>;
+
+ public:
+  bool F(const VertexInfo& u, VertexInfo& v,
+         GRAPH_T* graph = nullptr) override {
+    return false;
+  }
+
+  bool F(VertexInfo& u, GRAPH_T* graph = nullptr,
+         VID_T* vid_map = nullptr) override {
+    return false;
+  }
+
+  static void kernel_update(GRAPH_T* graph, const size_t tid, Bitmap* visited,
+                            const size_t step, Bitmap* out_visited,
+                            VDATA_T* global_vdata, double* update_magnitude) {
+    double local_magnitude = 0;
+    for (size_t i = tid; i < graph->get_num_vertexes(); i += step) {
+      auto u = graph->GetVertexByIndex(i);
+      VDATA_T dist = global_vdata[graph->localid2globalid(i)];
+      if (dist == VDATA_MAX) continue;
+      for (size_t j = 0; j < u.outdegree; ++j) {
+        VDATA_T prev = global_vdata[u.out_edges[j]];
+        if (write_min(&global_vdata[u.out_edges[j]], dist + 1)) {
+          out_visited->set_bit(i);
+          visited->set_bit(i);
+          if (graph->IsInGraph(u.out_edges[j])) continue;
+          local_magnitude +=
+              prev == VDATA_MAX ? kMaxVid + 1 : (double)prev - dist - 1;
+        }
+      }
+    }
+    write_add(update_magnitude, local_magnitude);
+  }
+};
+
+template <typename GRAPH_T, typename CONTEXT_T>
+class HopPIE : public AutoAppBase<GRAPH_T, CONTEXT_T> {
+ public:
+  HopPIE(AutoMapBase<GRAPH_T, CONTEXT_T>* auto_map, const CONTEXT_T& context)
+      : AutoAppBase<GRAPH_T, CONTEXT_T>(auto_map, context) {}
+
+  bool Init(GRAPH_T& graph, executors::TaskRunner* task_runner) override {
+    return true;
+  }
+
+  bool PEval(GRAPH_T& graph, executors::TaskRunner* task_runner) override {
+    if (!graph.IsInGraph(this->context_.root_id)) return false;
+    this->msg_mngr_->GetGlobalVdata()[this->context_.root_id] = 0;
+    return Relax(graph, task_runner);
+  }
+
+  bool IncEval(GRAPH_T& graph, executors::TaskRunner* task_runner) override {
+    return Relax(graph, task_runner);
+  }
+
+  bool Aggregate(void* a, void* b,
+                 executors::TaskRunner* task_runner) override {
+    return false;
+  }
+
+ private:
+  bool Relax(GRAPH_T& graph, executors::TaskRunner* task_runner) {
+    Bitmap out_visited(graph.get_num_vertexes());
+    Bitmap visited(graph.get_num_vertexes());
+    visited.clear();
+    double update_magnitude = 0;
+    do {
+      out_visited.clear();
+      this->auto_map_->ActiveMap(
+          graph, task_runner, &visited,
+          HopAutoMap<GRAPH_T, CONTEXT_T>::kernel_update, &out_visited,
+          this->msg_mngr_->GetGlobalVdata(), &update_magnitude);
+    } while (!out_visited.empty());
+    ThreadUpdateMagnitude() = update_magnitude;
+    return !visited.empty();
+  }
+};
+
+using HopPIE_T = HopPIE<CSR_T, Context>;
+
+class AsyncTest : public ::testing::Test {
+ protected:
+  // Partition kEdges into num_partitions fragments under work_space, as
+  // graph_partition does.
+  static void WriteWorkSpace(const std::string& work_space,
+                             const size_t num_partitions) {
+    std::filesystem::remove_all(work_space);
+    for (auto dir : {"minigraph_meta", "minigraph_data", "minigraph_vdata",
+                     "minigraph_si", "minigraph_border_vertexes",
+                     "minigraph_message"})
+      std::filesystem::create_directories(work_space + dir);
+
+    auto edgelist_graph = new EDGE_LIST_T(0, kNumEdges, kNumVertexes, kMaxVid,
+                                          (vid_t*)kEdges);
+    utility::partitioner::EdgeCutPartitioner<CSR_T> partitioner;
+    partitioner.ParallelPartition(edgelist_graph, num_partitions, 1);
+    utility::io::DataMngr<CSR_T> data_mngr;
+    auto communication_matrix = partitioner.GetCommunicationMatrix();
+    data_mngr.WriteCommunicationMatrix(
+        work_space + "minigraph_border_vertexes/communication_matrix.bin",
+        communication_matrix.second, communication_matrix.first);
+    data_mngr.WriteVidMap(partitioner.GetMaxVid(), partitioner.GetVidMap(),
+                          work_space + "minigraph_message/vid_map.bin");
+    data_mngr.WriteBitmap(
+        partitioner.GetGlobalBorderVidMap(),
+        work_space + "minigraph_message/global_border_vid_map.bin");
+    auto fragments = partitioner.GetFragments();
+    for (size_t gid = 0; gid < fragments->size(); gid++) {
+      std::string name = std::to_string(gid) + ".bin";
+      data_mngr.csr_io_adapter_->Write(
+          *(CSR_T*)fragments->at(gid), csr_bin, false,
+          work_space + "minigraph_meta/" + name,
+          work_space + "minigraph_data/" + name,
+          work_space + "minigraph_vdata/" + name);
+      delete (CSR_T*)fragments->at(gid);
+    }
+  }
+
+  // Hops from root by a BFS over kEdges.
+  static std::vector<vdata_t> ExpectedHops(const vid_t root) {
+    std::vector<vdata_t> hops(kMaxVid + 1, VDATA_MAX);
+    std::queue<vid_t> frontier;
+    hops[root] = 0;
+    frontier.push(root);
+    while (!frontier.empty()) {
+      vid_t u = frontier.front();
+      frontier.pop();
+      for (size_t i = 0; i < kNumEdges; i++) {
+        if (kEdges[i * 2] != u || hops[kEdges[i * 2 + 1]] != VDATA_MAX)
+          continue;
+        hops[kEdges[i * 2 + 1]] = hops[u] + 1;
+        frontier.push(kEdges[i * 2 + 1]);
+      }
+    }
+    return hops;
+  }
+
+  // HopPIE on work_space in mode, with fewer buffers than fragments so that
+  // fragments are written back and read again. RunSys() tears the
+  // components down, as the apps exit right after it, hence the system is
+  // not deleted.
+  MiniGraphSys<CSR_T, HopPIE_T>* MakeSys(const std::string& work_space,
+                                         const std::string& mode,
+                                         const std::string& scheduler) {
+    Context context;
+    auto auto_map = new HopAutoMap<CSR_T, Context>();
+    pie_ = new HopPIE_T(auto_map, context);
+    auto app_wrapper = new AppWrapper<HopPIE_T, CSR_T>(pie_);
+    return new MiniGraphSys<CSR_T, HopPIE_T>(work_space, 1, 1, 1, 2, 2,
+                                             app_wrapper, mode, kNumIter,
+                                             scheduler);
+  }
+
+  std::vector<vdata_t> Hops() const {
+    vdata_t* global_vdata = pie_->msg_mngr_->GetGlobalVdata();
+    return std::vector<vdata_t>(global_vdata, global_vdata + kMaxVid + 1);
+  }
+
+  static constexpr size_t kNumPartitions = 3;
+  static constexpr size_t kNumIter = 30;
+
+  HopPIE_T* pie_ = nullptr;
+};
+
+TEST_F(AsyncTest, SameResultAsSync) {
+  WriteWorkSpace(kWorkSpace + "sync/", kNumPartitions);
+  ASSERT_TRUE(MakeSys(kWorkSpace + "sync/", "Default", "FIFO")->RunSys());
+  auto sync_hops = Hops();
+
+  WriteWorkSpace(kWorkSpace + "async/", kNumPartitions);
+  ASSERT_TRUE(MakeSys(kWorkSpace + "async/", "Async", "priority")->RunSys());
+  auto async_hops = Hops();
+
+  EXPECT_EQ(sync_hops, ExpectedHops(0));
+  EXPECT_EQ(async_hops, sync_hops);
+}
+
+TEST_F(AsyncTest, ExitOnQuiescence) {
+  WriteWorkSpace(kWorkSpace + "quiescence/", kNumPartitions);
+  auto sys = MakeSys(kWorkSpace + "quiescence/", "Async", "priority");
+  // Async mode has no superstep barrier: RunSys() returns only once DC finds
+  // no fragment in flight.
+  ASSERT_TRUE(sys->RunSys());
+  // It stopped short of the bound on evaluations, with no message pending.
+  EXPECT_LT(sys->get_run_info().supersteps, kNumIter);
+  for (gid_t gid = 0; gid < kNumPartitions; gid++)
+    EXPECT_FALSE(pie_->msg_mngr_->HasIncomingMessages(gid)) << gid;
+  EXPECT_EQ(Hops(), ExpectedHops(0));
+}
+
+}  // namespace minigraph
@@ -0,0 +1,125 @@
+#include "utility/cost_model.h"
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+
+TEST(CostModelTest, FitRecoversWeights) {
+  // elapsed_time = 0.5 + 2e-3 * sum_dgv + 1e-6 * num_edges
+  std::vector<std::vector<double>> rows;
+  std::vector<double> ys;
+  for (size_t i = 1; i <= 32; i++) {
+    std::vector<double> row(CostModel::kNumFeatures, 0);
+    row[0] = i * 7 % 13;
+    row[1] = i * 100;
+    row[6] = (i * i) % 50 * 1000;
+    row[7] = i % 5;
+    rows.push_back(row);
+    ys.push_back(0.5 + 2e-3 * row[1] + 1e-6 * row[6]);
+  }
+  CostModel cost_model;
+  EXPECT_TRUE(cost_model.Fit(rows, ys));
+  EXPECT_NEAR(cost_model.get_intercept(), 0.5, 1e-6);
+  EXPECT_NEAR(cost_model.get_weight(1), 2e-3, 1e-8);
+  EXPECT_NEAR(cost_model.get_weight(6), 1e-6, 1e-10);
+
+  StatisticInfo si;
+  si.sum_dgv = 1000;
+  EXPECT_NEAR(cost_model.Predict(si), 2.5, 1e-4);
+}
+
+TEST(CostModelTest, NegativeWeightsAreDropped) {
+  // sum_dlv only lowers the cost, its weight is fixed at 0.
+  std::vector<std::vector<double>> rows;
+  std::vector<double> ys;
+  for (size_t i = 1; i <= 32; i++) {
+    std::vector<double> row(CostModel::kNumFeatures, 0);
+    row[0] = i % 7;
+    row[1] = i * 10;
+    rows.push_back(row);
+    ys.push_back(row[1] - 0.5 * row[0]);
+  }
+  CostModel cost_model;
+  EXPECT_TRUE(cost_model.Fit(rows, ys));
+  EXPECT_EQ(cost_model.get_weight(0), 0);
+  for (size_t i = 0; i < CostModel::kNumFeatures; i++)
+    EXPECT_GE(cost_model.get_weight(i), 0);
+}
+
+TEST(CostModelTest, FitOneModelPerIncType) {
+  // PEval: elapsed_time = 1 + 1e-3 * n_active_vertexes
+  // IncEval: elapsed_time = 0.1 + 0.5 * niters
+  std::vector<std::vector<double>> rows;
+  std::vector<double> ys;
+  std::vector<size_t> inc_types;
+  for (size_t i = 1; i <= 64; i++) {
+    std::vector<double> row(CostModel::kNumFeatures, 0);
+    row[6] = i * 37 % 101;
+    row[8] = i % 9;
+    row[9] = i * 13 % 97 * 100;
+    size_t inc_type = i % 2;
+    rows.push_back(row);
+    ys.push_back(inc_type ? 0.1 + 0.5 * row[8] : 1 + 1e-3 * row[9]);
+    inc_types.push_back(inc_type);
+  }
+  CostModel cost_model;
+  EXPECT_FALSE(cost_model.Fit(rows, ys, {0, 1}));
+  EXPECT_TRUE(cost_model.Fit(rows, ys, inc_types));
+  EXPECT_NEAR(cost_model.get_weight(9, 0), 1e-3, 1e-8);
+  EXPECT_NEAR(cost_model.get_weight(8, 1), 0.5, 1e-6);
+
+  StatisticInfo si;
+  si.num_iters = 4;
+  si.num_active_vertexes = 2000;
+  si.inc_type = 0;
+  EXPECT_NEAR(cost_model.Predict(si), 3, 1e-4);
+  si.num_active_vertexes = 4000;
+  EXPECT_NEAR(cost_model.Predict(si), 5, 1e-4);
+  si.inc_type = 1;
+  EXPECT_NEAR(cost_model.Predict(si), 2.1, 1e-4);
+  si.num_iters = 8;
+  EXPECT_NEAR(cost_model.Predict(si), 4.1, 1e-4);
+
+  EXPECT_TRUE(cost_model.Save("/tmp/minigraph_cost_model_test_inc.yaml"));
+  CostModel loaded;
+  EXPECT_TRUE(loaded.Load("/tmp/minigraph_cost_model_test_inc.yaml"));
+  EXPECT_NEAR(loaded.Predict(si), 4.1, 1e-4);
+  si.inc_type = 0;
+  EXPECT_NEAR(loaded.Predict(si), 5, 1e-4);
+}
+
+TEST(CostModelTest, TooFewTuples) {
+  CostModel cost_model;
+  std::vector<std::vector<double>> rows(
+      2, std::vector<double>(CostModel::kNumFeatures, 1));
+  EXPECT_FALSE(cost_model.Fit(rows, {1, 2}));
+  EXPECT_EQ(cost_model.get_weight(6), 1);
+}
+
+TEST(CostModelTest, SaveLoad) {
+  std::vector<std::vector<double>> rows;
+  std::vector<double> ys;
+  for (size_t i = 1; i <= 32; i++) {
+    std::vector<double> row(CostModel::kNumFeatures, 0);
+    row[1] = i * 100;
+    row[7] = i % 5;
+    rows.push_back(row);
+    ys.push_back(0.5 + 2e-3 * row[1] + 0.1 * row[7]);
+  }
+  CostModel cost_model;
+  EXPECT_TRUE(cost_model.Fit(rows, ys));
+  EXPECT_TRUE(cost_model.Save("/tmp/minigraph_cost_model_test.yaml"));
+
+  CostModel loaded;
+  EXPECT_TRUE(loaded.Load("/tmp/minigraph_cost_model_test.yaml"));
+  for (size_t t = 0; t < CostModel::kNumIncTypes; t++) {
+    EXPECT_NEAR(loaded.get_intercept(t), cost_model.get_intercept(t), 1e-9);
+    for (size_t i = 0; i < CostModel::kNumFeatures; i++)
+      EXPECT_NEAR(loaded.get_weight(i, t), cost_model.get_weight(i, t), 1e-12);
+  }
+  EXPECT_FALSE(loaded.Load("/tmp/minigraph_cost_model_test_missing.yaml"));
+}
+
+}  // namespace utility
+}  // namespace minigraph
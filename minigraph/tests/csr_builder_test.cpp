@@ -0,0 +1,90 @@
+#include "graphs/csr_builder.h"
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace graphs {
+
+using CSRBuilderT = CSRBuilder<unsigned, unsigned, unsigned, unsigned>;
+
+// 0 -> 1, 0 -> 2, 1 -> 2, 2 -> 0, 3 -> 3, 70 -> 1
+static const unsigned kEdges[] = {0, 1, 0, 2, 1, 2, 2, 0, 3, 3, 70, 1};
+
+TEST(CSRBuilderTest, BuildWholeGraph) {
+  for (size_t cores : {1, 3}) {
+    CSRBuilderT builder(kEdges, 6, 70, cores, true);
+    EXPECT_EQ(builder.get_num_vertexes(), 4);
+    EXPECT_EQ(builder.get_num_edges(), 5);
+    EXPECT_EQ(builder.get_indegree(1), 2);
+
+    unsigned vid_map[128] = {0};
+    auto graph = builder.Build(0, nullptr, vid_map);
+    EXPECT_EQ(graph->get_num_vertexes(), 4);
+    EXPECT_EQ(graph->sum_in_edges_, 5);
+    EXPECT_EQ(graph->sum_out_edges_, 5);
+    EXPECT_EQ(graph->globalid_by_index_[3], 70);
+    EXPECT_EQ(graph->localid_by_globalid_[70], 3);
+    EXPECT_EQ(vid_map[70], 3);
+    EXPECT_EQ(graph->outdegree_[0], 2);
+    EXPECT_EQ(graph->out_offset_[1], 2);
+    EXPECT_EQ(graph->out_edges_[graph->out_offset_[3]], 1);
+    EXPECT_EQ(graph->indegree_[1], 2);
+    EXPECT_EQ(graph->in_offset_[2], 3);
+    delete graph;
+  }
+}
+
+TEST(CSRBuilderTest, BuildFragment) {
+  CSRBuilderT builder(kEdges, 6, 70, 2);
+  Bitmap members(builder.get_aligned_max_vid());
+  members.clear();
+  members.set_bit(1);
+  members.set_bit(3);
+  auto graph = builder.Build(1, &members);
+  EXPECT_EQ(graph->get_num_vertexes(), 2);
+  EXPECT_EQ(graph->get_max_vid(), 3);
+  EXPECT_EQ(graph->sum_in_edges_, 3);
+  EXPECT_EQ(graph->sum_out_edges_, 2);
+  EXPECT_EQ(graph->out_edges_[0], 2);
+  EXPECT_EQ(graph->out_edges_[1], 3);
+  EXPECT_TRUE(graph->bitmap_->get_bit(3));
+  EXPECT_FALSE(graph->bitmap_->get_bit(0));
+  delete graph;
+}
+
+TEST(CSRBuilderTest, BuildWithAlignedMaxVid) {
+  // The largest vid is a multiple of 64, hence the last bit of the vid range.
+  static const unsigned kEdges64[] = {0, 64, 64, 1, 1, 0};
+  for (size_t cores : {1, 2}) {
+    CSRBuilderT builder(kEdges64, 3, 64, cores);
+    EXPECT_EQ(builder.get_num_vertexes(), 3);
+    EXPECT_GT(builder.get_aligned_max_vid(), 64);
+
+    unsigned vid_map[128] = {0};
+    auto graph = builder.Build(0, nullptr, vid_map);
+    EXPECT_EQ(graph->get_num_vertexes(), 3);
+    EXPECT_EQ(graph->get_max_vid(), 64);
+    EXPECT_EQ(graph->sum_in_edges_, 3);
+    EXPECT_EQ(graph->sum_out_edges_, 3);
+    EXPECT_EQ(graph->globalid_by_index_[2], 64);
+    EXPECT_EQ(graph->localid_by_globalid_[64], 2);
+    EXPECT_EQ(vid_map[64], 2);
+    EXPECT_TRUE(graph->bitmap_->get_bit(64));
+    EXPECT_EQ(graph->out_edges_[graph->out_offset_[2]], 1);
+    delete graph;
+  }
+}
+
+TEST(CSRBuilderTest, BuildSingleVertex) {
+  static const unsigned kSelfLoop[] = {0, 0};
+  CSRBuilderT builder(kSelfLoop, 1, 0);
+  auto graph = builder.Build(0);
+  EXPECT_EQ(graph->get_num_vertexes(), 1);
+  EXPECT_EQ(graph->sum_out_edges_, 1);
+  EXPECT_EQ(graph->globalid_by_index_[0], 0);
+  EXPECT_TRUE(graph->bitmap_->get_bit(0));
+  delete graph;
+}
+
+}  // namespace graphs
+}  // namespace minigraph
@@ -0,0 +1,69 @@
+#include "utility/io/csr_io_adapter.h"
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+namespace io {
+
+using CSR_T = graphs::ImmutableCSR<unsigned, unsigned, unsigned, unsigned>;
+using CSRBuilderT = graphs::CSRBuilder<unsigned, unsigned, unsigned, unsigned>;
+using CSRIOAdapterT = CSRIOAdapter<unsigned, unsigned, unsigned, unsigned>;
+
+// 0 -> 64, 64 -> 1, 1 -> 0. 64, the largest vid, is the first bit of its
+// word.
+static const unsigned kEdges[] = {0, 64, 64, 1, 1, 0};
+static const std::string kPrefix = "/tmp/minigraph_csr_io_adapter_test_";
+
+class CSRIOAdapterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    CSRBuilderT builder(kEdges, 3, 64);
+    auto graph = builder.Build(0);
+    ASSERT_TRUE(adapter_.Write(*graph, csr_bin, false, MetaPt(), DataPt(),
+                               VdataPt()));
+    delete graph;
+  }
+
+  std::string MetaPt() const { return kPrefix + "meta.bin"; }
+  std::string DataPt() const { return kPrefix + "data.bin"; }
+  std::string VdataPt() const { return kPrefix + "vdata.bin"; }
+
+  CSRIOAdapterT adapter_;
+};
+
+TEST_F(CSRIOAdapterTest, ReadBackMaxVid) {
+  CSR_T graph;
+  ASSERT_TRUE(adapter_.Read(&graph, csr_bin, 0, MetaPt(), DataPt(), VdataPt()));
+  EXPECT_EQ(graph.get_num_vertexes(), 3);
+  EXPECT_EQ(graph.get_max_vid(), 64);
+  EXPECT_EQ(graph.get_aligned_max_vid(), 128);
+  EXPECT_EQ(graph.globalid_by_index_[2], 64);
+  EXPECT_EQ(graph.localid_by_globalid_[64], 2);
+  EXPECT_EQ(graph.localid_by_globalid_[1], 1);
+  EXPECT_TRUE(graph.bitmap_->get_bit(64));
+}
+
+TEST_F(CSRIOAdapterTest, ReadWorkspaceWithoutEntryCount) {
+  // As written before the number of localid_by_globalid_ entries was kept
+  // in meta: ceil(max_vid / 64) * 64 of them.
+  ASSERT_EQ(truncate(MetaPt().c_str(), sizeof(size_t) * 3 + sizeof(unsigned)),
+            0);
+  size_t data_size = sizeof(unsigned) * 3 + sizeof(size_t) * 3 * 4 +
+                     sizeof(unsigned) * 6 + sizeof(unsigned) * 64;
+  ASSERT_EQ(truncate(DataPt().c_str(), data_size), 0);
+
+  CSR_T graph;
+  ASSERT_TRUE(adapter_.Read(&graph, csr_bin, 0, MetaPt(), DataPt(), VdataPt()));
+  EXPECT_EQ(graph.get_num_vertexes(), 3);
+  EXPECT_EQ(graph.get_aligned_max_vid(), 128);
+  EXPECT_EQ(graph.localid_by_globalid_[1], 1);
+  // Entries past the data are zeros.
+  EXPECT_EQ(graph.localid_by_globalid_[64], 0);
+}
+
+}  // namespace io
+}  // namespace utility
+}  // namespace minigraph
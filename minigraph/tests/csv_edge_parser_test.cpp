@@ -0,0 +1,91 @@
+#include "utility/io/csv_edge_parser.h"
+
+#include <gtest/gtest.h>
+
+#include <folly/experimental/TestUtil.h>
+#include <folly/FileUtil.h>
+
+namespace minigraph {
+namespace utility {
+namespace io {
+
+class CSVEdgeParserTest : public ::testing::Test {
+ protected:
+  folly::test::TemporaryFile file_;
+
+  void WriteContent(const std::string& content) {
+    folly::writeFull(file_.fd(), content.data(), content.size());
+  }
+};
+
+TEST_F(CSVEdgeParserTest, ParseInterleaved) {
+  WriteContent("# comment\n0,1\n 1 , 2\n\n2,0,0.5\n% comment\n3,4\r\n6,7");
+  for (size_t cores : {1, 2, 4, 16}) {
+    CSVEdgeParser<uint32_t> parser(file_.path().string(), cores);
+    ASSERT_TRUE(parser.Open());
+    size_t upper = parser.CountEdges();
+    EXPECT_EQ(upper, 8);
+    uint32_t buf[16];
+    uint32_t max_vid = 0;
+    size_t num_edges = 0;
+    EXPECT_TRUE(parser.Parse(buf, buf + 1, &num_edges, 2, &max_vid));
+    EXPECT_EQ(num_edges, 5);
+    EXPECT_EQ(max_vid, 7);
+    uint32_t expected[] = {0, 1, 1, 2, 2, 0, 3, 4, 6, 7};
+    for (size_t i = 0; i < 10; i++) EXPECT_EQ(buf[i], expected[i]);
+  }
+}
+
+TEST_F(CSVEdgeParserTest, ParseSeparatedAndSkipSelfLoops) {
+  WriteContent("1,1\n1,2\n2,2\n2,3\n");
+  CSVEdgeParser<uint32_t> parser(file_.path().string(), 3);
+  ASSERT_TRUE(parser.Open());
+  size_t upper = parser.CountEdges();
+  uint32_t src[4], dst[4];
+  ASSERT_EQ(upper, 4);
+  size_t num_edges = 0;
+  EXPECT_TRUE(parser.Parse(src, dst, &num_edges, 1, nullptr, true));
+  ASSERT_EQ(num_edges, 2);
+  EXPECT_EQ(src[0], 1);
+  EXPECT_EQ(dst[0], 2);
+  EXPECT_EQ(src[1], 2);
+  EXPECT_EQ(dst[1], 3);
+}
+
+TEST_F(CSVEdgeParserTest, ParseWithSeparator) {
+  WriteContent("0 1\n2  3 0.5\n\t4 5\n");
+  CSVEdgeParser<uint32_t> by_space(file_.path().string(), 1, ' ');
+  ASSERT_TRUE(by_space.Open());
+  uint32_t buf[8];
+  size_t num_edges = 0;
+  EXPECT_TRUE(by_space.Parse(buf, buf + 1, &num_edges));
+  EXPECT_EQ(num_edges, 3);
+  uint32_t expected[] = {0, 1, 2, 3, 4, 5};
+  for (size_t i = 0; i < 6; i++) EXPECT_EQ(buf[i], expected[i]);
+
+  // Spaces are no separator with ','.
+  CSVEdgeParser<uint32_t> by_comma(file_.path().string(), 1, ',');
+  ASSERT_TRUE(by_comma.Open());
+  EXPECT_FALSE(by_comma.Parse(buf, buf + 1, &num_edges));
+}
+
+TEST(CSVEdgeParserMalformedTest, RejectNonIntegerIds) {
+  for (std::string line :
+       {"1.5,2", "-3,2", "2,-3", "1,2.5", "a,2", "1;2", "5", "1,", "1,2x",
+        "1,4294967296"}) {
+    folly::test::TemporaryFile file;
+    std::string content = "0,1\n" + line + "\n2,3\n";
+    folly::writeFull(file.fd(), content.data(), content.size());
+    for (size_t cores : {1, 2}) {
+      CSVEdgeParser<uint32_t> parser(file.path().string(), cores);
+      ASSERT_TRUE(parser.Open());
+      uint32_t buf[8];
+      size_t num_edges = 0;
+      EXPECT_FALSE(parser.Parse(buf, buf + 1, &num_edges)) << line;
+    }
+  }
+}
+
+}  // namespace io
+}  // namespace utility
+}  // namespace minigraph
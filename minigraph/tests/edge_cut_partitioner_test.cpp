@@ -0,0 +1,66 @@
+#include "utility/paritioner/edge_cut_partitioner.h"
+
+#include <map>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+using CSR_T = graphs::ImmutableCSR<unsigned, unsigned, unsigned, unsigned>;
+using EDGE_LIST_T = graphs::EdgeList<unsigned, unsigned, unsigned, unsigned>;
+
+// A ring 0 -> 1 -> ... -> 9 -> 0, and a path 9 -> 64 -> 128 -> 0. 128, the
+// largest vid, is the first bit of its word.
+static const unsigned kEdges[] = {0, 1, 1, 2, 2,  3,  3,   4,   4, 5, 5, 6,
+                                  6, 7, 7, 8, 8,  9,  9,   0,   9, 64, 64,
+                                  128, 128, 0};
+static const size_t kNumEdges = 13;
+static const std::vector<unsigned> kVids = {0, 1, 2, 3,  4,  5,
+                                            6, 7, 8, 9, 64, 128};
+
+TEST(EdgeCutPartitionerTest, PartitionEveryVertexOnce) {
+  for (size_t num_partitions : {1, 2, 3}) {
+    for (size_t cores : {1, 2}) {
+      auto edgelist_graph = new EDGE_LIST_T(0, kNumEdges, kVids.size(), 128,
+                                            (unsigned*)kEdges);
+      EdgeCutPartitioner<CSR_T> partitioner;
+      partitioner.ParallelPartition(edgelist_graph, num_partitions, cores);
+      auto fragments = partitioner.GetFragments();
+      ASSERT_EQ(fragments->size(), num_partitions);
+
+      unsigned* vid_map = partitioner.GetVidMap();
+      std::map<unsigned, unsigned> owner;
+      size_t sum_out_edges = 0;
+      for (unsigned gid = 0; gid < fragments->size(); gid++) {
+        auto graph = (CSR_T*)fragments->at(gid);
+        for (size_t i = 0; i < graph->get_num_vertexes(); i++) {
+          unsigned vid = graph->globalid_by_index_[i];
+          EXPECT_TRUE(owner.emplace(vid, gid).second) << vid;
+          EXPECT_EQ(vid_map[vid], i) << vid;
+        }
+        sum_out_edges += graph->sum_out_edges_;
+      }
+      EXPECT_EQ(owner.size(), kVids.size());
+      EXPECT_EQ(owner.count(128), 1);
+      EXPECT_EQ(sum_out_edges, kNumEdges);
+
+      // Border bits mark the ends of the cut edges.
+      Bitmap* border = partitioner.GetGlobalBorderVidMap();
+      std::map<unsigned, bool> is_border;
+      for (size_t i = 0; i < kNumEdges; i++) {
+        unsigned src = kEdges[i * 2], dst = kEdges[i * 2 + 1];
+        if (owner[src] == owner[dst]) continue;
+        is_border[src] = is_border[dst] = true;
+      }
+      for (auto vid : kVids)
+        EXPECT_EQ(border->get_bit(vid) != 0, is_border[vid]) << vid;
+      for (auto fragment : *fragments) delete (CSR_T*)fragment;
+    }
+  }
+}
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
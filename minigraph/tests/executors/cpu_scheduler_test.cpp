@@ -21,6 +21,8 @@ class DummyTaskRunner : public TaskRunner {
   }
 
   void Run(Task&& task) override {
+    // Throttles may submit at the same time.
+    std::lock_guard<std::mutex> grd(mtx_);
     ts_.emplace_back(std::thread([t = std::move(task), this]{
       t();
       counter_++;
@@ -31,6 +33,7 @@ class DummyTaskRunner : public TaskRunner {
   }
 
   void Run(const std::vector<Task>& tasks, bool /*flag*/) override {
+    std::lock_guard<std::mutex> grd(mtx_);
     ts_.emplace_back(std::thread([&, this]{
       for (const auto& t : tasks) {
         t();
@@ -50,6 +53,7 @@ class DummyTaskRunner : public TaskRunner {
 
  private:
   std::atomic_int counter_;
+  std::mutex mtx_;
   std::list<std::thread> ts_;
 };
 
@@ -123,6 +127,82 @@ TEST_F(CPUSchedulerTest, SchedulerAllocateThreadsPreemptively) {
   t4.reset();
 }
 
+TEST_F(CPUSchedulerTest, RebalanceMovesThreadsToPendingPackages) {
+  auto t1 = scheduler_.AllocateNew(&factory_, {}, parallelism - 2);
+  auto t2 = scheduler_.AllocateNew(&factory_, {}, 2);
+  EXPECT_EQ(parallelism - 2, t1->GetParallelism());
+  EXPECT_EQ(2, t2->GetParallelism());
+
+  // t2 is left with all the work, while t1 is idle.
+  std::atomic_bool release(false);
+  std::vector<Task> tasks(parallelism * 4, [&] {
+    while (!release) std::this_thread::yield();
+  });
+  std::thread submitter([&] { t2->Run(tasks, false); });
+  while (t2->PendingPackages() == 0) std::this_thread::yield();
+
+  scheduler_.Rebalance();
+  EXPECT_EQ(1, t1->GetParallelism());
+  EXPECT_EQ(parallelism - 1, t2->GetParallelism());
+
+  release = true;
+  submitter.join();
+  EXPECT_EQ(0, t2->PendingPackages());
+
+  // Once t1 is gone, t2 gets all threads for its next batch.
+  t1.reset();
+  release = false;
+  std::thread next_submitter([&] { t2->Run(tasks, false); });
+  while (t2->PendingPackages() == 0) std::this_thread::yield();
+  scheduler_.Rebalance();
+  EXPECT_EQ(parallelism, t2->GetParallelism());
+  release = true;
+  next_submitter.join();
+}
+
+TEST_F(CPUSchedulerTest, RebalanceFollowsPriorityAndExpectedWork) {
+  // t1 expects three times the work of t2, while t3 has twice the priority
+  // of t4, yet no estimate.
+  auto t1 = scheduler_.AllocateNew(&factory_, {1, 1, 300}, 1);
+  auto t2 = scheduler_.AllocateNew(&factory_, {1, 1, 100}, 1);
+  EXPECT_EQ(1, t1->GetParallelism());
+  EXPECT_EQ(1, t2->GetParallelism());
+
+  std::atomic_bool release(false);
+  std::vector<Task> tasks(parallelism * 4, [&] {
+    while (!release) std::this_thread::yield();
+  });
+  auto run = [&](Throttle* t) {
+    std::thread submitter([&, t] { t->Run(tasks, false); });
+    while (t->PendingPackages() == 0) std::this_thread::yield();
+    return submitter;
+  };
+
+  std::thread s1 = run(t1.get());
+  std::thread s2 = run(t2.get());
+  scheduler_.Rebalance();
+  // 4.5 and 1.5 threads, rounded along the critical path.
+  EXPECT_EQ(5, t1->GetParallelism());
+  EXPECT_EQ(1, t2->GetParallelism());
+  release = true;
+  s1.join();
+  s2.join();
+  t1.reset();
+  t2.reset();
+
+  auto t3 = scheduler_.AllocateNew(&factory_, {2, 1}, 1);
+  auto t4 = scheduler_.AllocateNew(&factory_, {1, 1}, 1);
+  release = false;
+  std::thread s3 = run(t3.get());
+  std::thread s4 = run(t4.get());
+  scheduler_.Rebalance();
+  EXPECT_EQ(4, t3->GetParallelism());
+  EXPECT_EQ(2, t4->GetParallelism());
+  release = true;
+  s3.join();
+  s4.join();
+}
+
 TEST_F(CPUSchedulerTest, RemovingAThrottleNotManagedTriggersErrorLogging) {
   using ::testing::internal::CaptureStderr;
   using ::testing::internal::GetCapturedStderr;
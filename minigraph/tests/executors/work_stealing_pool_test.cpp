@@ -0,0 +1,61 @@
+#include "executors/work_stealing_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "executors/latch.h"
+
+
+namespace minigraph {
+namespace executors {
+
+#define NUM_THREADS 4
+#define TOTAL_TASKS 1000
+
+TEST(WorkStealingPoolTest, RunsAllTasksOfBatch) {
+  WorkStealingPool pool(NUM_THREADS);
+  EXPECT_EQ(NUM_THREADS, pool.GetParallelism());
+  std::atomic<int> counter(0);
+  Latch latch(TOTAL_TASKS);
+  std::vector<Task> tasks(TOTAL_TASKS, [&] {
+    counter++;
+    latch.CountDown();
+  });
+  pool.Run(tasks, false);
+  latch.Wait();
+  EXPECT_EQ(TOTAL_TASKS, counter.load());
+}
+
+TEST(WorkStealingPoolTest, IdleWorkersStealTasks) {
+  WorkStealingPool pool(NUM_THREADS);
+  std::atomic<int> counter(0);
+  Latch latch(TOTAL_TASKS);
+  // All tasks go to the deque of one worker, and the others steal them.
+  pool.Run(
+      [&] {
+        std::vector<Task> tasks(TOTAL_TASKS, [&] {
+          std::this_thread::sleep_for(std::chrono::microseconds(10));
+          counter++;
+          latch.CountDown();
+        });
+        pool.Run(tasks, false);
+      },
+      false);
+  latch.Wait();
+  EXPECT_EQ(TOTAL_TASKS, counter.load());
+}
+
+TEST(WorkStealingPoolTest, RunsTasksLeftOnStop) {
+  std::atomic<int> counter(0);
+  {
+    WorkStealingPool pool(NUM_THREADS);
+    for (int i = 0; i < TOTAL_TASKS; i++) pool.Run([&] { counter++; }, false);
+    pool.StopAndJoin();
+  }
+  EXPECT_EQ(TOTAL_TASKS, counter.load());
+}
+
+}  // namespace executors
+}  // namespace minigraph
@@ -0,0 +1,160 @@
+#include "utility/io/external_csr_builder.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <folly/experimental/TestUtil.h>
+
+#include "graphs/csr_builder.h"
+#include "utility/io/csr_io_adapter.h"
+
+namespace minigraph {
+namespace utility {
+namespace io {
+
+using CSR_T = graphs::ImmutableCSR<unsigned, unsigned, unsigned, unsigned>;
+using CSRBuilderT = graphs::CSRBuilder<unsigned, unsigned, unsigned, unsigned>;
+using CSRIOAdapterT = CSRIOAdapter<unsigned, unsigned, unsigned, unsigned>;
+using ExternalCSRBuilderT =
+    ExternalCSRBuilder<unsigned, unsigned, unsigned, unsigned>;
+
+class ExternalCSRBuilderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    work_space_ = tmp_dir_.path().string() + "/";
+    for (auto dir : {"minigraph_meta", "minigraph_data", "minigraph_vdata",
+                     "minigraph_si", "minigraph_border_vertexes",
+                     "minigraph_message"})
+      std::filesystem::create_directories(work_space_ + dir);
+  }
+
+  // Edges without self loops or duplicates over 0..max_vid, where vids
+  // ending in 3 are left out, and max_vid has an in and an out edge.
+  static std::vector<unsigned> MakeEdges(const unsigned max_vid) {
+    std::set<std::pair<unsigned, unsigned>> edges;
+    auto add = [&](unsigned src, unsigned dst) {
+      if (src == dst || src % 10 == 3 || dst % 10 == 3) return;
+      edges.emplace(src, dst);
+    };
+    for (unsigned vid = 0; vid <= max_vid; vid++) {
+      add(vid, (vid + 1) % (max_vid + 1));
+      add(vid, (vid * 7 + 1) % (max_vid + 1));
+      add(vid, (vid * 13 + 5) % (max_vid + 1));
+    }
+    add(max_vid, 0);
+    add(1, max_vid);
+    std::vector<unsigned> buf;
+    for (auto& edge : edges) {
+      buf.push_back(edge.first);
+      buf.push_back(edge.second);
+    }
+    return buf;
+  }
+
+  // Write edges in edgelist_bin format at work_space_ + "input_".
+  std::string WriteEdgeListBin(const std::vector<unsigned>& edges,
+                               const unsigned max_vid) {
+    std::string prefix = work_space_ + "input_";
+    size_t meta[2] = {(size_t)max_vid + 1, edges.size() / 2};
+    std::ofstream meta_file(prefix + "minigraph_meta.bin", std::ios::binary);
+    meta_file.write((char*)meta, sizeof(meta));
+    meta_file.write((char*)&max_vid, sizeof(unsigned));
+    meta_file.close();
+    std::ofstream data_file(prefix + "minigraph_data.bin", std::ios::binary);
+    data_file.write((char*)edges.data(), sizeof(unsigned) * edges.size());
+    data_file.close();
+    return prefix;
+  }
+
+  static std::vector<unsigned> Sorted(const unsigned* begin, size_t n) {
+    std::vector<unsigned> nbrs(begin, begin + n);
+    std::sort(nbrs.begin(), nbrs.end());
+    return nbrs;
+  }
+
+  // Compare fragment gid read back from work_space_ against the one
+  // CSRBuilder cuts out of the same edges, with members assigned to
+  // fragments as EdgeCutPartitioner does.
+  void ExpectSameFragment(CSRBuilderT& builder, const unsigned gid,
+                          const size_t num_partitions) {
+    size_t step = ceil((double)builder.get_num_vertexes() / num_partitions);
+    Bitmap members(builder.get_aligned_max_vid());
+    members.clear();
+    for (size_t vid = 0; vid <= builder.get_max_vid(); vid++)
+      if (builder.GetVertexIndicator()->get_bit(vid) &&
+          (vid / step) % num_partitions == gid)
+        members.set_bit(vid);
+    auto expected = builder.Build(gid, &members);
+
+    std::string name = std::to_string(gid) + ".bin";
+    CSR_T graph;
+    CSRIOAdapterT adapter;
+    ASSERT_TRUE(adapter.Read(&graph, csr_bin, gid,
+                             work_space_ + "minigraph_meta/" + name,
+                             work_space_ + "minigraph_data/" + name,
+                             work_space_ + "minigraph_vdata/" + name));
+    ASSERT_EQ(graph.get_num_vertexes(), expected->get_num_vertexes());
+    EXPECT_EQ(graph.get_max_vid(), expected->get_max_vid());
+    EXPECT_EQ(graph.get_aligned_max_vid(), expected->get_aligned_max_vid());
+    EXPECT_EQ(graph.sum_in_edges_, expected->sum_in_edges_);
+    EXPECT_EQ(graph.sum_out_edges_, expected->sum_out_edges_);
+    for (size_t i = 0; i < graph.get_num_vertexes(); i++) {
+      unsigned vid = graph.globalid_by_index_[i];
+      ASSERT_EQ(vid, expected->globalid_by_index_[i]) << i;
+      EXPECT_EQ(graph.localid_by_globalid_[vid], i) << vid;
+      ASSERT_EQ(graph.indegree_[i], expected->indegree_[i]) << vid;
+      ASSERT_EQ(graph.outdegree_[i], expected->outdegree_[i]) << vid;
+      EXPECT_EQ(Sorted(graph.in_edges_ + graph.in_offset_[i],
+                       graph.indegree_[i]),
+                Sorted(expected->in_edges_ + expected->in_offset_[i],
+                       expected->indegree_[i]))
+          << vid;
+      EXPECT_EQ(Sorted(graph.out_edges_ + graph.out_offset_[i],
+                       graph.outdegree_[i]),
+                Sorted(expected->out_edges_ + expected->out_offset_[i],
+                       expected->outdegree_[i]))
+          << vid;
+    }
+    delete expected;
+  }
+
+  folly::test::TemporaryDirectory tmp_dir_;
+  std::string work_space_;
+};
+
+TEST_F(ExternalCSRBuilderTest, SameFragmentsAsCSRBuilder) {
+  // 1280 is the first bit of its word, 1279 the last one of the previous.
+  for (unsigned max_vid : {1279, 1280}) {
+    auto edges = MakeEdges(max_vid);
+    // Blocks hold 1024 edges for a mem_budget of 1 byte, hence three runs
+    // at least.
+    ASSERT_GT(edges.size() / 2, 2 * 1024);
+    auto src_pt = WriteEdgeListBin(edges, max_vid);
+    CSRBuilderT builder(edges.data(), edges.size() / 2, max_vid);
+    for (size_t num_partitions : {1, 3}) {
+      for (size_t cores : {1, 2}) {
+        ExternalCSRBuilderT external_builder(1, cores);
+        ASSERT_TRUE(external_builder.Build(src_pt, edgelist_bin, work_space_,
+                                           num_partitions));
+        for (unsigned gid = 0; gid < num_partitions; gid++)
+          ExpectSameFragment(builder, gid, num_partitions);
+
+        // vid_map holds the local id of every vid, max_vid included.
+        DataMngr<CSR_T> data_mngr;
+        auto vid_map = data_mngr.ReadVidMap(work_space_ +
+                                            "minigraph_message/vid_map.bin");
+        EXPECT_EQ(vid_map.first, (size_t)max_vid + 1);
+        free(vid_map.second);
+      }
+    }
+  }
+}
+
+}  // namespace io
+}  // namespace utility
+}  // namespace minigraph
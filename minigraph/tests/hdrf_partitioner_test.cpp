@@ -0,0 +1,100 @@
+#include "utility/paritioner/hdrf_partitioner.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+using CSR_T = graphs::ImmutableCSR<unsigned, unsigned, unsigned, unsigned>;
+using EDGE_LIST_T = graphs::EdgeList<unsigned, unsigned, unsigned, unsigned>;
+
+// A hub 64 pointing to 1..8, a ring 1 -> 2 -> ... -> 8 -> 1 and a pair
+// 9 <-> 10 apart. 64, the largest vid, is the last bit of its word.
+static const unsigned kEdges[] = {
+    64, 1, 64, 2, 64, 3, 64, 4, 64, 5, 64, 6, 64, 7, 64, 8, 1, 2, 2,  3,
+    3,  4, 4,  5, 5,  6, 6,  7, 7,  8, 8,  1, 9,  10, 10, 9};
+static const size_t kNumEdges = 18;
+static const std::vector<unsigned> kVids = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 64};
+
+// Check that the fragments hold every edge once, as out-edges of replicas,
+// and that border bits mark exactly the replicated vertexes, whose
+// fragments depend on each other. Return the number of edges per fragment.
+std::vector<size_t> CheckVertexCut(HDRFPartitioner<CSR_T>* partitioner,
+                                   const size_t num_partitions) {
+  auto fragments = partitioner->GetFragments();
+  EXPECT_EQ(fragments->size(), num_partitions);
+  std::multiset<std::pair<unsigned, unsigned>> edges;
+  std::map<unsigned, std::set<unsigned>> gids_by_vid;
+  std::vector<size_t> num_edges;
+  for (unsigned gid = 0; gid < fragments->size(); gid++) {
+    auto graph = (CSR_T*)fragments->at(gid);
+    for (size_t i = 0; i < graph->get_num_vertexes(); i++) {
+      auto u = graph->GetVertexByIndex(i);
+      unsigned vid = graph->globalid_by_index_[i];
+      EXPECT_TRUE(gids_by_vid[vid].insert(gid).second) << vid;
+      for (size_t j = 0; j < u.outdegree; j++)
+        edges.insert(std::make_pair(vid, u.out_edges[j]));
+    }
+    num_edges.push_back(graph->sum_out_edges_);
+  }
+  std::multiset<std::pair<unsigned, unsigned>> expected;
+  for (size_t i = 0; i < kNumEdges; i++)
+    expected.insert(std::make_pair(kEdges[i * 2], kEdges[i * 2 + 1]));
+  EXPECT_EQ(edges, expected);
+  EXPECT_EQ(gids_by_vid.size(), kVids.size());
+
+  // Vertex-cut fragments hold no local ids in vid_map, yet it spans all
+  // vids, as do the border bits.
+  unsigned* vid_map = partitioner->GetVidMap();
+  Bitmap* border = partitioner->GetGlobalBorderVidMap();
+  auto matrix = partitioner->GetCommunicationMatrix();
+  EXPECT_EQ(matrix.first, num_partitions);
+  std::vector<bool> shared(num_partitions * num_partitions, false);
+  for (auto vid : kVids) {
+    EXPECT_EQ(vid_map[vid], 0);
+    auto& gids = gids_by_vid[vid];
+    EXPECT_EQ(border->get_bit(vid) != 0, gids.size() > 1) << vid;
+    for (auto x : gids)
+      for (auto y : gids)
+        if (x != y) shared[x * num_partitions + y] = true;
+  }
+  for (size_t i = 0; i < num_partitions * num_partitions; i++)
+    EXPECT_EQ(matrix.second[i], shared[i]) << i;
+  for (auto fragment : *fragments) delete (CSR_T*)fragment;
+  return num_edges;
+}
+
+TEST(HDRFPartitionerTest, PartitionEveryEdgeOnce) {
+  for (size_t num_partitions : {1, 2, 3}) {
+    for (size_t cores : {1, 2}) {
+      auto edgelist_graph = new EDGE_LIST_T(0, kNumEdges, kVids.size(), 64,
+                                            (unsigned*)kEdges);
+      HDRFPartitioner<CSR_T> partitioner;
+      ASSERT_TRUE(
+          partitioner.ParallelPartition(edgelist_graph, num_partitions, cores));
+      auto num_edges = CheckVertexCut(&partitioner, num_partitions);
+      size_t sum = 0;
+      for (auto n : num_edges) sum += n;
+      EXPECT_EQ(sum, kNumEdges);
+    }
+  }
+}
+
+TEST(HDRFPartitionerTest, LargeLambdaBalances) {
+  auto edgelist_graph =
+      new EDGE_LIST_T(0, kNumEdges, kVids.size(), 64, (unsigned*)kEdges);
+  HDRFPartitioner<CSR_T> partitioner(100);
+  ASSERT_TRUE(partitioner.ParallelPartition(edgelist_graph, 4, 1));
+  auto num_edges = CheckVertexCut(&partitioner, 4);
+  auto minmax = std::minmax_element(num_edges.begin(), num_edges.end());
+  EXPECT_LE(*minmax.second - *minmax.first, 1);
+}
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
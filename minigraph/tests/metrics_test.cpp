@@ -0,0 +1,138 @@
+#include "utility/metrics.h"
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <folly/experimental/TestUtil.h>
+
+#include "utility/atomic.h"
+
+namespace minigraph {
+namespace utility {
+
+class MetricsTest : public ::testing::Test {
+ protected:
+  void SetUp() override { Metrics::Get().Enable(); }
+
+  // Write the registry to file_ and read back the value of each series, and
+  // the comment lines.
+  std::map<std::string, double> ReadSeries() {
+    EXPECT_TRUE(Metrics::Get().WritePrometheus(file_.path().string()));
+    std::ifstream fin(file_.path().string());
+    std::map<std::string, double> series;
+    comments_.clear();
+    for (std::string line; std::getline(fin, line);) {
+      if (line.empty()) continue;
+      if (line[0] == '#') {
+        comments_.insert(line);
+        continue;
+      }
+      size_t pos = line.rfind(' ');
+      EXPECT_NE(pos, std::string::npos) << line;
+      series[line.substr(0, pos)] = std::stod(line.substr(pos + 1));
+    }
+    return series;
+  }
+
+  folly::test::TemporaryFile file_;
+  std::set<std::string> comments_;
+};
+
+TEST_F(MetricsTest, WriteHistogramsWithLabels) {
+  Metrics::Get().Observe("minigraph_compute_seconds", 0.002, 1);
+  Metrics::Get().Observe("minigraph_compute_seconds", 0.003, 1);
+  Metrics::Get().Observe("minigraph_compute_seconds", 0.2, 1);
+  Metrics::Get().Observe("minigraph_compute_seconds", 20, 0);
+  Metrics::Get().Observe("minigraph_load_seconds", 0.0001);
+  Metrics::Get().Observe("minigraph_load_seconds", 1000);
+
+  auto series = ReadSeries();
+  EXPECT_EQ(comments_.count("# TYPE minigraph_compute_seconds histogram"), 1);
+  EXPECT_EQ(comments_.count("# TYPE minigraph_read_bytes_total counter"), 1);
+  EXPECT_EQ(comments_.count("# TYPE minigraph_task_queue_depth gauge"), 1);
+
+  // Buckets are cumulative, one series per inc_type.
+  const std::string compute = "minigraph_compute_seconds";
+  EXPECT_EQ(series[compute + "_bucket{inc_type=\"1\",le=\"0.001\"}"], 0);
+  EXPECT_EQ(series[compute + "_bucket{inc_type=\"1\",le=\"0.005\"}"], 2);
+  EXPECT_EQ(series[compute + "_bucket{inc_type=\"1\",le=\"0.5\"}"], 3);
+  EXPECT_EQ(series[compute + "_bucket{inc_type=\"1\",le=\"+Inf\"}"], 3);
+  EXPECT_DOUBLE_EQ(series[compute + "_sum{inc_type=\"1\"}"], 0.205);
+  EXPECT_EQ(series[compute + "_count{inc_type=\"1\"}"], 3);
+  EXPECT_EQ(series[compute + "_bucket{inc_type=\"0\",le=\"10\"}"], 0);
+  EXPECT_EQ(series[compute + "_bucket{inc_type=\"0\",le=\"50\"}"], 1);
+  EXPECT_EQ(series[compute + "_count{inc_type=\"0\"}"], 1);
+  double last = 0;
+  for (double le : Metrics::kBuckets) {
+    std::ostringstream name;
+    name.precision(15);
+    name << compute << "_bucket{inc_type=\"1\",le=\"" << le << "\"}";
+    ASSERT_EQ(series.count(name.str()), 1) << name.str();
+    EXPECT_GE(series[name.str()], last) << name.str();
+    last = series[name.str()];
+  }
+
+  // Without a label, no braces but for le.
+  const std::string load = "minigraph_load_seconds";
+  EXPECT_EQ(series[load + "_bucket{le=\"0.0001\"}"], 1);
+  EXPECT_EQ(series[load + "_bucket{le=\"100\"}"], 1);
+  EXPECT_EQ(series[load + "_bucket{le=\"+Inf\"}"], 2);
+  EXPECT_DOUBLE_EQ(series[load + "_sum"], 1000.0001);
+  EXPECT_EQ(series[load + "_count"], 2);
+}
+
+TEST_F(MetricsTest, WriteCountersAndGauges) {
+  Metrics::Get().Add("minigraph_read_bytes_total", 100, 2);
+  Metrics::Get().Add("minigraph_read_bytes_total", 50, 2);
+  Metrics::Get().Add("minigraph_read_bytes_total", 7, 5);
+  Metrics::Get().Set("minigraph_task_queue_depth", 3);
+  Metrics::Get().Set("minigraph_task_queue_depth", 1);
+
+  auto series = ReadSeries();
+  EXPECT_EQ(series["minigraph_read_bytes_total{gid=\"2\"}"], 150);
+  EXPECT_EQ(series["minigraph_read_bytes_total{gid=\"5\"}"], 7);
+  EXPECT_EQ(series["minigraph_task_queue_depth"], 1);
+  EXPECT_GT(series["minigraph_resident_memory_bytes"], 0);
+}
+
+TEST_F(MetricsTest, CountCasRetries) {
+  // Enable() in SetUp() set the base of minigraph_cas_retries_total.
+  for (size_t i = 0; i < 5; i++) EXPECT_TRUE(retry_cas());
+  EXPECT_EQ(ReadSeries()["minigraph_cas_retries_total"], 5);
+
+  // Retries are not counted while count_cas_retries is unset.
+  count_cas_retries.store(false);
+  size_t num_retries = cas_retries.load();
+  EXPECT_TRUE(retry_cas());
+  EXPECT_EQ(cas_retries.load(), num_retries);
+  count_cas_retries.store(true);
+
+  // Contended write_add / write_min stay exact, and report what they retry.
+  const unsigned num_threads = 8;
+  const unsigned num_ops = 10000;
+  size_t sum = 0;
+  unsigned min = num_threads * num_ops + 1;
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < num_threads; t++)
+    threads.emplace_back([&, t]() {
+      for (unsigned i = 0; i < num_ops; i++) {
+        write_add(&sum, (size_t)1);
+        write_min(&min, num_threads * num_ops - i * num_threads - t);
+      }
+    });
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(sum, num_threads * num_ops);
+  EXPECT_EQ(min, 1);
+  EXPECT_EQ(ReadSeries()["minigraph_cas_retries_total"],
+            cas_retries.load() - num_retries + 5);
+}
+
+}  // namespace utility
+}  // namespace minigraph
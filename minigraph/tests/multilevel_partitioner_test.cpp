@@ -0,0 +1,119 @@
+#include "utility/paritioner/multilevel_partitioner.h"
+
+#include <map>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+using CSR_T = graphs::ImmutableCSR<unsigned, unsigned, unsigned, unsigned>;
+using EDGE_LIST_T = graphs::EdgeList<unsigned, unsigned, unsigned, unsigned>;
+
+class MultilevelPartitionerTest : public ::testing::Test {
+ protected:
+  // Two communities of kSize vertexes, vids [0, kSize) and [kBase,
+  // kBase + kSize), each a ring i -> i + 1 with chords i -> i + 7, bridged
+  // by two edges. 256, the largest vid, is the first bit of its word.
+  static constexpr unsigned kSize = 100;
+  static constexpr unsigned kBase = 157;
+  static constexpr unsigned kMaxVid = kBase + kSize - 1;
+
+  void SetUp() override {
+    for (unsigned base : {0u, kBase}) {
+      for (unsigned i = 0; i < kSize; i++) {
+        AddEdge(base + i, base + (i + 1) % kSize);
+        AddEdge(base + i, base + (i + 7) % kSize);
+        vids_.push_back(base + i);
+      }
+    }
+    AddEdge(kSize - 1, kBase);
+    AddEdge(kMaxVid, 0);
+  }
+
+  void AddEdge(const unsigned src, const unsigned dst) {
+    edges_.push_back(src);
+    edges_.push_back(dst);
+  }
+
+  size_t get_num_edges() const { return edges_.size() / 2; }
+
+  // Check that every vertex is in one fragment at its vid_map slot, that
+  // fragments hold every edge once as out-edges, and that border bits and
+  // the communication matrix follow the cut edges. Return the number of
+  // cut edges.
+  size_t CheckEdgeCut(MultilevelPartitioner<CSR_T>* partitioner,
+                      const size_t num_partitions) {
+    auto fragments = partitioner->GetFragments();
+    EXPECT_EQ(fragments->size(), num_partitions);
+    unsigned* vid_map = partitioner->GetVidMap();
+    std::map<unsigned, unsigned> owner;
+    size_t sum_out_edges = 0;
+    for (unsigned gid = 0; gid < fragments->size(); gid++) {
+      auto graph = (CSR_T*)fragments->at(gid);
+      for (size_t i = 0; i < graph->get_num_vertexes(); i++) {
+        unsigned vid = graph->globalid_by_index_[i];
+        EXPECT_TRUE(owner.emplace(vid, gid).second) << vid;
+        EXPECT_EQ(vid_map[vid], i) << vid;
+      }
+      // Within 1 + imbalance of the average, up to a vertex.
+      EXPECT_LE(graph->get_num_vertexes(),
+                1.03 * vids_.size() / num_partitions + 1);
+      sum_out_edges += graph->sum_out_edges_;
+    }
+    EXPECT_EQ(owner.size(), vids_.size());
+    EXPECT_EQ(sum_out_edges, get_num_edges());
+
+    Bitmap* border = partitioner->GetGlobalBorderVidMap();
+    auto matrix = partitioner->GetCommunicationMatrix();
+    EXPECT_EQ(matrix.first, num_partitions);
+    std::map<unsigned, bool> is_border;
+    std::vector<bool> linked(num_partitions * num_partitions, false);
+    size_t num_cut_edges = 0;
+    for (size_t i = 0; i < get_num_edges(); i++) {
+      unsigned src = edges_[i * 2], dst = edges_[i * 2 + 1];
+      unsigned x = owner[src], y = owner[dst];
+      if (x == y) continue;
+      is_border[src] = is_border[dst] = true;
+      linked[x * num_partitions + y] = linked[y * num_partitions + x] = true;
+      num_cut_edges++;
+    }
+    for (auto vid : vids_)
+      EXPECT_EQ(border->get_bit(vid) != 0, is_border[vid]) << vid;
+    for (size_t i = 0; i < num_partitions * num_partitions; i++)
+      EXPECT_EQ(matrix.second[i], linked[i]) << i;
+    for (auto fragment : *fragments) delete (CSR_T*)fragment;
+    return num_cut_edges;
+  }
+
+  std::vector<unsigned> edges_;
+  std::vector<unsigned> vids_;
+};
+
+TEST_F(MultilevelPartitionerTest, CutBetweenCommunities) {
+  for (size_t cores : {1, 3}) {
+    auto edgelist_graph = new EDGE_LIST_T(0, get_num_edges(), vids_.size(),
+                                          kMaxVid, edges_.data());
+    MultilevelPartitioner<CSR_T> partitioner;
+    ASSERT_TRUE(partitioner.ParallelPartition(edgelist_graph, 2, cores));
+    // Only the bridges are cut.
+    EXPECT_EQ(CheckEdgeCut(&partitioner, 2), 2);
+  }
+}
+
+TEST_F(MultilevelPartitionerTest, PartitionEveryVertexOnce) {
+  for (size_t num_partitions : {1, 3, 4}) {
+    auto edgelist_graph = new EDGE_LIST_T(0, get_num_edges(), vids_.size(),
+                                          kMaxVid, edges_.data());
+    MultilevelPartitioner<CSR_T> partitioner;
+    ASSERT_TRUE(
+        partitioner.ParallelPartition(edgelist_graph, num_partitions, 2));
+    size_t num_cut_edges = CheckEdgeCut(&partitioner, num_partitions);
+    if (num_partitions == 1) EXPECT_EQ(num_cut_edges, 0);
+  }
+}
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
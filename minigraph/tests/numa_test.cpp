@@ -0,0 +1,110 @@
+#include "utility/numa.h"
+
+#include <sched.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "executors/latch.h"
+#include "executors/work_stealing_pool.h"
+
+namespace minigraph {
+namespace utility {
+
+static cpu_set_t GetAffinity() {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  sched_getaffinity(0, sizeof(cpu_set), &cpu_set);
+  return cpu_set;
+}
+
+// Affinity of a thread of a WorkStealingPool created with numa_node.
+static cpu_set_t GetPoolAffinity(const int numa_node) {
+  cpu_set_t cpu_set;
+  executors::WorkStealingPool pool(1, numa_node);
+  executors::Latch latch(1);
+  pool.Run(
+      [&] {
+        cpu_set = GetAffinity();
+        latch.CountDown();
+      },
+      false);
+  latch.Wait();
+  return cpu_set;
+}
+
+TEST(NUMATest, NumNUMANodes) {
+  EXPECT_GE(NumNUMANodes(), 1);
+#ifdef USE_NUMA
+  if (numa_available() >= 0)
+    EXPECT_EQ(NumNUMANodes(),
+              (size_t)std::max(numa_num_configured_nodes(), 1));
+  else
+    EXPECT_EQ(NumNUMANodes(), 1);
+#else
+  EXPECT_EQ(NumNUMANodes(), 1);
+#endif
+}
+
+TEST(NUMATest, FragmentsSpreadOverNodes) {
+  const size_t num_nodes = NumNUMANodes();
+  std::vector<size_t> num_fragments(num_nodes, 0);
+  for (unsigned gid = 0; gid < 1000; gid++) {
+    size_t node = NUMANodeOf(gid);
+    ASSERT_LT(node, num_nodes) << gid;
+    EXPECT_EQ(node, gid % num_nodes);
+    EXPECT_EQ(NUMANodeOf((size_t)gid), node);
+    num_fragments[node]++;
+  }
+  // Round robin: no node holds more than one fragment more than another.
+  auto minmax = std::minmax_element(num_fragments.begin(), num_fragments.end());
+  EXPECT_LE(*minmax.second - *minmax.first, 1);
+}
+
+TEST(NUMATest, SingleNodeIsNoOp) {
+  if (NumNUMANodes() > 1) return;
+  for (unsigned gid = 0; gid < 16; gid++) EXPECT_EQ(NUMANodeOf(gid), 0);
+  cpu_set_t before = GetAffinity();
+  EXPECT_FALSE(PinThreadToNUMANode(0));
+  {
+    NUMANodeBinding binding(0);
+    cpu_set_t bound = GetAffinity();
+    EXPECT_TRUE(CPU_EQUAL(&before, &bound));
+  }
+  cpu_set_t after = GetAffinity();
+  EXPECT_TRUE(CPU_EQUAL(&before, &after));
+  // Pinning the threads of a pool to node 0 leaves them where they were.
+  cpu_set_t pinned = GetPoolAffinity(0);
+  EXPECT_TRUE(CPU_EQUAL(&before, &pinned));
+}
+
+TEST(NUMATest, NoPinningWithNegativeNode) {
+  // Threads of a pool created with numa_node -1 keep the affinity of the
+  // thread creating it.
+  cpu_set_t before = GetAffinity();
+  cpu_set_t unpinned = GetPoolAffinity(-1);
+  EXPECT_TRUE(CPU_EQUAL(&before, &unpinned));
+}
+
+TEST(NUMATest, BindingRestoresAffinity) {
+  cpu_set_t before = GetAffinity();
+  for (size_t node = 0; node < NumNUMANodes(); node++) {
+    {
+      NUMANodeBinding binding(node);
+#ifdef USE_NUMA
+      // Bound to the cpus of node only.
+      cpu_set_t bound = GetAffinity();
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (NumNUMANodes() > 1 && CPU_ISSET(cpu, &bound))
+          EXPECT_EQ(numa_node_of_cpu(cpu), (int)node) << cpu;
+#endif
+    }
+    cpu_set_t after = GetAffinity();
+    EXPECT_TRUE(CPU_EQUAL(&before, &after)) << node;
+  }
+}
+
+}  // namespace utility
+}  // namespace minigraph
@@ -0,0 +1,218 @@
+#include "utility/paritioner/repartitioner.h"
+
+#include <fstream>
+#include <map>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+using CSR_T = graphs::ImmutableCSR<unsigned, unsigned, unsigned, unsigned>;
+using CSRBuilderT = graphs::CSRBuilder<unsigned, unsigned, unsigned, unsigned>;
+
+// 0 -> 1 -> 2 -> 3 -> 0, 4 <-> 5, 6 <-> 64, 3 -> 4, 5 -> 6
+static const unsigned kEdges[] = {0, 1, 1,  2,  2,  3, 3, 0, 4, 5,
+                                  5, 4, 6, 64, 64, 6, 3, 4, 5, 6};
+static const size_t kNumEdges = 10;
+static const std::vector<unsigned> kVids = {0, 1, 2, 3, 4, 5, 6, 64};
+
+class RepartitionerTest : public ::testing::Test {
+ protected:
+  // Write an edge-cut workspace of fragments {0, 1, 2, 3}, {4, 5}, {6, 64},
+  // and a supersteps.csv giving each fragment its time and the number of
+  // supersteps it changed in.
+  void WriteWorkspace(const std::string& name,
+                      const std::vector<double>& times,
+                      const std::vector<size_t>& changed) {
+    work_space_ = "/tmp/minigraph_repartitioner_test/" + name + "/";
+    for (auto dir : {"minigraph_meta/", "minigraph_data/", "minigraph_vdata/",
+                     "minigraph_si/", "minigraph_message/",
+                     "minigraph_border_vertexes/"})
+      data_mngr_.MakeDirectory(work_space_ + dir);
+
+    std::vector<std::vector<unsigned>> fragments = {
+        {0, 1, 2, 3}, {4, 5}, {6, 64}};
+    CSRBuilderT builder(kEdges, kNumEdges, 64);
+    size_t aligned_max_vid = builder.get_aligned_max_vid();
+    unsigned* vid_map = (unsigned*)malloc(sizeof(unsigned) * aligned_max_vid);
+    memset(vid_map, 0, sizeof(unsigned) * aligned_max_vid);
+    for (unsigned gid = 0; gid < fragments.size(); gid++) {
+      Bitmap members(aligned_max_vid);
+      members.clear();
+      for (auto vid : fragments[gid]) members.set_bit(vid);
+      auto graph = builder.Build(gid, &members, vid_map);
+      data_mngr_.csr_io_adapter_->Write(*graph, csr_bin, false, MetaPt(gid),
+                                        DataPt(gid), VdataPt(gid));
+      StatisticInfo&& si =
+          PartitionerBase<CSR_T>::ParallelSetStatisticInfo(*graph, 1);
+      data_mngr_.WriteStatisticInfo(si, SiPt(gid));
+      delete graph;
+    }
+    data_mngr_.WriteVidMap(aligned_max_vid, vid_map,
+                           work_space_ + "minigraph_message/vid_map.bin");
+    free(vid_map);
+
+    // Fragments 0 and 2 are not joined by any edge.
+    auto owner = Owners(fragments);
+    size_t num_graphs = fragments.size();
+    bool matrix[9] = {0};
+    Bitmap border(aligned_max_vid);
+    border.clear();
+    for (size_t i = 0; i < kNumEdges; i++) {
+      unsigned x = owner[kEdges[i * 2]], y = owner[kEdges[i * 2 + 1]];
+      if (x == y) continue;
+      border.set_bit(kEdges[i * 2]);
+      border.set_bit(kEdges[i * 2 + 1]);
+      matrix[x * num_graphs + y] = matrix[y * num_graphs + x] = true;
+    }
+    data_mngr_.WriteBitmap(
+        &border, work_space_ + "minigraph_message/global_border_vid_map.bin");
+
+    data_mngr_.WriteCommunicationMatrix(
+        work_space_ + "minigraph_border_vertexes/communication_matrix.bin",
+        matrix, num_graphs);
+
+    std::ofstream fout(SuperstepsPt());
+    fout << "gid,superstep,inc_type,changed,elapsed_time" << std::endl;
+    for (unsigned gid = 0; gid < num_graphs; gid++)
+      fout << gid << ",0,0," << changed[gid] << "," << times[gid]
+           << std::endl;
+  }
+
+  // Read back the fragments, and check that they hold every vertex once and
+  // every edge as an out-edge once, and that vid_map, the border bits and
+  // the communication matrix agree with them. Return the vids of each
+  // fragment.
+  std::vector<std::vector<unsigned>> ReadAndCheck(const size_t num_graphs) {
+    auto matrix = data_mngr_.ReadCommunicationMatrix(
+        work_space_ + "minigraph_border_vertexes/communication_matrix.bin");
+    EXPECT_EQ(matrix.first, num_graphs);
+    auto vid_map =
+        data_mngr_.ReadVidMap(work_space_ + "minigraph_message/vid_map.bin");
+    auto border = data_mngr_.ReadBitmap(
+        work_space_ + "minigraph_message/global_border_vid_map.bin");
+
+    std::vector<std::vector<unsigned>> fragments(num_graphs);
+    size_t sum_out_edges = 0;
+    for (unsigned gid = 0; gid < num_graphs; gid++) {
+      CSR_T graph;
+      EXPECT_TRUE(data_mngr_.csr_io_adapter_->Read(
+          &graph, csr_bin, gid, MetaPt(gid), DataPt(gid), VdataPt(gid)));
+      EXPECT_EQ(data_mngr_.ReadStatisticInfo(SiPt(gid)).num_vertexes,
+                graph.get_num_vertexes());
+      sum_out_edges += graph.sum_out_edges_;
+      for (size_t i = 0; i < graph.get_num_vertexes(); i++) {
+        unsigned vid = graph.globalid_by_index_[i];
+        fragments[gid].push_back(vid);
+        EXPECT_LT(vid, vid_map.first);
+        if (vid < vid_map.first) EXPECT_EQ(vid_map.second[vid], i);
+      }
+    }
+    EXPECT_EQ(sum_out_edges, kNumEdges);
+
+    auto owner = Owners(fragments);
+    EXPECT_EQ(owner.size(), kVids.size());
+    std::map<unsigned, bool> is_border;
+    for (auto vid : kVids) is_border[vid] = false;
+    for (size_t i = 0; i < kNumEdges; i++) {
+      if (owner[kEdges[i * 2]] == owner[kEdges[i * 2 + 1]]) continue;
+      is_border[kEdges[i * 2]] = true;
+      is_border[kEdges[i * 2 + 1]] = true;
+    }
+    for (auto vid : kVids) {
+      EXPECT_LT(vid, border.first);
+      EXPECT_EQ(border.second->get_bit(vid) != 0, is_border[vid]) << vid;
+    }
+    // Dependencies may outlive the edges backing them, but none is missing.
+    for (unsigned gid = 0; gid < num_graphs; gid++)
+      EXPECT_FALSE(matrix.second[gid * num_graphs + gid]);
+    for (size_t i = 0; i < kNumEdges; i++) {
+      unsigned x = owner[kEdges[i * 2]], y = owner[kEdges[i * 2 + 1]];
+      if (x == y) continue;
+      EXPECT_TRUE(matrix.second[x * num_graphs + y]) << x << " " << y;
+      EXPECT_TRUE(matrix.second[y * num_graphs + x]) << y << " " << x;
+    }
+    free(matrix.second);
+    free(vid_map.second);
+    delete border.second;
+    return fragments;
+  }
+
+  std::map<unsigned, unsigned> Owners(
+      const std::vector<std::vector<unsigned>>& fragments) const {
+    std::map<unsigned, unsigned> owner;
+    for (unsigned gid = 0; gid < fragments.size(); gid++)
+      for (auto vid : fragments[gid])
+        EXPECT_TRUE(owner.emplace(vid, gid).second);
+    return owner;
+  }
+
+  std::string MetaPt(unsigned gid) const {
+    return work_space_ + "minigraph_meta/" + std::to_string(gid) + ".bin";
+  }
+  std::string DataPt(unsigned gid) const {
+    return work_space_ + "minigraph_data/" + std::to_string(gid) + ".bin";
+  }
+  std::string VdataPt(unsigned gid) const {
+    return work_space_ + "minigraph_vdata/" + std::to_string(gid) + ".bin";
+  }
+  std::string SiPt(unsigned gid) const {
+    return work_space_ + "minigraph_si/" + std::to_string(gid) + ".yaml";
+  }
+  std::string SuperstepsPt() const {
+    return work_space_ + "minigraph_si/supersteps.csv";
+  }
+
+  std::string work_space_;
+  io::DataMngr<CSR_T> data_mngr_;
+};
+
+TEST_F(RepartitionerTest, SplitHotFragment) {
+  WriteWorkspace("split", {10, 1, 1}, {5, 5, 5});
+  Repartitioner<CSR_T> repartitioner(work_space_);
+  EXPECT_TRUE(repartitioner.Repartition(SuperstepsPt()));
+  EXPECT_EQ(repartitioner.get_num_graphs(), 4);
+
+  auto fragments = ReadAndCheck(4);
+  EXPECT_EQ(fragments[0].size() + fragments[3].size(), 4);
+  EXPECT_FALSE(fragments[0].empty());
+  EXPECT_FALSE(fragments[3].empty());
+  EXPECT_EQ(fragments[2], (std::vector<unsigned>{6, 64}));
+
+  // Both halves keep away from fragment 2, as the whole did.
+  auto matrix = data_mngr_.ReadCommunicationMatrix(
+      work_space_ + "minigraph_border_vertexes/communication_matrix.bin");
+  for (unsigned gid : {0, 3}) {
+    EXPECT_FALSE(matrix.second[gid * 4 + 2]);
+    EXPECT_FALSE(matrix.second[2 * 4 + gid]);
+  }
+  free(matrix.second);
+}
+
+TEST_F(RepartitionerTest, MergeColdFragments) {
+  WriteWorkspace("merge", {1, 1, 1}, {5, 0, 0});
+  Repartitioner<CSR_T> repartitioner(work_space_);
+  EXPECT_TRUE(repartitioner.Repartition(SuperstepsPt()));
+  EXPECT_EQ(repartitioner.get_num_graphs(), 2);
+
+  auto fragments = ReadAndCheck(2);
+  EXPECT_EQ(fragments[0], (std::vector<unsigned>{0, 1, 2, 3}));
+  EXPECT_EQ(fragments[1], (std::vector<unsigned>{4, 5, 6, 64}));
+}
+
+TEST_F(RepartitionerTest, RenameLastFragmentIntoFreedGid) {
+  WriteWorkspace("rename", {1, 1, 1}, {0, 0, 5});
+  Repartitioner<CSR_T> repartitioner(work_space_);
+  EXPECT_TRUE(repartitioner.Repartition(SuperstepsPt()));
+  EXPECT_EQ(repartitioner.get_num_graphs(), 2);
+
+  auto fragments = ReadAndCheck(2);
+  EXPECT_EQ(fragments[0], (std::vector<unsigned>{0, 1, 2, 3, 4, 5}));
+  EXPECT_EQ(fragments[1], (std::vector<unsigned>{6, 64}));
+}
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
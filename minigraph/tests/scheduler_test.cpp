@@ -0,0 +1,124 @@
+#include "scheduler/large_first_scheduler.h"
+#include "scheduler/learned_scheduler.h"
+#include "scheduler/locality_scheduler.h"
+#include "scheduler/priority_scheduler.h"
+#include "scheduler/small_first_scheduler.h"
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace scheduler {
+
+TEST(LearnedSchedulerTest, ChooseMostActiveVertexesPerCost) {
+  // With the default model, the cost is num_edges + num_vertexes.
+  StatisticInfo si[3];
+  si[0].num_vertexes = 10;
+  si[0].num_edges = 90;
+  si[0].num_active_vertexes = 10;
+  si[1].num_vertexes = 100;
+  si[1].num_edges = 900;
+  si[1].num_active_vertexes = 40;
+  si[2].num_vertexes = 10;
+  si[2].num_edges = 10;
+  si[2].num_active_vertexes = 1;
+  for (auto& x : si) x.elapsed_time = 1;
+  LearnedScheduler<unsigned> scheduler(si);
+
+  std::vector<unsigned> vec_gid = {2, 1, 0};
+  EXPECT_EQ(scheduler.ChooseOne(vec_gid), 0);
+  EXPECT_EQ(scheduler.ChooseOne(vec_gid), 2);
+  EXPECT_EQ(scheduler.ChooseOne(vec_gid), 1);
+  EXPECT_TRUE(vec_gid.empty());
+}
+
+TEST(LearnedSchedulerTest, RankByLiveStatistics) {
+  StatisticInfo si[2];
+  si[0].num_vertexes = si[1].num_vertexes = 10;
+  si[0].num_edges = si[1].num_edges = 90;
+  LearnedScheduler<unsigned> scheduler(si);
+  // As published by CC: fragment 0 converged, 1 got messages.
+  si[0].elapsed_time = si[1].elapsed_time = 1;
+  si[1].num_incoming_messages = 2;
+
+  std::vector<unsigned> vec_gid = {0, 1};
+  EXPECT_EQ(scheduler.ChooseOne(vec_gid), 1);
+}
+
+TEST(LearnedSchedulerTest, RankByCostOfNextEvaluation) {
+  // PEval costs num_edges, IncEval a hundredth of it.
+  std::vector<std::vector<double>> rows;
+  std::vector<double> ys;
+  std::vector<size_t> inc_types;
+  for (size_t i = 1; i <= 64; i++) {
+    std::vector<double> row(utility::CostModel::kNumFeatures, 0);
+    row[6] = i * 37 % 101;
+    rows.push_back(row);
+    ys.push_back(i % 2 ? 0.01 * row[6] : row[6]);
+    inc_types.push_back(i % 2);
+  }
+  utility::CostModel cost_model;
+  ASSERT_TRUE(cost_model.Fit(rows, ys, inc_types));
+
+  StatisticInfo si[2];
+  si[0].num_vertexes = si[1].num_vertexes = 10;
+  si[0].num_edges = si[1].num_edges = 10;
+  // Fragment 1 is past its PEval, with 2 active vertexes.
+  si[1].elapsed_time = 1;
+  si[1].num_active_vertexes = 2;
+
+  // With the default model both cost 20, and 0 benefits more.
+  LearnedScheduler<unsigned> default_scheduler(si);
+  std::vector<unsigned> vec_gid = {0, 1};
+  EXPECT_EQ(default_scheduler.ChooseOne(vec_gid), 0);
+
+  // The IncEval of 1 is a hundred times cheaper than the PEval of 0.
+  LearnedScheduler<unsigned> scheduler(si, cost_model);
+  vec_gid = {0, 1};
+  EXPECT_EQ(scheduler.ChooseOne(vec_gid), 1);
+}
+
+TEST(SchedulerTest, RankByGid) {
+  StatisticInfo si[4];
+  si[0].num_active_vertexes = 5;
+  si[1].num_active_vertexes = 1;
+  si[2].num_active_vertexes = 9;
+  si[3].num_active_vertexes = 3;
+  LargeFirstScheduler<unsigned> large_first(si);
+  SmallFirstScheduler<unsigned> small_first(si);
+
+  std::vector<unsigned> vec_gid = {3, 0, 2};
+  EXPECT_EQ(large_first.ChooseOne(vec_gid), 2);
+  EXPECT_EQ(small_first.ChooseOne(vec_gid), 3);
+  EXPECT_EQ(vec_gid, std::vector<unsigned>({0}));
+}
+
+TEST(PrioritySchedulerTest, ChooseLargestPendingUpdates) {
+  StatisticInfo si[3];
+  si[0].pending_updates = 0.5;
+  si[1].pending_updates = 2;
+  si[1].num_incoming_messages = 1;
+  si[2].pending_updates = 2;
+  si[2].num_incoming_messages = 3;
+  PriorityScheduler<unsigned> scheduler(si);
+
+  std::vector<unsigned> vec_gid = {0, 1, 2};
+  EXPECT_EQ(scheduler.ChooseOne(vec_gid), 2);
+  EXPECT_EQ(scheduler.ChooseOne(vec_gid), 1);
+  EXPECT_EQ(scheduler.ChooseOne(vec_gid), 0);
+}
+
+TEST(LocalitySchedulerTest, ProducersFirst) {
+  // 3 <- 1 <- 2 <- 0 <-> 4: 1 consumes the messages of 2, etc.
+  bool matrix[25] = {0};
+  matrix[3 * 5 + 1] = matrix[1 * 5 + 2] = matrix[2 * 5 + 0] = 1;
+  matrix[0 * 5 + 4] = matrix[4 * 5 + 0] = 1;
+  LocalityScheduler<unsigned> scheduler(matrix, 5);
+
+  std::vector<unsigned> vec_gid = {3, 2, 1, 0, 4};
+  std::vector<unsigned> order;
+  while (!vec_gid.empty()) order.push_back(scheduler.ChooseOne(vec_gid));
+  EXPECT_EQ(order, std::vector<unsigned>({0, 2, 1, 3, 4}));
+}
+
+}  // namespace scheduler
+}  // namespace minigraph
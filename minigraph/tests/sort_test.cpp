@@ -0,0 +1,90 @@
+#include "utility/sort.h"
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace utility {
+
+// n keys in [0, max_key], drawn with a fixed seed.
+template <typename T>
+std::vector<T> RandomKeys(const size_t n, const T max_key) {
+  std::mt19937_64 gen(n);
+  std::uniform_int_distribution<T> dist(0, max_key);
+  std::vector<T> keys(n);
+  for (auto& key : keys) key = dist(gen);
+  return keys;
+}
+
+template <typename T>
+void ExpectRadixSorted(std::vector<T> keys) {
+  std::vector<T> expected = keys;
+  std::sort(expected.begin(), expected.end());
+  std::vector<T> tmp(keys.size());
+  T max_key = *std::max_element(keys.begin(), keys.end());
+  RadixSort(keys.data(), keys.size(), tmp.data(), SignificantBits(max_key));
+  EXPECT_EQ(keys, expected);
+}
+
+TEST(SortTest, RadixSortMatchesStdSort) {
+  for (size_t n : {1, 2, 33, 1000}) {
+    ExpectRadixSorted(RandomKeys<uint32_t>(n, 255));
+    ExpectRadixSorted(RandomKeys<uint32_t>(n, UINT32_MAX));
+    ExpectRadixSorted(RandomKeys<uint64_t>(n, UINT64_MAX));
+  }
+  // All keys share their lowest digit.
+  ExpectRadixSorted(std::vector<uint32_t>{0x300, 0x100, 0x200, 0x100});
+}
+
+TEST(SortTest, AdaptiveSortMatchesStdSort) {
+  for (size_t n : std::vector<size_t>{0, 1, 2, kInsertionSortThreshold,
+                                      kInsertionSortThreshold + 1, 1000}) {
+    std::vector<std::vector<uint32_t>> inputs = {
+        RandomKeys<uint32_t>(n, 7), RandomKeys<uint32_t>(n, UINT32_MAX)};
+    std::vector<uint32_t> ascending(n), descending(n);
+    for (size_t i = 0; i < n; i++) {
+      ascending[i] = i;
+      descending[i] = n - i;
+    }
+    inputs.push_back(ascending);
+    inputs.push_back(descending);
+    for (auto& keys : inputs) {
+      std::vector<uint32_t> expected = keys;
+      std::sort(expected.begin(), expected.end());
+      std::vector<uint32_t> tmp(n);
+      AdaptiveSort(keys.data(), n, tmp.data());
+      EXPECT_EQ(keys, expected) << n;
+    }
+  }
+}
+
+TEST(SortTest, ParallelRadixSortMatchesStdSort) {
+  auto thread_pool = CPUThreadPool(4, 1);
+  for (size_t cores : {1, 2, 3, 4}) {
+    for (size_t n : {10, 100, 100000}) {
+      std::vector<std::vector<uint32_t>> inputs = {
+          RandomKeys<uint32_t>(n, 1000), RandomKeys<uint32_t>(n, UINT32_MAX),
+          std::vector<uint32_t>(n, 42)};
+      std::vector<uint32_t> ascending(n);
+      for (size_t i = 0; i < n; i++) ascending[i] = i * 3;
+      inputs.push_back(ascending);
+      // Sorted blocks, yet not sorted as a whole.
+      std::vector<uint32_t> rotated = ascending;
+      std::rotate(rotated.begin(), rotated.begin() + n / 2, rotated.end());
+      inputs.push_back(rotated);
+      for (auto& keys : inputs) {
+        std::vector<uint32_t> expected = keys;
+        std::sort(expected.begin(), expected.end());
+        std::vector<uint32_t> tmp(n);
+        ParallelRadixSort(keys.data(), n, tmp.data(), cores, thread_pool);
+        EXPECT_EQ(keys, expected) << "cores: " << cores << " n: " << n;
+      }
+    }
+  }
+}
+
+}  // namespace utility
+}  // namespace minigraph
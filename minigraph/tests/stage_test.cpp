@@ -0,0 +1,125 @@
+#include "components/stage.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace components {
+
+// Wait up to 10s for done to hold.
+template <typename F>
+static bool WaitFor(F&& done) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+TEST(StageTest, ConcurrentPushProcessesEveryItemOnce) {
+  const size_t num_producers = 4;
+  const size_t num_items = 1000;
+  utility::EDFThreadPool thread_pool(4);
+  std::vector<std::atomic<size_t>> times(num_producers * num_items);
+  std::atomic<size_t> num_processed(0);
+  Stage<size_t> stage(&thread_pool, [&](size_t item) {
+    times[item]++;
+    num_processed++;
+  });
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < num_producers; p++)
+    producers.emplace_back([&, p]() {
+      for (size_t i = 0; i < num_items; i++) stage.Push(p * num_items + i);
+    });
+  for (auto& producer : producers) producer.join();
+
+  ASSERT_TRUE(WaitFor([&] { return stage.Size() == 0; }));
+  EXPECT_EQ(num_processed.load(), num_producers * num_items);
+  for (size_t item = 0; item < times.size(); item++)
+    EXPECT_EQ(times[item].load(), 1) << item;
+}
+
+TEST(StageTest, ProcessesOneItemAtATime) {
+  utility::EDFThreadPool thread_pool(8);
+  std::atomic<size_t> num_in_process(0);
+  std::atomic<size_t> max_in_process(0);
+  std::atomic<size_t> num_processed(0);
+  Stage<int> stage(&thread_pool, [&](int) {
+    size_t n = ++num_in_process;
+    size_t max = max_in_process.load();
+    while (n > max && !max_in_process.compare_exchange_weak(max, n)) {
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    num_in_process--;
+    num_processed++;
+  });
+
+  // Producers race with the drain, which may go idle and restart between
+  // pushes.
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < 4; p++)
+    producers.emplace_back([&]() {
+      for (int i = 0; i < 100; i++) {
+        stage.Push(i);
+        if (i % 10 == 0)
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  for (auto& producer : producers) producer.join();
+
+  ASSERT_TRUE(WaitFor([&] { return stage.Size() == 0; }));
+  EXPECT_EQ(num_processed.load(), 400);
+  EXPECT_EQ(max_in_process.load(), 1);
+}
+
+TEST(StageTest, DrainsInPushOrder) {
+  utility::EDFThreadPool thread_pool(4);
+  std::vector<int> processed;
+  std::unique_ptr<Stage<int>> stage;
+  stage = std::make_unique<Stage<int>>(&thread_pool, [&](int item) {
+    processed.push_back(item);
+    // Items pushed while processing go after those already queued.
+    if (item < 0) stage->Push(-item);
+  });
+
+  for (int i = 0; i < 100; i++) stage->Push(i);
+  stage->Push(-100);
+  for (int i = 101; i < 200; i++) stage->Push(i);
+
+  ASSERT_TRUE(WaitFor([&] { return stage->Size() == 0; }));
+  ASSERT_EQ(processed.size(), 201);
+  for (int i = 0; i < 100; i++) EXPECT_EQ(processed[i], i);
+  EXPECT_EQ(processed[100], -100);
+  for (int i = 101; i < 200; i++) EXPECT_EQ(processed[i], i);
+  EXPECT_EQ(processed[200], 100);
+}
+
+TEST(StageTest, DrainsToIdleOnShutdown) {
+  auto thread_pool = std::make_unique<utility::EDFThreadPool>(2);
+  std::atomic<bool> switch_on(true);
+  std::atomic<size_t> num_processed(0);
+  // As DC, items reaching the stage once switched off are dropped.
+  Stage<int> stage(thread_pool.get(), [&](int item) {
+    if (!switch_on.load()) return;
+    num_processed++;
+    if (item == 9) switch_on.store(false);
+  });
+
+  for (int i = 0; i < 100; i++) stage.Push(i);
+  ASSERT_TRUE(WaitFor([&] { return stage.Size() == 0; }));
+  EXPECT_EQ(num_processed.load(), 10);
+
+  // Idle, the stage holds no task of the pool, which can go first.
+  thread_pool.reset();
+  EXPECT_EQ(stage.Size(), 0);
+}
+
+}  // namespace components
+}  // namespace minigraph
@@ -0,0 +1,59 @@
+#include "utility/state_machine.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+
+TEST(StateMachineTest, FollowsTransitionTable) {
+  StateMachine<unsigned> state_machine({0, 1, 2});
+  EXPECT_EQ(state_machine.CountInState(IDLE), 3);
+
+  state_machine.ProcessEvent(0, LOAD);
+  state_machine.ProcessEvent(0, NOTHINGCHANGED);
+  state_machine.ProcessEvent(1, LOAD);
+  state_machine.ProcessEvent(1, CHANGED);
+  state_machine.ProcessEvent(2, SHORTCUTREAD);
+  EXPECT_TRUE(state_machine.GraphIs(0, RT));
+  EXPECT_TRUE(state_machine.GraphIs(1, RC));
+  EXPECT_EQ(state_machine.GetState(2), RT);
+  EXPECT_EQ(state_machine.CountInState(RT), 2);
+  EXPECT_EQ(state_machine.GetAllinStateX(RT),
+            (std::vector<unsigned>{0, 2}));
+  EXPECT_FALSE(state_machine.IsTerminated());
+
+  state_machine.ProcessEvent(1, SHORTCUT);
+  EXPECT_TRUE(state_machine.IsTerminated());
+
+  EXPECT_EQ(state_machine.EvokeAllX(RT), (std::vector<unsigned>{0, 2}));
+  state_machine.EvokeX(1, RTS);
+  EXPECT_EQ(state_machine.CountInState(IDLE), 3);
+  EXPECT_FALSE(state_machine.ProcessEvent(3, LOAD));
+}
+
+TEST(StateMachineTest, CountsConcurrentTransitions) {
+  const unsigned num_graphs = 1000;
+  std::vector<unsigned> vec_gid;
+  for (unsigned i = 0; i < num_graphs; i++) vec_gid.push_back(i);
+  StateMachine<unsigned> state_machine(vec_gid);
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < 4; t++)
+    threads.emplace_back([&state_machine, t, num_graphs] {
+      for (unsigned gid = t; gid < num_graphs; gid += 4) {
+        state_machine.ProcessEvent(gid, LOAD);
+        state_machine.ProcessEvent(gid, gid % 2 ? CHANGED : NOTHINGCHANGED);
+      }
+    });
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(state_machine.CountInState(RT), num_graphs / 2);
+  EXPECT_EQ(state_machine.CountInState(RC), num_graphs / 2);
+  EXPECT_EQ(state_machine.CountInState(ACTIVE), 0);
+  EXPECT_EQ(state_machine.CountInState(IDLE), 0);
+}
+
+}  // namespace utility
+}  // namespace minigraph
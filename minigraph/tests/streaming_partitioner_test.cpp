@@ -0,0 +1,154 @@
+#include "utility/paritioner/streaming_partitioner.h"
+
+#include <fstream>
+#include <map>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+using CSR_T = graphs::ImmutableCSR<unsigned, unsigned, unsigned, unsigned>;
+using EDGE_LIST_T = graphs::EdgeList<unsigned, unsigned, unsigned, unsigned>;
+
+// Cliques {0, 1, 2, 3} and {5, 6, 7, 64} bridged by 3 -> 5, and a self loop
+// on 2, which is dropped.
+static const unsigned kEdges[] = {0, 1, 0, 2, 0, 3,  1, 2, 1, 3,  2, 3,
+                                  5, 6, 5, 7, 5, 64, 6, 7, 6, 64, 7, 64,
+                                  3, 5, 2, 2};
+static const size_t kNumEdges = 14;
+static const size_t kNumKeptEdges = 13;
+static const std::vector<unsigned> kVids = {0, 1, 2, 3, 5, 6, 7, 64};
+
+class StreamingPartitionerTest : public ::testing::Test {
+ protected:
+  // Check that every vertex is placed once within the 1.1x capacity, and
+  // that border bits mark exactly the endpoints of cut edges, whose
+  // fragments depend on each other.
+  void CheckAssignment(const std::vector<unsigned>& gid_by_vid,
+                       Bitmap* border, const bool* matrix) {
+    ASSERT_GT(gid_by_vid.size(), 64);
+    std::map<unsigned, size_t> load;
+    for (auto vid : kVids) {
+      ASSERT_LT(gid_by_vid[vid], 2);
+      load[gid_by_vid[vid]]++;
+    }
+    for (auto& iter : load) EXPECT_LE(iter.second, 5);
+    std::map<unsigned, bool> is_border;
+    bool is_cut = false;
+    for (size_t i = 0; i < kNumEdges; i++) {
+      unsigned src = kEdges[i * 2], dst = kEdges[i * 2 + 1];
+      if (gid_by_vid[src] == gid_by_vid[dst]) continue;
+      is_border[src] = true;
+      is_border[dst] = true;
+      is_cut = true;
+    }
+    for (auto vid : kVids)
+      EXPECT_EQ(border->get_bit(vid) != 0, is_border[vid]) << vid;
+    EXPECT_EQ(matrix[0 * 2 + 0], false);
+    EXPECT_EQ(matrix[0 * 2 + 1], is_cut);
+    EXPECT_EQ(matrix[1 * 2 + 0], is_cut);
+    EXPECT_EQ(matrix[1 * 2 + 1], false);
+  }
+
+  // Check a fragment against the assignment and vid_map, and return its
+  // number of out edges.
+  size_t CheckFragment(const CSR_T& graph, const unsigned gid,
+                       const std::vector<unsigned>& gid_by_vid,
+                       const unsigned* vid_map) {
+    for (size_t i = 0; i < graph.get_num_vertexes(); i++) {
+      unsigned vid = graph.globalid_by_index_[i];
+      EXPECT_EQ(gid_by_vid[vid], gid) << vid;
+      EXPECT_EQ(vid_map[vid], i) << vid;
+      num_placed_++;
+    }
+    return graph.sum_out_edges_;
+  }
+
+  size_t num_placed_ = 0;
+};
+
+TEST_F(StreamingPartitionerTest, PartitionInMemory) {
+  for (auto heuristic : {"ldg", "fennel"}) {
+    num_placed_ = 0;
+    auto edgelist_graph = new EDGE_LIST_T(0, kNumEdges, kVids.size(), 64,
+                                          (unsigned*)kEdges);
+    StreamingPartitioner<CSR_T> partitioner(heuristic);
+    ASSERT_TRUE(partitioner.ParallelPartition(edgelist_graph, 2, 2));
+    auto& gid_by_vid = partitioner.GetGidByVid();
+    CheckAssignment(gid_by_vid, partitioner.GetGlobalBorderVidMap(),
+                    partitioner.GetCommunicationMatrix().second);
+
+    auto fragments = partitioner.GetFragments();
+    ASSERT_EQ(fragments->size(), 2);
+    size_t sum_out_edges = 0;
+    for (unsigned gid = 0; gid < 2; gid++)
+      sum_out_edges += CheckFragment(*(CSR_T*)fragments->at(gid), gid,
+                                     gid_by_vid, partitioner.GetVidMap());
+    EXPECT_EQ(sum_out_edges, kNumKeptEdges);
+    EXPECT_EQ(num_placed_, kVids.size());
+    for (auto fragment : *fragments) delete (CSR_T*)fragment;
+  }
+}
+
+TEST_F(StreamingPartitionerTest, StreamFromDiskInChunks) {
+  std::string dir = "/tmp/minigraph_streaming_partitioner_test/";
+  io::DataMngr<CSR_T> data_mngr;
+  for (auto sub : {"minigraph_meta/", "minigraph_data/", "minigraph_vdata/",
+                   "minigraph_si/", "minigraph_message/",
+                   "minigraph_border_vertexes/"})
+    data_mngr.MakeDirectory(dir + sub);
+  {
+    std::ofstream fout(dir + "edges.csv");
+    fout << "# src,dst" << std::endl;
+    for (size_t i = 0; i < kNumEdges; i++)
+      fout << kEdges[i * 2] << "," << kEdges[i * 2 + 1] << std::endl;
+  }
+
+  // Chunks of a single edge, then of 4 edges, then of the whole list. A
+  // single chunk is placed as in memory.
+  for (size_t chunk_size : {1, 4, 1024}) {
+    num_placed_ = 0;
+    StreamingPartitioner<CSR_T> partitioner("ldg");
+    ASSERT_TRUE(partitioner.StreamPartition(dir + "edges.csv", edgelist_csv,
+                                            dir, 2, 2, ',',
+                                            chunk_size * 6 * sizeof(unsigned)));
+    auto& gid_by_vid = partitioner.GetGidByVid();
+    auto border = data_mngr.ReadBitmap(
+        dir + "minigraph_message/global_border_vid_map.bin");
+    auto matrix = data_mngr.ReadCommunicationMatrix(
+        dir + "minigraph_border_vertexes/communication_matrix.bin");
+    ASSERT_EQ(matrix.first, 2);
+    CheckAssignment(gid_by_vid, border.second, matrix.second);
+    delete border.second;
+    free(matrix.second);
+
+    auto vid_map = data_mngr.ReadVidMap(dir + "minigraph_message/vid_map.bin");
+    EXPECT_EQ(vid_map.first, 65);
+    size_t sum_out_edges = 0;
+    for (unsigned gid = 0; gid < 2; gid++) {
+      CSR_T graph;
+      std::string name = std::to_string(gid) + ".bin";
+      ASSERT_TRUE(data_mngr.csr_io_adapter_->Read(
+          &graph, csr_bin, gid, dir + "minigraph_meta/" + name,
+          dir + "minigraph_data/" + name, dir + "minigraph_vdata/" + name));
+      sum_out_edges += CheckFragment(graph, gid, gid_by_vid, vid_map.second);
+    }
+    free(vid_map.second);
+    EXPECT_EQ(sum_out_edges, kNumKeptEdges);
+    EXPECT_EQ(num_placed_, kVids.size());
+
+    if (chunk_size != 1024) continue;
+    auto edgelist_graph = new EDGE_LIST_T(0, kNumEdges, kVids.size(), 64,
+                                          (unsigned*)kEdges);
+    StreamingPartitioner<CSR_T> in_memory("ldg");
+    ASSERT_TRUE(in_memory.ParallelPartition(edgelist_graph, 2, 2));
+    EXPECT_EQ(in_memory.GetGidByVid(), gid_by_vid);
+    for (auto fragment : *in_memory.GetFragments()) delete (CSR_T*)fragment;
+  }
+}
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
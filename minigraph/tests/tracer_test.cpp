@@ -0,0 +1,96 @@
+#include "utility/tracer.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <yaml-cpp/yaml.h>
+
+#include <folly/experimental/TestUtil.h>
+
+namespace minigraph {
+namespace utility {
+
+// The Tracer is shared by all tests, and each test records on threads of
+// its own under names of its own.
+class TracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { Tracer::Get().Enable(); }
+
+  // Events named name of the trace written to file_. JSON being a subset of
+  // YAML, the trace is parsed by yaml-cpp.
+  std::vector<YAML::Node> ReadEvents(const std::string& name) {
+    EXPECT_TRUE(Tracer::Get().WriteChromeTrace(file_.path().string()));
+    YAML::Node trace = YAML::LoadFile(file_.path().string());
+    EXPECT_TRUE(trace["traceEvents"].IsSequence());
+    std::vector<YAML::Node> events;
+    for (auto event : trace["traceEvents"])
+      if (event["name"].as<std::string>() == name) events.push_back(event);
+    return events;
+  }
+
+  folly::test::TemporaryFile file_;
+};
+
+TEST_F(TracerTest, WriteSpansAndPairedWaits) {
+  static constexpr char kWait[] = "TestWait";
+  std::thread([] {
+    TraceSpan span("TestSpan", "LC", 3);
+    Tracer::Get().Enqueue(kWait, 3);
+    Tracer::Get().Enqueue(kWait, 4);
+  }).join();
+  // Waits end on other threads.
+  std::thread([] { Tracer::Get().Dequeue(kWait, 3); }).join();
+  std::thread([] { Tracer::Get().Dequeue(kWait, 4); }).join();
+
+  auto spans = ReadEvents("TestSpan");
+  ASSERT_EQ(spans.size(), 1);
+  EXPECT_EQ(spans[0]["ph"].as<std::string>(), "X");
+  EXPECT_EQ(spans[0]["cat"].as<std::string>(), "LC");
+  EXPECT_GE(spans[0]["dur"].as<int64_t>(), 0);
+  EXPECT_GE(spans[0]["ts"].as<int64_t>(), 0);
+  EXPECT_EQ(spans[0]["args"]["gid"].as<size_t>(), 3);
+
+  // One "b" and one "e" per gid, the "e" no earlier than the "b".
+  std::map<size_t, std::pair<int64_t, int64_t>> ts_by_id;
+  std::map<size_t, std::string> phases_by_id;
+  for (auto& event : ReadEvents(kWait)) {
+    EXPECT_EQ(event["cat"].as<std::string>(), "queue");
+    EXPECT_FALSE(event["dur"]);
+    size_t id = event["id"].as<size_t>();
+    EXPECT_EQ(event["args"]["gid"].as<size_t>(), id);
+    std::string ph = event["ph"].as<std::string>();
+    phases_by_id[id] += ph;
+    if (ph == "b")
+      ts_by_id[id].first = event["ts"].as<int64_t>();
+    else
+      ts_by_id[id].second = event["ts"].as<int64_t>();
+  }
+  ASSERT_EQ(phases_by_id.size(), 2);
+  for (auto& iter : phases_by_id) {
+    EXPECT_EQ(iter.second.size(), 2) << iter.first;
+    EXPECT_EQ(std::count(iter.second.begin(), iter.second.end(), 'b'), 1);
+    EXPECT_LE(ts_by_id[iter.first].first, ts_by_id[iter.first].second);
+  }
+}
+
+TEST_F(TracerTest, KeepLastSpansOnWraparound) {
+  const size_t num_spans = Tracer::kCapacity + 10;
+  std::thread([num_spans] {
+    for (size_t i = 0; i < num_spans; i++)
+      Tracer::Get().Record("TestWrap", "CC", i, 0, 1);
+  }).join();
+
+  // The oldest ones are overwritten, the others are written in order.
+  auto events = ReadEvents("TestWrap");
+  ASSERT_EQ(events.size(), Tracer::kCapacity);
+  for (size_t i = 0; i < events.size(); i++)
+    ASSERT_EQ(events[i]["args"]["gid"].as<size_t>(), i + 10) << i;
+}
+
+}  // namespace utility
+}  // namespace minigraph
@@ -0,0 +1,62 @@
+#include "utility/vertex_reorderer.h"
+
+#include <set>
+
+#include <gtest/gtest.h>
+
+namespace minigraph {
+namespace utility {
+
+using EdgeListT = graphs::EdgeList<unsigned, unsigned, unsigned, unsigned>;
+using ReordererT = VertexReorderer<unsigned, unsigned, unsigned, unsigned>;
+
+// A path 2 -> 9 -> 64 -> 7, a hub 5 linked to all of them, and a triangle
+// 30 -> 31 -> 33 -> 30 apart. Vids are sparse, 64 is the largest.
+static const unsigned kEdges[] = {2,  9,  9,  64, 64, 7,  5,  2,  5,  9, 64,
+                                  5,  7,  5,  30, 31, 31, 33, 33, 30, 2, 9};
+static const size_t kNumEdges = 11;
+static const std::set<unsigned> kVids = {2, 5, 7, 9, 30, 31, 33, 64};
+
+TEST(VertexReordererTest, RelabelsByPermutation) {
+  for (std::string order : {"degree", "rcm", "gorder"}) {
+    for (size_t cores : {1, 3}) {
+      EdgeListT graph(0, kNumEdges, 0, 64, (unsigned*)kEdges);
+      ReordererT reorderer(cores);
+      ASSERT_TRUE(reorderer.Reorder(&graph, order));
+      ASSERT_EQ(reorderer.get_num_vertexes(), kVids.size());
+      EXPECT_EQ(graph.get_max_vid(), kVids.size() - 1);
+
+      // New ids [0, n) map one to one onto the old ones.
+      unsigned* old_vid_by_new = reorderer.GetOldVidByNew();
+      std::set<unsigned> old_vids(old_vid_by_new,
+                                  old_vid_by_new + kVids.size());
+      EXPECT_EQ(old_vids, kVids) << order;
+
+      // Every edge is kept, only relabeled.
+      for (size_t i = 0; i < kNumEdges * 2; i++) {
+        ASSERT_LT(graph.buf_graph_[i], kVids.size());
+        EXPECT_EQ(old_vid_by_new[graph.buf_graph_[i]], kEdges[i]) << order;
+      }
+
+      if (order == "degree") {
+        // 5 and 9 have 4 edges, 2 and 64 have 3, ties keep the vid order.
+        EXPECT_EQ(old_vid_by_new[0], 5);
+        EXPECT_EQ(old_vid_by_new[1], 9);
+        EXPECT_EQ(old_vid_by_new[2], 2);
+        EXPECT_EQ(old_vid_by_new[3], 64);
+      }
+      free(graph.buf_graph_);
+    }
+  }
+}
+
+TEST(VertexReordererTest, UnknownOrder) {
+  EdgeListT graph(0, kNumEdges, 0, 64, (unsigned*)kEdges);
+  ReordererT reorderer;
+  EXPECT_FALSE(reorderer.Reorder(&graph, "random"));
+  EXPECT_EQ(graph.buf_graph_[0], 2);
+  free(graph.buf_graph_);
+}
+
+}  // namespace utility
+}  // namespace minigraph
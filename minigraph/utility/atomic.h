@@ -2,10 +2,24 @@
 #define ATOMIC_H
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
+
+// Failed cas() in write_min / write_max / write_add, counted only while
+// count_cas_retries is set by the metrics registry.
+inline std::atomic<size_t> cas_retries{0};
+inline std::atomic<bool> count_cas_retries{false};
+
+inline bool retry_cas() {
+  if (count_cas_retries.load(std::memory_order_relaxed))
+    cas_retries.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
 template <class ET>
 inline bool cas(ET* ptr, ET oldv, ET newv) {
   if (sizeof(ET) == 8) {
@@ -32,7 +46,7 @@ inline bool write_min(ET* a, ET b) {
   ET c;
   bool r = 0;
   do c = *a;
-  while (c > b && !(r = cas(a, c, b)));
+  while (c > b && !(r = cas(a, c, b)) && retry_cas());
   return r;
 }
 
@@ -41,7 +55,7 @@ inline bool write_max(ET* a, ET b) {
   ET c;
   bool r = 0;
   do c = *a;
-  while (c < b && !(r = cas(a, c, b)));
+  while (c < b && !(r = cas(a, c, b)) && retry_cas());
   return r;
 }
 
@@ -51,7 +65,7 @@ inline void write_add(ET* a, ET b) {
   do {
     oldV = *a;
     newV = oldV + b;
-  } while (!cas(a, oldV, newV));
+  } while (!cas(a, oldV, newV) && retry_cas());
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,292 @@
+#ifndef MINIGRAPH_UTILITY_COST_MODEL_H
+#define MINIGRAPH_UTILITY_COST_MODEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "portability/sys_data_structure.h"
+#include "rapidcsv.h"
+#include "utility/logging.h"
+#include "yaml-cpp/yaml.h"
+
+namespace minigraph {
+namespace utility {
+
+// CostModel predicts the elapsed time of PEval / IncEval on a fragment from
+// its StatisticInfo, as a linear function of
+//   sum_dlv, sum_dgv, sum_dlv_times_dlv, sum_dlv_times_dgv, sum_dgv_times_dgv,
+//   sum_out_border_vertexes, num_edges, num_vertexes, niters,
+//   n_active_vertexes
+// plus an intercept. PEval and IncEval scale differently, so there is one
+// such function per inc_type. Weights are fitted by least squares on the
+// tuples of inputs/training_data. All features count work, so weights are
+// kept non-negative: features getting a negative weight are dropped and the
+// remaining ones refitted. Without training data, the cost is the number of
+// edges plus vertexes.
+class CostModel {
+ public:
+  static constexpr size_t kNumFeatures = 10;
+  // inc_type 0 is PEval, 1 is IncEval.
+  static constexpr size_t kNumIncTypes = 2;
+
+  CostModel() {
+    std::vector<double> weights(kNumFeatures + 1, 0);
+    weights[7] = 1;
+    weights[8] = 1;
+    weights_.assign(kNumIncTypes, weights);
+  }
+
+  // Fit on the training files in pts, in the csv format of
+  // inputs/training_data.
+  bool Fit(const std::vector<std::string>& pts) {
+    std::vector<std::vector<double>> rows;
+    std::vector<double> ys;
+    std::vector<size_t> inc_types;
+    for (auto& pt : pts) {
+      if (!std::ifstream(pt).good()) {
+        XLOG(ERR, "Read file fault: ", pt);
+        return false;
+      }
+      rapidcsv::Document doc(pt, rapidcsv::LabelParams(),
+                             rapidcsv::SeparatorParams(','));
+      std::vector<std::vector<double>> columns;
+      for (auto& name : FeatureNames())
+        columns.push_back(doc.GetColumn<double>(name));
+      std::vector<double> elapsed_time = doc.GetColumn<double>("elapsed_time");
+      std::vector<size_t> inc_type = doc.GetColumn<size_t>("inc_type");
+      for (size_t i = 0; i < elapsed_time.size(); i++) {
+        std::vector<double> row(kNumFeatures);
+        for (size_t j = 0; j < kNumFeatures; j++) row[j] = columns[j][i];
+        rows.push_back(row);
+        ys.push_back(elapsed_time[i]);
+        inc_types.push_back(inc_type[i]);
+      }
+    }
+    return Fit(rows, ys, inc_types);
+  }
+
+  // Fit on rows of features, in the order above, and their elapsed times.
+  // Given the inc_type of each row, the model of each inc_type is fitted on
+  // its own rows, or on all of them if it has too few.
+  bool Fit(const std::vector<std::vector<double>>& rows,
+           const std::vector<double>& ys,
+           const std::vector<size_t>& inc_types = {}) {
+    if (!inc_types.empty() && inc_types.size() != rows.size()) {
+      XLOG(ERR, "CostModel: ", rows.size(), " tuples but ", inc_types.size(),
+           " inc_types");
+      return false;
+    }
+    std::vector<double> w;
+    if (!FitOne(rows, ys, &w)) return false;
+    weights_.assign(kNumIncTypes, w);
+    if (inc_types.empty()) return true;
+
+    for (size_t t = 0; t < kNumIncTypes; t++) {
+      std::vector<std::vector<double>> rows_t;
+      std::vector<double> ys_t;
+      for (size_t i = 0; i < rows.size(); i++) {
+        if (std::min(inc_types[i], kNumIncTypes - 1) != t) continue;
+        rows_t.push_back(rows[i]);
+        ys_t.push_back(ys[i]);
+      }
+      if (rows_t.size() <= kNumFeatures) {
+        LOG_INFO("CostModel: ", rows_t.size(), " tuples of inc_type ", t,
+                 ", use the model of all tuples.");
+        continue;
+      }
+      FitOne(rows_t, ys_t, &weights_[t]);
+    }
+    return true;
+  }
+
+  double Predict(const StatisticInfo& si) const {
+    return std::max(Weights(si)[0] + PredictVariable(si), 0.0);
+  }
+
+  // The part of Predict() that depends on the features. It is additive, so
+  // the cost of a fragment is the sum of the costs of its vertexes, but for
+  // niters, which is not a sum over vertexes.
+  double PredictVariable(const StatisticInfo& si) const {
+    double features[kNumFeatures] = {(double)si.sum_dlv,
+                                     (double)si.sum_dgv,
+                                     (double)si.sum_dlv_times_dlv,
+                                     (double)si.sum_dlv_times_dgv,
+                                     (double)si.sum_dgv_times_dgv,
+                                     (double)si.sum_out_border_vertexes,
+                                     (double)si.num_edges,
+                                     (double)si.num_vertexes,
+                                     (double)si.num_iters,
+                                     (double)si.num_active_vertexes};
+    auto& w = Weights(si);
+    double cost = 0;
+    for (size_t j = 0; j < kNumFeatures; j++) cost += w[j + 1] * features[j];
+    return cost;
+  }
+
+  // Write the fitted weights to pt as yaml, to be read back by Load().
+  bool Save(const std::string& pt) const {
+    std::ofstream fout(pt);
+    if (!fout) {
+      XLOG(ERR, "Write file fault: ", pt);
+      return false;
+    }
+    YAML::Node node;
+    auto names = FeatureNames();
+    for (size_t t = 0; t < kNumIncTypes; t++) {
+      YAML::Node model = node[IncTypeNames()[t]];
+      model["intercept"] = weights_[t][0];
+      for (size_t j = 0; j < kNumFeatures; j++)
+        model["weights"][names[j]] = weights_[t][j + 1];
+    }
+    fout << node << std::endl;
+    return true;
+  }
+
+  // Read a model written by Save(). A model without inc_types, as written
+  // before they were told apart, is used for both.
+  bool Load(const std::string& pt) {
+    YAML::Node node;
+    try {
+      node = YAML::LoadFile(pt);
+    } catch (YAML::Exception& e) {
+      XLOG(ERR, "Read file fault: ", pt);
+      return false;
+    }
+    auto names = FeatureNames();
+    std::vector<std::vector<double>> weights;
+    for (size_t t = 0; t < kNumIncTypes; t++) {
+      YAML::Node model = node[IncTypeNames()[t]] ? node[IncTypeNames()[t]]
+                                                 : node;
+      if (!model["intercept"] || !model["weights"]) {
+        XLOG(ERR, "CostModel: Malformed model: ", pt);
+        return false;
+      }
+      std::vector<double> w(kNumFeatures + 1, 0);
+      w[0] = model["intercept"].as<double>();
+      for (size_t j = 0; j < kNumFeatures; j++)
+        if (model["weights"][names[j]])
+          w[j + 1] = model["weights"][names[j]].as<double>();
+      weights.push_back(w);
+    }
+    weights_ = weights;
+    return true;
+  }
+
+  // Weight of feature i, in the order above, without the intercept.
+  double get_weight(const size_t i, const size_t inc_type = 0) const {
+    return weights_[std::min(inc_type, kNumIncTypes - 1)][i + 1];
+  }
+  double get_intercept(const size_t inc_type = 0) const {
+    return weights_[std::min(inc_type, kNumIncTypes - 1)][0];
+  }
+
+ private:
+  // weights_[inc_type][0] is the intercept.
+  std::vector<std::vector<double>> weights_;
+
+  static std::vector<std::string> FeatureNames() {
+    return {"sum_dlv",           "sum_dgv",
+            "sum_dlv_times_dlv", "sum_dlv_times_dgv",
+            "sum_dgv_times_dgv", "sum_out_border_vertexes",
+            "num_edges",         "num_vertexes",
+            "niters",            "n_active_vertexes"};
+  }
+
+  static std::vector<std::string> IncTypeNames() {
+    return {"peval", "inceval"};
+  }
+
+  const std::vector<double>& Weights(const StatisticInfo& si) const {
+    return weights_[std::min(si.inc_type, kNumIncTypes - 1)];
+  }
+
+  static double PredictRow(const std::vector<double>& w,
+                           const std::vector<double>& row) {
+    double cost = w[0];
+    for (size_t j = 0; j < kNumFeatures; j++) cost += w[j + 1] * row[j];
+    return std::max(cost, 0.0);
+  }
+
+  static bool FitOne(const std::vector<std::vector<double>>& rows,
+                     const std::vector<double>& ys, std::vector<double>* out) {
+    if (rows.size() <= kNumFeatures) {
+      XLOG(ERR, "CostModel: Too few training tuples: ", rows.size());
+      return false;
+    }
+    // Columns are scaled by their max to keep the normal equations sane.
+    std::vector<double> scale(kNumFeatures, 1);
+    for (auto& row : rows)
+      for (size_t j = 0; j < kNumFeatures; j++)
+        scale[j] = std::max(scale[j], std::fabs(row[j]));
+
+    std::vector<bool> active(kNumFeatures + 1, true);
+    std::vector<double> w;
+    while (true) {
+      w = Solve(rows, ys, scale, active);
+      size_t worst = 0;
+      for (size_t j = 1; j <= kNumFeatures; j++)
+        if (active[j] && w[j] < w[worst]) worst = j;
+      if (worst == 0 || w[worst] >= 0) break;
+      active[worst] = false;
+    }
+    // The intercept may stay negative, predictions are clamped at 0.
+    for (size_t j = 1; j <= kNumFeatures; j++) w[j] /= scale[j - 1];
+    *out = w;
+
+    double sse = 0, sst = 0, mean = 0;
+    for (auto y : ys) mean += y / ys.size();
+    for (size_t i = 0; i < rows.size(); i++) {
+      double e = PredictRow(w, rows[i]) - ys[i];
+      sse += e * e;
+      sst += (ys[i] - mean) * (ys[i] - mean);
+    }
+    LOG_INFO("CostModel: fitted on ", rows.size(),
+             " tuples, R^2: ", sst > 0 ? 1 - sse / sst : 1);
+    return true;
+  }
+
+  // Least squares over the active columns, by Gaussian elimination on the
+  // normal equations with a tiny ridge. Column 0 is the intercept.
+  static std::vector<double> Solve(const std::vector<std::vector<double>>& rows,
+                                   const std::vector<double>& ys,
+                                   const std::vector<double>& scale,
+                                   const std::vector<bool>& active) {
+    const size_t d = kNumFeatures + 1;
+    std::vector<std::vector<double>> a(d, std::vector<double>(d + 1, 0));
+    std::vector<double> x(d);
+    for (size_t i = 0; i < rows.size(); i++) {
+      x[0] = 1;
+      for (size_t j = 1; j < d; j++)
+        x[j] = active[j] ? rows[i][j - 1] / scale[j - 1] : 0;
+      for (size_t r = 0; r < d; r++) {
+        for (size_t c = 0; c < d; c++) a[r][c] += x[r] * x[c];
+        a[r][d] += x[r] * ys[i];
+      }
+    }
+    for (size_t r = 0; r < d; r++) a[r][r] += active[r] ? 1e-9 : 1;
+
+    for (size_t c = 0; c < d; c++) {
+      size_t pivot = c;
+      for (size_t r = c + 1; r < d; r++)
+        if (std::fabs(a[r][c]) > std::fabs(a[pivot][c])) pivot = r;
+      std::swap(a[c], a[pivot]);
+      for (size_t r = 0; r < d; r++) {
+        if (r == c || a[c][c] == 0) continue;
+        double f = a[r][c] / a[c][c];
+        for (size_t k = c; k <= d; k++) a[r][k] -= f * a[c][k];
+      }
+    }
+    std::vector<double> w(d, 0);
+    for (size_t r = 0; r < d; r++)
+      if (active[r] && a[r][r] != 0) w[r] = a[r][d] / a[r][r];
+    return w;
+  }
+};
+
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_COST_MODEL_H
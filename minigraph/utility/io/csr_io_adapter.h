@@ -2,6 +2,7 @@
 #define MINIGRAPH_UTILITY_IO_CSR_IO_ADAPTER_H
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -11,6 +12,7 @@
 #include <folly/AtomicHashMap.h>
 #include <folly/FileUtil.h>
 
+#include "graphs/csr_builder.h"
 #include "graphs/immutable_csr.h"
 #include "io_adapter_base.h"
 #include "portability/sys_data_structure.h"
@@ -84,148 +86,17 @@ class CSRIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
     return tag;
   }
 
+  // Convert an edge list to a CSR graph with graphs::CSRBuilder, i.e. degree
+  // count, prefix sum and a parallel scatter into the final arrays.
   CSR_T* EdgeList2CSR(const GID_T gid = 0,
                       EDGE_LIST_T* edgelist_graph = nullptr,
                       const size_t cores = 1, VID_T* vid_map = nullptr) {
     assert(edgelist_graph != nullptr);
     LOG_INFO("EdgeList2CSR()");
-    auto thread_pool = CPUThreadPool(cores, 1);
-    std::mutex mtx;
-    std::condition_variable finish_cv;
-    std::unique_lock<std::mutex> lck(mtx);
-
-    VID_T aligned_max_vid =
-        ceil(edgelist_graph->get_aligned_max_vid() / ALIGNMENT_FACTOR) *
-        ALIGNMENT_FACTOR;
-
-    std::atomic<size_t> pending_packages(cores);
-    LOG_INFO("Aligned max vid: ", aligned_max_vid, "  ",
-             edgelist_graph->get_max_vid());
-
-    size_t* num_in_edges = (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
-    size_t* num_out_edges = (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
-    memset(num_in_edges, 0, sizeof(size_t) * aligned_max_vid);
-    memset(num_out_edges, 0, sizeof(size_t) * aligned_max_vid);
-
-    Bitmap* vertex_indicator = new Bitmap(aligned_max_vid);
-    vertex_indicator->clear();
-
-    size_t num_vertexes = edgelist_graph->get_num_vertexes();
-    size_t num_edges = edgelist_graph->get_num_edges();
-
-    LOG_INFO(
-        "Run: Go through every edges to count the size of each vertex. "
-        "NumEdges: ",
-        num_edges);
-    pending_packages.store(cores);
-    for (size_t tid = 0; tid < cores; tid++) {
-      thread_pool.Commit([tid, &cores, &num_in_edges, &num_out_edges,
-                          &num_edges, &edgelist_graph, &vertex_indicator,
-                          &pending_packages, &finish_cv, &num_vertexes]() {
-        for (size_t j = tid; j < num_edges; j += cores) {
-          auto src_vid = edgelist_graph->buf_graph_[j * 2];
-          auto dst_vid = edgelist_graph->buf_graph_[j * 2 + 1];
-          if (!vertex_indicator->get_bit(src_vid)) {
-            vertex_indicator->set_bit(src_vid);
-          }
-          if (!vertex_indicator->get_bit(dst_vid)) {
-            vertex_indicator->set_bit(dst_vid);
-          }
-          __sync_add_and_fetch(num_out_edges + src_vid, 1);
-          __sync_add_and_fetch(num_in_edges + dst_vid, 1);
-        }
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
-    }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
-
-    graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>** vertexes = nullptr;
-    vertexes = (graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>**)malloc(
-        sizeof(graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>*) * aligned_max_vid);
-
-    for (size_t i = 0; i < aligned_max_vid; i++) vertexes[i] = nullptr;
-
-    VID_T local_id = 0;
-
-    LOG_INFO("Run: Merge edges");
-    pending_packages.store(cores);
-    for (size_t tid = 0; tid < cores; tid++) {
-      thread_pool.Commit([this, tid, &local_id, &cores, &num_in_edges, &vid_map,
-                          &num_out_edges, &aligned_max_vid, &vertex_indicator,
-                          &vertexes, &pending_packages, &finish_cv]() {
-        for (VID_T global_id = tid; global_id < aligned_max_vid;
-             global_id += cores) {
-          if (!vertex_indicator->get_bit(global_id)) continue;
-          auto u = new graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>();
-          u->vid = __sync_fetch_and_add(&local_id, 1);
-          if (vid_map != nullptr) vid_map[global_id] = u->vid;
-          u->indegree = num_in_edges[global_id];
-          u->outdegree = num_out_edges[global_id];
-          u->in_edges = (VID_T*)malloc(sizeof(VID_T) * (u->indegree));
-          memset(u->in_edges, 0, sizeof(VID_T) * (u->indegree));
-          u->out_edges = (VID_T*)malloc(sizeof(VID_T) * (u->outdegree));
-          memset(u->out_edges, 0, sizeof(VID_T) * (u->outdegree));
-          vertexes[global_id] = u;
-          LOG_INFO(u->vid, " ", global_id);
-        }
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
-    }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
-
-    LOG_INFO("Run: Edges fill");
-    size_t sum_in_edges = 0, sum_out_edges = 0;
-    size_t* offset_in_edges = (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
-    size_t* offset_out_edges =
-        (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
-    memset(offset_in_edges, 0, sizeof(size_t) * aligned_max_vid);
-    memset(offset_out_edges, 0, sizeof(size_t) * aligned_max_vid);
-    pending_packages.store(cores);
-    for (size_t i = 0; i < cores; i++) {
-      size_t tid = i;
-      thread_pool.Commit([tid, &cores, &num_in_edges, &num_out_edges,
-                          &num_edges, &offset_in_edges, &offset_out_edges,
-                          sum_in_edges, sum_out_edges, &edgelist_graph,
-                          &vertex_indicator, &vertexes, &pending_packages,
-                          &finish_cv]() {
-        for (VID_T global_eid = tid; global_eid < num_edges;
-             global_eid += cores) {
-          auto src_vid = edgelist_graph->buf_graph_[global_eid * 2];
-          auto dst_vid = edgelist_graph->buf_graph_[global_eid * 2 + 1];
-          assert(vertexes[src_vid] != nullptr);
-          assert(vertexes[dst_vid] != nullptr);
-          vertexes[src_vid]
-              ->out_edges[__sync_fetch_and_add(offset_out_edges + src_vid, 1)] =
-              dst_vid;
-          vertexes[dst_vid]
-              ->in_edges[__sync_fetch_and_add(offset_in_edges + dst_vid, 1)] =
-              src_vid;
-        }
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
-    }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
-
-    LOG_INFO("Run: Compute sum_in_edges & sum_out_edges");
-    for (VID_T global_id = 0; global_id < aligned_max_vid; global_id++) {
-      if (!vertex_indicator->get_bit(global_id)) continue;
-      auto u = vertexes[global_id];
-      __sync_fetch_and_add(&sum_in_edges, u->indegree);
-      __sync_fetch_and_add(&sum_out_edges, u->outdegree);
-    }
-
-    LOG_INFO("Run: Construct graph");
-    auto csr_graph = new graphs::ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>(
-        gid, vertexes, edgelist_graph->num_vertexes_, sum_in_edges,
-        sum_out_edges, edgelist_graph->max_vid_);
-    delete offset_out_edges;
-    delete offset_in_edges;
-    delete num_in_edges;
-    delete num_out_edges;
-    return csr_graph;
+    graphs::CSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T> csr_builder(
+        edgelist_graph->buf_graph_, edgelist_graph->get_num_edges(),
+        edgelist_graph->get_max_vid(), cores);
+    return csr_builder.Build(gid, nullptr, vid_map);
   }
 
  private:
@@ -332,6 +203,8 @@ class CSRIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
     size_t total_size = 0;
     size_t* buf_meta = (size_t*)malloc(sizeof(size_t) * 3);
     size_t buff_metta[3] = {0};
+    // Entries of localid_by_globalid_ in the data file.
+    size_t num_localid_by_globalid = 0;
     {
       std::ifstream meta_file(meta_pt, std::ios::binary | std::ios::app);
 
@@ -346,8 +219,17 @@ class CSRIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
       assert(graph->get_num_vertexes() > 0);
       // read bitmap
       meta_file.read((char*)&graph->max_vid_, sizeof(VID_T));
+      // Meta files written before the count was stored held
+      // ceil(max_vid / 64) * 64 entries, one short if max_vid % 64 == 0.
+      meta_file.read((char*)&num_localid_by_globalid, sizeof(size_t));
+      if (meta_file.gcount() != sizeof(size_t))
+        num_localid_by_globalid =
+            ceil(graph->get_max_vid() / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
       graph->aligned_max_vid_ =
-          ceil(graph->get_max_vid() / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+          ceil(((size_t)graph->get_max_vid() + 1) / ALIGNMENT_FACTOR) *
+          ALIGNMENT_FACTOR;
+      num_localid_by_globalid = std::min(num_localid_by_globalid,
+                                         graph->get_aligned_max_vid());
       assert(graph->get_aligned_max_vid() > 0);
       graph->bitmap_ = new Bitmap(graph->get_aligned_max_vid());
       graph->bitmap_->clear();
@@ -380,7 +262,10 @@ class CSRIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
 
       std::ifstream data_file(data_pt, std::ios::binary | std::ios::app);
       graph->buf_graph_ = (VID_T*)malloc(total_size);
-      data_file.read((char*)graph->buf_graph_, total_size);
+      size_t read_size =
+          start_localid_by_globalid + sizeof(VID_T) * num_localid_by_globalid;
+      memset((char*)graph->buf_graph_ + read_size, 0, total_size - read_size);
+      data_file.read((char*)graph->buf_graph_, read_size);
       graph->globalid_by_index_ =
           (VID_T*)((char*)graph->buf_graph_ + start_globalid);
       graph->out_offset_ =
@@ -447,12 +332,13 @@ class CSRIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
       buf_meta[2] = graph.sum_out_edges_;
       meta_file.write((char*)buf_meta, sizeof(size_t) * 3);
       meta_file.write((char*)&graph.max_vid_, sizeof(VID_T));
+      size_t num_localid_by_globalid = graph.get_aligned_max_vid();
+      meta_file.write((char*)&num_localid_by_globalid, sizeof(size_t));
       free(buf_meta);
       meta_file.close();
 
       // write data
       std::ofstream data_file(data_pt, std::ios::binary | std::ios::app);
-      size_t size_localid = sizeof(VID_T) * graph.get_num_vertexes();
       size_t size_globalid = sizeof(VID_T) * graph.get_num_vertexes();
       size_t size_localid_by_globalid =
           sizeof(VID_T) * graph.get_aligned_max_vid();
@@ -463,10 +349,9 @@ class CSRIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
       size_t size_in_edges = sizeof(VID_T) * graph.sum_in_edges_;
       size_t size_out_edges = sizeof(VID_T) * graph.sum_out_edges_;
 
-      size_t total_size = size_localid + size_globalid + size_in_offset +
-                          size_indegree + size_outdegree + size_out_offset +
-                          size_in_edges + size_out_edges +
-                          size_localid_by_globalid;
+      size_t total_size = size_globalid + size_in_offset + size_indegree +
+                          size_outdegree + size_out_offset + size_in_edges +
+                          size_out_edges + size_localid_by_globalid;
       data_file.write((char*)graph.buf_graph_, total_size);
       data_file.close();
     }
@@ -0,0 +1,330 @@
+#ifndef MINIGRAPH_UTILITY_IO_CSV_EDGE_PARSER_H
+#define MINIGRAPH_UTILITY_IO_CSV_EDGE_PARSER_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <string>
+
+#include "utility/atomic.h"
+#include "utility/logging.h"
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace utility {
+namespace io {
+
+// CSVEdgeParser maps an edge list file, i.e. lines of <src, dst[, weight]>,
+// into memory and parses it with multiple threads. The file is cut into
+// one chunk per core on newline boundaries. Parsing takes two passes: the
+// first counts lines per chunk to get each chunk's output offset, the second
+// converts the numbers and writes them straight into the caller's buffers.
+// A line is <src><separator><dst>[<separator>...], where ids are unsigned
+// integers fitting in VID_T, with blanks around them ignored. Blank lines
+// and lines starting with '#' or '%' are skipped; any other line is
+// malformed, and fails the parse.
+// The whole file is parsed at once by default; NextWindow() instead walks it
+// in windows of a bounded number of lines for out-of-core consumers.
+template <typename VID_T>
+class CSVEdgeParser {
+ public:
+  CSVEdgeParser(const std::string& pt, const size_t cores = 1,
+                const char separator = ',') {
+    pt_ = pt;
+    cores_ = cores == 0 ? 1 : cores;
+    separator_ = separator;
+  }
+
+  ~CSVEdgeParser() { Close(); }
+
+  bool Open() {
+    fd_ = open(pt_.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      XLOG(ERR, "Open file fault: ", pt_);
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+      XLOG(ERR, "Stat file fault: ", pt_);
+      Close();
+      return false;
+    }
+    size_ = st.st_size;
+    if (size_ == 0) return true;
+    data_ = (char*)mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data_ == MAP_FAILED) {
+      XLOG(ERR, "Mmap file fault: ", pt_);
+      data_ = nullptr;
+      Close();
+      return false;
+    }
+    madvise(data_, size_, MADV_SEQUENTIAL);
+    SplitChunks(0, size_);
+    return true;
+  }
+
+  // Move the parsing window to the next (at most) max_lines lines. Returns
+  // false once the end of file is reached.
+  bool NextWindow(const size_t max_lines) {
+    if (data_ == nullptr || cursor_ >= size_) return false;
+    size_t begin = cursor_;
+    size_t end = cursor_;
+    for (size_t count = 0; count < max_lines && end < size_; count++) {
+      const char* nl = (const char*)memchr(data_ + end, '\n', size_ - end);
+      end = nl == nullptr ? size_ : nl - data_ + 1;
+    }
+    // Pages of the previous window won't be touched again.
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t release = begin / page * page;
+    if (release > released_) {
+      madvise(data_ + released_, release - released_, MADV_DONTNEED);
+      released_ = release;
+    }
+    cursor_ = end;
+    SplitChunks(begin, end);
+    return true;
+  }
+
+  void Close() {
+    if (data_ != nullptr) munmap(data_, size_);
+    if (fd_ >= 0) close(fd_);
+    if (chunk_begin_ != nullptr) free(chunk_begin_);
+    if (chunk_offset_ != nullptr) free(chunk_offset_);
+    data_ = nullptr;
+    fd_ = -1;
+    chunk_begin_ = nullptr;
+    chunk_offset_ = nullptr;
+    cursor_ = 0;
+    released_ = 0;
+  }
+
+  // Upper bound of the number of edges in the current window, i.e. the number
+  // of lines. Used to size the output buffers before calling Parse().
+  size_t CountEdges() {
+    if (data_ == nullptr) return 0;
+    if (chunk_offset_ != nullptr) return chunk_offset_[num_chunks_];
+    chunk_offset_ = (size_t*)malloc(sizeof(size_t) * (num_chunks_ + 1));
+    memset(chunk_offset_, 0, sizeof(size_t) * (num_chunks_ + 1));
+
+    ForEachChunk([this](size_t k) {
+      const char* p = data_ + chunk_begin_[k];
+      const char* end = data_ + chunk_begin_[k + 1];
+      size_t count = 0;
+      while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        count++;
+        if (nl == nullptr) break;
+        p = nl + 1;
+      }
+      chunk_offset_[k + 1] = count;
+    });
+    for (size_t k = 0; k < num_chunks_; k++)
+      chunk_offset_[k + 1] += chunk_offset_[k];
+    return chunk_offset_[num_chunks_];
+  }
+
+  // Parse all edges. The i-th edge is written to src[i * stride] and
+  // dst[i * stride], so that stride = 2 with dst = src + 1 fills an
+  // interleaved buf_graph_ and stride = 1 fills two separate arrays. Both
+  // must hold at least CountEdges() * stride elements. num_edges receives
+  // the number of edges written, and max_vid, if provided, the maximum vid.
+  // Returns false if a line is malformed.
+  bool Parse(VID_T* src, VID_T* dst, size_t* num_edges,
+             const size_t stride = 2, VID_T* max_vid = nullptr,
+             const bool skip_self_loops = false) {
+    *num_edges = 0;
+    if (data_ == nullptr) return true;
+    CountEdges();
+    size_t* num_parsed = (size_t*)malloc(sizeof(size_t) * num_chunks_);
+    memset(num_parsed, 0, sizeof(size_t) * num_chunks_);
+    // Offset of the first malformed line of each chunk, if any.
+    size_t* malformed = (size_t*)malloc(sizeof(size_t) * num_chunks_);
+    VID_T global_max_vid = 0;
+
+    ForEachChunk([this, src, dst, stride, skip_self_loops, &num_parsed,
+                  &malformed, &global_max_vid](size_t k) {
+      const char* p = data_ + chunk_begin_[k];
+      const char* end = data_ + chunk_begin_[k + 1];
+      size_t offset = chunk_offset_[k];
+      size_t count = 0;
+      VID_T local_max_vid = 0;
+      malformed[k] = size_;
+      while (p < end) {
+        const char* line = p;
+        VID_T s, d;
+        char kind = ParseLine(p, end, &s, &d);
+        if (kind == kMalformed) {
+          malformed[k] = line - data_;
+          break;
+        }
+        if (kind == kSkipped || (skip_self_loops && s == d)) continue;
+        src[(offset + count) * stride] = s;
+        dst[(offset + count) * stride] = d;
+        local_max_vid < s ? local_max_vid = s : 0;
+        local_max_vid < d ? local_max_vid = d : 0;
+        count++;
+      }
+      num_parsed[k] = count;
+      write_max(&global_max_vid, local_max_vid);
+    });
+
+    size_t first_malformed = size_;
+    for (size_t k = 0; k < num_chunks_; k++)
+      first_malformed = std::min(first_malformed, malformed[k]);
+    free(malformed);
+    if (first_malformed < size_) {
+      const char* line = data_ + first_malformed;
+      const char* nl =
+          (const char*)memchr(line, '\n', size_ - first_malformed);
+      size_t len = nl == nullptr ? size_ - first_malformed : nl - line;
+      XLOG(ERR, "Malformed edge in ", pt_, " at byte ", first_malformed, ": ",
+           std::string(line, std::min(len, (size_t)64)));
+      free(num_parsed);
+      return false;
+    }
+
+    // Close the gaps left by skipped lines. Chunks only move towards the
+    // front, so a forward copy is safe.
+    size_t n = 0;
+    for (size_t k = 0; k < num_chunks_; k++) {
+      if (n != chunk_offset_[k]) {
+        for (size_t i = 0; i < num_parsed[k]; i++) {
+          src[(n + i) * stride] = src[(chunk_offset_[k] + i) * stride];
+          dst[(n + i) * stride] = dst[(chunk_offset_[k] + i) * stride];
+        }
+      }
+      n += num_parsed[k];
+    }
+    free(num_parsed);
+    *num_edges = n;
+    if (max_vid != nullptr) *max_vid = global_max_vid;
+    LOG_INFO("Parse ", pt_, " size: ", size_, " bytes, num_edges: ", n,
+             " max_vid: ", global_max_vid);
+    return true;
+  }
+
+  size_t get_file_size() const { return size_; }
+
+ private:
+  // What ParseLine() makes of a line.
+  static constexpr char kEdge = 0;
+  static constexpr char kSkipped = 1;
+  static constexpr char kMalformed = 2;
+
+  std::string pt_;
+  size_t cores_ = 1;
+  char separator_ = ',';
+  int fd_ = -1;
+  char* data_ = nullptr;
+  size_t size_ = 0;
+
+  size_t cursor_ = 0;
+  size_t released_ = 0;
+
+  size_t num_chunks_ = 0;
+  size_t* chunk_begin_ = nullptr;
+  size_t* chunk_offset_ = nullptr;
+
+  void SplitChunks(const size_t begin, const size_t end) {
+    num_chunks_ = cores_;
+    if (chunk_begin_ == nullptr)
+      chunk_begin_ = (size_t*)malloc(sizeof(size_t) * (num_chunks_ + 1));
+    if (chunk_offset_ != nullptr) free(chunk_offset_);
+    chunk_offset_ = nullptr;
+    chunk_begin_[0] = begin;
+    chunk_begin_[num_chunks_] = end;
+    for (size_t k = 1; k < num_chunks_; k++) {
+      size_t pos = begin + (end - begin) / num_chunks_ * k;
+      if (pos < chunk_begin_[k - 1]) pos = chunk_begin_[k - 1];
+      const char* nl = (const char*)memchr(data_ + pos, '\n', end - pos);
+      chunk_begin_[k] = nl == nullptr ? end : nl - data_ + 1;
+    }
+  }
+
+  template <typename F>
+  void ForEachChunk(F&& f) {
+    if (num_chunks_ == 1) {
+      f(0);
+      return;
+    }
+    auto thread_pool = CPUThreadPool(cores_, 1);
+    std::mutex mtx;
+    std::condition_variable finish_cv;
+    std::unique_lock<std::mutex> lck(mtx);
+    std::atomic<size_t> pending_packages(num_chunks_);
+    for (size_t k = 0; k < num_chunks_; k++) {
+      thread_pool.Commit([k, &f, &pending_packages, &finish_cv]() {
+        f(k);
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
+    }
+    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+  }
+
+  static inline bool IsDigit(const char c) {
+    return (unsigned char)(c - '0') < 10;
+  }
+
+  // Blanks around ids, unless used as the separator.
+  inline bool IsBlank(const char c) const {
+    return c != separator_ && (c == ' ' || c == '\t' || c == '\r');
+  }
+
+  inline void SkipBlanks(const char*& p, const char* end) const {
+    while (p < end && IsBlank(*p)) p++;
+  }
+
+  // Parse an unsigned integer at p into id, and leave p right after it.
+  // Returns false if there is none, or it does not fit in VID_T.
+  static inline bool ParseId(const char*& p, const char* end, VID_T* id) {
+    if (p == end || !IsDigit(*p)) return false;
+    VID_T v = 0;
+    do {
+      VID_T digit = *p - '0';
+      if (v > (std::numeric_limits<VID_T>::max() - digit) / 10) return false;
+      v = v * 10 + digit;
+      p++;
+    } while (p < end && IsDigit(*p));
+    *id = v;
+    return true;
+  }
+
+  // Parse one line starting at p and leave p at the beginning of the next
+  // line. Returns kSkipped for comments and blank lines.
+  inline char ParseLine(const char*& p, const char* end, VID_T* src,
+                        VID_T* dst) const {
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    const char* eol = nl == nullptr ? end : nl;
+    const char* q = p;
+    p = nl == nullptr ? end : nl + 1;
+    SkipBlanks(q, eol);
+    if (q == eol || *q == '#' || *q == '%') return kSkipped;
+    if (!ParseId(q, eol, src)) return kMalformed;
+    SkipBlanks(q, eol);
+    if (q == eol || *q != separator_) return kMalformed;
+    // Runs of a blank separator, e.g. aligned columns, count as one.
+    do {
+      q++;
+    } while (q < eol && *q == separator_ &&
+             (separator_ == ' ' || separator_ == '\t'));
+    SkipBlanks(q, eol);
+    if (!ParseId(q, eol, dst)) return kMalformed;
+    SkipBlanks(q, eol);
+    return q == eol || *q == separator_ ? kEdge : kMalformed;
+  }
+};
+
+}  // namespace io
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_IO_CSV_EDGE_PARSER_H
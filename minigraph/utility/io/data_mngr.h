@@ -1,6 +1,8 @@
 #ifndef MINIGRAPH_DATA_MNGR_H
 #define MINIGRAPH_DATA_MNGR_H
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 
 #include <folly/AtomicHashMap.h>
@@ -9,6 +11,8 @@
 #include "utility/io/csr_io_adapter.h"
 #include "utility/io/edge_list_io_adapter.h"
 #include "utility/io/relation_io_adapter.h"
+#include "utility/metrics.h"
+#include "utility/numa.h"
 
 namespace minigraph {
 namespace utility {
@@ -50,8 +54,11 @@ class DataMngr {
 
   bool ReadGraph(const GID_T& gid, const Path& path,
                  const GraphFormat& graph_format, char separator_params = ',') {
+    auto start_time = std::chrono::system_clock::now();
     bool out = false;
     GRAPH_BASE_T* graph = nullptr;
+    // Buffers of the fragment are first touched on its node.
+    NUMANodeBinding binding(NUMANodeOf(gid));
     if (graph_format == csr_bin) {
       graph = new CSR_T;
       out = csr_io_adapter_->Read((GRAPH_BASE_T*)graph, csr_bin, gid,
@@ -76,17 +83,35 @@ class DataMngr {
       } else
         pgraph_by_gid_->insert(std::make_pair(gid, (GRAPH_BASE_T*)graph));
       pgraph_mtx_->unlock();
+      size_t bytes =
+          GetFileSize(path.meta_pt) + GetFileSize(path.data_pt) +
+          (graph_format == relation_bin ? 0 : GetFileSize(path.vdata_pt));
+      bytes_read_.fetch_add(bytes);
+      Metrics::Get().Add("minigraph_read_bytes_total", bytes, gid);
     }
+    read_time_.fetch_add(GetMicroseconds(start_time));
     return out;
   }
 
   bool WriteGraph(const GID_T& gid, const Path& path,
                   const GraphFormat& graph_format, bool vdata_only = false) {
     if (graph_format == csr_bin) {
+      auto start_time = std::chrono::system_clock::now();
       auto graph = this->GetGraph(gid);
-      return csr_io_adapter_->Write(*((GRAPH_BASE_T*)graph), csr_bin,
-                                    vdata_only, path.meta_pt, path.data_pt,
-                                    path.vdata_pt);
+      bool out = csr_io_adapter_->Write(*((GRAPH_BASE_T*)graph), csr_bin,
+                                        vdata_only, path.meta_pt, path.data_pt,
+                                        path.vdata_pt);
+      if (out) {
+        size_t bytes =
+            GetFileSize(path.vdata_pt) +
+            (vdata_only
+                 ? 0
+                 : GetFileSize(path.meta_pt) + GetFileSize(path.data_pt));
+        bytes_written_.fetch_add(bytes);
+        Metrics::Get().Add("minigraph_written_bytes_total", bytes, gid);
+      }
+      write_time_.fetch_add(GetMicroseconds(start_time));
+      return out;
     } else if (graph_format == edgelist_bin) {
       return false;
     } else if (graph_format == relation_bin) {
@@ -359,6 +384,13 @@ class DataMngr {
     return (stat(pt.c_str(), &buffer) == 0);
   }
 
+  // I/O of ReadGraph() / WriteGraph() so far: bytes of the files read or
+  // written, and time in seconds summed over threads.
+  size_t get_bytes_read() const { return bytes_read_.load(); }
+  size_t get_bytes_written() const { return bytes_written_.load(); }
+  double get_read_time() const { return read_time_.load() / 1000000.0; }
+  double get_write_time() const { return write_time_.load() / 1000000.0; }
+
   void InitWorkList(const std::string& work_space) {
     std::string meta_root = work_space + "minigraph_meta/";
     std::string data_root = work_space + "minigraph_data/";
@@ -437,6 +469,24 @@ class DataMngr {
   std::unique_ptr<folly::AtomicHashMap<GID_T, GRAPH_BASE_T*>> pgraph_by_gid_ =
       nullptr;
   std::mutex* pgraph_mtx_ = nullptr;
+
+  std::atomic<size_t> bytes_read_{0};
+  std::atomic<size_t> bytes_written_{0};
+  // In microseconds.
+  std::atomic<size_t> read_time_{0};
+  std::atomic<size_t> write_time_{0};
+
+  static size_t GetFileSize(const std::string& pt) {
+    struct stat buffer;
+    return stat(pt.c_str(), &buffer) == 0 ? buffer.st_size : 0;
+  }
+
+  static size_t GetMicroseconds(
+      const std::chrono::system_clock::time_point& start_time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now() - start_time)
+        .count();
+  }
 };
 
 }  // namespace io
@@ -3,13 +3,12 @@
 
 #include "graphs/edgelist.h"
 #include "io_adapter_base.h"
+#include "utility/io/csv_edge_parser.h"
 #include "portability/sys_data_structure.h"
 #include "portability/sys_types.h"
 #include "utility/atomic.h"
 #include "utility/thread_pool.h"
 
-#include "rapidcsv.h"
-
 #include <sys/stat.h>
 #include <filesystem>
 #include <fstream>
@@ -122,41 +121,39 @@ class EdgeListIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
       XLOG(ERR, "segmentation fault: graph is nullptr");
       return false;
     }
-    // auto edge_list = (EDGE_LIST_T*)graph;
-    rapidcsv::Document doc(pt, rapidcsv::LabelParams(-1, -1),
-                           rapidcsv::SeparatorParams(separator_params));
-    std::vector<VID_T> src = doc.GetColumn<VID_T>(0);
-    std::vector<VID_T> dst = doc.GetColumn<VID_T>(1);
-    ((EDGE_LIST_T*)graph)->buf_graph_ =
-        (vid_t*)malloc(sizeof(vid_t) * (src.size() + dst.size()));
-
-    VID_T* buff = (VID_T*)((EDGE_LIST_T*)graph)->buf_graph_;
-    memset((char*)buff, 0, sizeof(VID_T) * (src.size() + dst.size()));
-    LOG_INFO("num edges: ", src.size(), " sizeof(VID_T)", sizeof(VID_T));
-    for (size_t i = 0; i < src.size(); i++) {
-      *((VID_T*)((EDGE_LIST_T*)graph)->buf_graph_ + i * 2) = src.at(i);
-      *((VID_T*)((EDGE_LIST_T*)graph)->buf_graph_ + i * 2 + 1) = dst.at(i);
+    CSVEdgeParser<VID_T> parser(pt, 1, separator_params);
+    if (!parser.Open()) return false;
+    size_t num_edges = parser.CountEdges();
+    VID_T* buff = (VID_T*)malloc(sizeof(VID_T) * num_edges * 2);
+    if (!parser.Parse(buff, buff + 1, &num_edges)) {
+      free(buff);
+      return false;
     }
+    ((EDGE_LIST_T*)graph)->buf_graph_ = buff;
+    parser.Close();
+    LOG_INFO("num edges: ", num_edges, " sizeof(VID_T)", sizeof(VID_T));
     if (assemble) {
       std::unordered_map<VID_T, std::vector<VID_T>*> graph_out_edges;
       std::unordered_map<VID_T, std::vector<VID_T>*> graph_in_edges;
 
-      for (size_t i = 0; i < src.size(); i++) {
-        auto iter = graph_out_edges.find(src.at(i));
+      for (size_t i = 0; i < num_edges; i++) {
+        VID_T src = buff[i * 2];
+        VID_T dst = buff[i * 2 + 1];
+        auto iter = graph_out_edges.find(src);
         if (iter != graph_out_edges.end()) {
-          iter->second->push_back(dst.at(i));
+          iter->second->push_back(dst);
         } else {
           std::vector<VID_T>* out_edges = new std::vector<VID_T>;
-          out_edges->push_back(dst.at(i));
-          graph_out_edges.insert(std::make_pair(src.at(i), out_edges));
+          out_edges->push_back(dst);
+          graph_out_edges.insert(std::make_pair(src, out_edges));
         }
-        iter = graph_in_edges.find(dst.at(i));
+        iter = graph_in_edges.find(dst);
         if (iter != graph_in_edges.end()) {
-          iter->second->push_back(src.at(i));
+          iter->second->push_back(src);
         } else {
           std::vector<VID_T>* in_edges = new std::vector<VID_T>;
-          in_edges->push_back(src.at(i));
-          graph_in_edges.insert(std::make_pair(dst.at(i), in_edges));
+          in_edges->push_back(src);
+          graph_in_edges.insert(std::make_pair(dst, in_edges));
         }
       }
 
@@ -233,7 +230,7 @@ class EdgeListIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
     memset(((EDGE_LIST_T*)graph)->vdata_, 0,
            sizeof(VDATA_T) * ((EDGE_LIST_T*)graph)->num_vertexes_);
 
-    ((EDGE_LIST_T*)graph)->num_edges_ = src.size();
+    ((EDGE_LIST_T*)graph)->num_edges_ = num_edges;
     ((EDGE_LIST_T*)graph)->gid_ = gid;
     ((EDGE_LIST_T*)graph)->vertexes_state_ =
         (char*)malloc(sizeof(char) * ((EDGE_LIST_T*)graph)->get_num_vertexes());
@@ -262,7 +259,8 @@ class EdgeListIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
     meta_file.read((char*)meta_buff, sizeof(size_t) * 2);
     meta_file.read((char*)&edge_list_graph->max_vid_, sizeof(VID_T));
     edge_list_graph->aligned_max_vid_ =
-        ceil(edge_list_graph->max_vid_ / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+        ceil(((size_t)edge_list_graph->max_vid_ + 1) / ALIGNMENT_FACTOR) *
+        ALIGNMENT_FACTOR;
 
     edge_list_graph->buf_graph_ =
         (VID_T*)malloc(sizeof(VID_T) * 2 * meta_buff[1]);
@@ -289,7 +287,7 @@ class EdgeListIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
       }
       edge_list_graph->max_vid_ = max_vid;
       edge_list_graph->aligned_max_vid_ =
-          ceil(max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+          ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
     }
 
     LOG_INFO("Read ", data_pt, " successful", ", num vertexes: ", meta_buff[0],
@@ -322,49 +320,33 @@ class EdgeListIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
     std::condition_variable finish_cv;
     std::unique_lock<std::mutex> lck(mtx);
 
-    rapidcsv::Document doc(pt, rapidcsv::LabelParams(-1, -1),
-                           rapidcsv::SeparatorParams(separator_params));
+    CSVEdgeParser<VID_T> parser(pt, cores, separator_params);
+    if (!parser.Open()) return false;
     LOG_INFO("Open ", pt);
 
-    std::vector<VID_T> src = doc.GetColumn<VID_T>(0);
-    std::vector<VID_T> dst = doc.GetColumn<VID_T>(1);
-    graph->buf_graph_ =
-        (VID_T*)malloc(sizeof(VID_T) * (src.size() + dst.size()));
-
-    memset((char*)graph->buf_graph_, 0,
-           sizeof(VID_T) * (src.size() + dst.size()));
-    std::atomic<VID_T> max_vid_atom(0);
-
+    size_t num_edges = parser.CountEdges();
+    graph->buf_graph_ = (VID_T*)malloc(sizeof(VID_T) * num_edges * 2);
     VID_T max_vid = 0;
-    LOG_INFO("Traverse the entire graph to get the maximum vid.");
-    std::atomic<size_t> pending_packages(cores);
-    for (size_t tid = 0; tid < cores; tid++) {
-      thread_pool.Commit([tid, &cores, &src, &dst, &graph, &pending_packages,
-                          &finish_cv, &max_vid]() {
-        for (size_t j = tid; j < src.size(); j += cores) {
-          *(graph->buf_graph_ + j * 2) = src.at(j);
-          *(graph->buf_graph_ + j * 2 + 1) = dst.at(j);
-          write_max(&max_vid, src.at(j));
-          write_max(&max_vid, dst.at(j));
-        }
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
+    if (!parser.Parse(graph->buf_graph_, graph->buf_graph_ + 1, &num_edges, 2,
+                      &max_vid)) {
+      free(graph->buf_graph_);
+      graph->buf_graph_ = nullptr;
+      return false;
     }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+    parser.Close();
 
-    ((EDGE_LIST_T*)graph)->num_edges_ = src.size();
+    ((EDGE_LIST_T*)graph)->num_edges_ = num_edges;
     ((EDGE_LIST_T*)graph)->max_vid_ = max_vid;
     ((EDGE_LIST_T*)graph)->aligned_max_vid_ =
-        ceil(max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+        ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
     LOG_INFO(((EDGE_LIST_T*)graph)->get_aligned_max_vid());
     ((EDGE_LIST_T*)graph)->gid_ = gid;
 
     Bitmap* vertex_indicator = new Bitmap(graph->get_aligned_max_vid());
     vertex_indicator->clear();
 
-    LOG_INFO("Traverse the entire graph again to fill the vertex_indicator.");
-    pending_packages.store(cores);
+    LOG_INFO("Traverse the entire graph to fill the vertex_indicator.");
+    std::atomic<size_t> pending_packages(cores);
     for (size_t i = 0; i < cores; i++) {
       size_t tid = i;
       thread_pool.Commit([tid, &cores, &graph, &vertex_indicator,
@@ -460,63 +442,39 @@ class EdgeListIOAdapter : public IOAdapterBase<GID_T, VID_T, VDATA_T, EDATA_T> {
       files.push_back(path);
     }
 
-    VID_T** buf_graph_bucket_ = (VID_T**)malloc(sizeof(VID_T*) * files.size());
-    auto num_edges_bucket = (size_t*)malloc(sizeof(size_t) * files.size());
-    auto offset_edges_bucket =
-        (size_t*)malloc(sizeof(size_t) * (files.size() + 1));
-
-    memset((char*)num_edges_bucket, 0, sizeof(size_t) * (files.size()));
-    memset((char*)offset_edges_bucket, 0, sizeof(size_t) * (1 + files.size()));
-
-    VID_T max_vid = 0;
-    std::atomic<VID_T> max_vid_atom(0);
-    for (auto pi = 0; pi < files.size(); pi++) {
-      LOG_INFO("Process ", files.at(pi));
-      rapidcsv::Document doc(files.at(pi), rapidcsv::LabelParams(-1, -1),
-                             rapidcsv::SeparatorParams(separator_params));
-      std::vector<VID_T> src = doc.GetColumn<VID_T>(0);
-      std::vector<VID_T> dst = doc.GetColumn<VID_T>(1);
-      VID_T* buff = (vid_t*)malloc(sizeof(vid_t) * (src.size() + dst.size()));
-      memset((char*)buff, 0, sizeof(VID_T) * (src.size() + dst.size()));
-      buf_graph_bucket_[pi] = buff;
-
-      std::atomic<size_t> pending_packages(cores);
-
-      for (size_t i = 0; i < cores; i++) {
-        size_t tid = i;
-        thread_pool.Commit([tid, &cores, &src, &dst, &graph, &pending_packages,
-                            &finish_cv, &max_vid, &buff]() {
-          for (size_t j = tid; j < src.size(); j += cores) {
-            if (src.at(j) == dst.at(j)) continue;
-            *(buff + j * 2) = src.at(j);
-            *(buff + j * 2 + 1) = dst.at(j);
-            write_max(&max_vid, src.at(j));
-            write_max(&max_vid, dst.at(j));
-          }
-          if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-          return;
-        });
-      }
-      finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
-      ((EDGE_LIST_T*)graph)->num_edges_ += src.size();
-      num_edges_bucket[pi] = src.size();
-      offset_edges_bucket[pi + 1] = src.size();
+    // Count all files first so that every file is parsed directly into its
+    // slice of buf_graph_.
+    size_t upper_num_edges = 0;
+    for (auto& file : files) {
+      CSVEdgeParser<VID_T> parser(file, cores, separator_params);
+      if (!parser.Open()) return false;
+      upper_num_edges += parser.CountEdges();
     }
-
     ((EDGE_LIST_T*)graph)->buf_graph_ =
-        (VID_T*)malloc(sizeof(VID_T) * ((EDGE_LIST_T*)graph)->num_edges_ * 2);
-    memset((char*)((EDGE_LIST_T*)graph)->buf_graph_, 0,
-           sizeof(VID_T) * ((EDGE_LIST_T*)graph)->num_edges_ * 2);
+        (VID_T*)malloc(sizeof(VID_T) * upper_num_edges * 2);
 
-    // Copy edges from buffs to graph->buf_graph_;
+    VID_T max_vid = 0;
+    size_t num_edges = 0;
     for (size_t pi = 0; pi < files.size(); pi++) {
-      memcpy(((EDGE_LIST_T*)graph)->buf_graph_ + offset_edges_bucket[pi] * 2,
-             buf_graph_bucket_[pi], num_edges_bucket[pi] * 2 * sizeof(VID_T));
+      LOG_INFO("Process ", files.at(pi));
+      CSVEdgeParser<VID_T> parser(files.at(pi), cores, separator_params);
+      VID_T* buff = ((EDGE_LIST_T*)graph)->buf_graph_ + num_edges * 2;
+      VID_T local_max_vid = 0;
+      size_t n = 0;
+      if (!parser.Open() ||
+          !parser.Parse(buff, buff + 1, &n, 2, &local_max_vid, true)) {
+        free(((EDGE_LIST_T*)graph)->buf_graph_);
+        ((EDGE_LIST_T*)graph)->buf_graph_ = nullptr;
+        return false;
+      }
+      num_edges += n;
+      write_max(&max_vid, local_max_vid);
     }
+    ((EDGE_LIST_T*)graph)->num_edges_ = num_edges;
 
     ((EDGE_LIST_T*)graph)->max_vid_ = max_vid;
     ((EDGE_LIST_T*)graph)->aligned_max_vid_ =
-        ceil(max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+        ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
     ((EDGE_LIST_T*)graph)->gid_ = gid;
 
     LOG_INFO("Traverse the entire graph again to fill the vertex_indicator.");
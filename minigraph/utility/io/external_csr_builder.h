@@ -0,0 +1,704 @@
+#ifndef MINIGRAPH_UTILITY_IO_EXTERNAL_CSR_BUILDER_H
+#define MINIGRAPH_UTILITY_IO_EXTERNAL_CSR_BUILDER_H
+
+#include <fcntl.h>
+#include <math.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "graphs/immutable_csr.h"
+#include "portability/sys_data_structure.h"
+#include "portability/sys_types.h"
+#include "utility/atomic.h"
+#include "utility/bitmap.h"
+#include "utility/io/csv_edge_parser.h"
+#include "utility/io/data_mngr.h"
+#include "utility/logging.h"
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace utility {
+namespace io {
+
+// ExternalCSRBuilder converts an edge list into edge-cut csr_bin fragments
+// with bounded memory. It works in three steps:
+//   1. Run generation. The input is read in blocks of at most
+//      mem_budget bytes worth of edges. Each block is turned into
+//      <src, dst> records for out edges and <dst, src> records for in edges,
+//      sorted in parallel and spilled to disk as sorted runs.
+//   2. K-way merge. Runs are merged (in several passes if there are more
+//      than kMaxFanIn of them) into a single stream ordered by vid, so that
+//      the adjacency of each vertex arrives contiguously and already sorted.
+//   3. Sweep. The in stream and the out stream are swept in vid order and
+//      every section of each fragment is written straight to its final
+//      offset in minigraph_data/<gid>.bin.
+// Vertexes are assigned to fragments in the same way as EdgeCutPartitioner
+// unless Build() is given the fragment of each vertex, self loops are
+// dropped, and the workspace (meta, data, vdata, si, communication matrix,
+// vid_map and global_border_vid_map) has the same layout. Apart from the
+// block buffer, memory is O(max_vid) bits.
+template <typename GID_T, typename VID_T, typename VDATA_T, typename EDATA_T>
+class ExternalCSRBuilder {
+  using CSR_T = graphs::ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>;
+
+  struct EdgeRecord {
+    VID_T key;
+    VID_T nbr;
+    bool operator<(const EdgeRecord& b) const {
+      return key < b.key || (key == b.key && nbr < b.nbr);
+    }
+  };
+
+  // Buffered, forward-only reader of a sorted run.
+  class RunReader {
+   public:
+    RunReader(const std::string& pt, const size_t buf_size) {
+      file_ = fopen(pt.c_str(), "rb");
+      buf_size_ = buf_size;
+      buf_ = (EdgeRecord*)malloc(sizeof(EdgeRecord) * buf_size_);
+      Fill();
+    }
+    ~RunReader() {
+      if (file_ != nullptr) fclose(file_);
+      free(buf_);
+    }
+    bool Empty() const { return pos_ >= len_; }
+    const EdgeRecord& Top() const { return buf_[pos_]; }
+    void Pop() {
+      if (++pos_ >= len_) Fill();
+    }
+
+   private:
+    FILE* file_ = nullptr;
+    EdgeRecord* buf_ = nullptr;
+    size_t buf_size_ = 0;
+    size_t pos_ = 0;
+    size_t len_ = 0;
+
+    void Fill() {
+      pos_ = 0;
+      len_ = 0;
+      if (file_ == nullptr) return;
+      len_ = fread(buf_, sizeof(EdgeRecord), buf_size_, file_);
+    }
+  };
+
+  // Merges sorted runs into one sorted stream.
+  class RunMerger {
+   public:
+    RunMerger(const std::vector<std::string>& runs, const size_t buf_size) {
+      for (auto& pt : runs) readers_.push_back(new RunReader(pt, buf_size));
+      for (size_t i = 0; i < readers_.size(); i++) Push(i);
+    }
+    ~RunMerger() {
+      for (auto& reader : readers_) delete reader;
+    }
+    bool Empty() const { return heap_.empty(); }
+    const EdgeRecord& Top() const { return heap_.top().first; }
+    void Pop() {
+      size_t i = heap_.top().second;
+      heap_.pop();
+      readers_[i]->Pop();
+      Push(i);
+    }
+
+   private:
+    struct Greater {
+      bool operator()(const std::pair<EdgeRecord, size_t>& a,
+                      const std::pair<EdgeRecord, size_t>& b) const {
+        return b.first < a.first;
+      }
+    };
+    std::vector<RunReader*> readers_;
+    std::priority_queue<std::pair<EdgeRecord, size_t>,
+                        std::vector<std::pair<EdgeRecord, size_t>>, Greater>
+        heap_;
+
+    void Push(const size_t i) {
+      if (!readers_[i]->Empty())
+        heap_.push(std::make_pair(readers_[i]->Top(), i));
+    }
+  };
+
+  // Buffered writer of one array section of a file. Put() takes the index of
+  // the element inside the section; indexes must be increasing, gaps are left
+  // as holes of the (zero-filled) file.
+  template <typename T>
+  class SectionWriter {
+   public:
+    SectionWriter(const int fd, const size_t base, const size_t buf_size) {
+      fd_ = fd;
+      base_ = base;
+      buf_size_ = buf_size;
+      buf_ = (T*)malloc(sizeof(T) * buf_size_);
+    }
+    ~SectionWriter() {
+      Flush();
+      free(buf_);
+    }
+    void Put(const size_t index, const T& val) {
+      if (len_ == buf_size_ || (len_ > 0 && index != start_ + len_)) Flush();
+      if (len_ == 0) start_ = index;
+      buf_[len_++] = val;
+    }
+    void Flush() {
+      if (len_ == 0) return;
+      char* p = (char*)buf_;
+      size_t remain = sizeof(T) * len_;
+      size_t offset = base_ + sizeof(T) * start_;
+      while (remain > 0) {
+        ssize_t n = pwrite(fd_, p, remain, offset);
+        if (n <= 0) {
+          XLOG(ERR, "pwrite fault, offset: ", offset);
+          break;
+        }
+        p += n;
+        offset += n;
+        remain -= n;
+      }
+      len_ = 0;
+    }
+
+   private:
+    int fd_ = -1;
+    size_t base_ = 0;
+    T* buf_ = nullptr;
+    size_t buf_size_ = 0;
+    size_t start_ = 0;
+    size_t len_ = 0;
+  };
+
+  // Per-fragment bookkeeping of the sweep.
+  struct Fragment {
+    int fd = -1;
+    size_t num_vertexes = 0;
+    VID_T max_vid = 0;
+    size_t sum_in_edges = 0;
+    size_t sum_out_edges = 0;
+    size_t cursor = 0;
+    size_t offset = 0;
+    StatisticInfo si;
+    SectionWriter<size_t>* degree = nullptr;
+    SectionWriter<size_t>* offsets = nullptr;
+    SectionWriter<VID_T>* edges = nullptr;
+
+    size_t start_indegree() const { return sizeof(VID_T) * num_vertexes; }
+    size_t start_outdegree() const {
+      return start_indegree() + sizeof(size_t) * num_vertexes;
+    }
+    size_t start_in_offset() const {
+      return start_outdegree() + sizeof(size_t) * num_vertexes;
+    }
+    size_t start_out_offset() const {
+      return start_in_offset() + sizeof(size_t) * num_vertexes;
+    }
+    size_t start_in_edges() const {
+      return start_out_offset() + sizeof(size_t) * num_vertexes;
+    }
+    size_t start_out_edges() const {
+      return start_in_edges() + sizeof(VID_T) * sum_in_edges;
+    }
+    size_t start_localid_by_globalid() const {
+      return start_out_edges() + sizeof(VID_T) * sum_out_edges;
+    }
+    // As CSRBuilder, localid_by_globalid holds max_vid + 1 entries, rounded
+    // up.
+    size_t aligned_max_vid() const {
+      return ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+    }
+  };
+
+ public:
+  // mem_budget is the number of bytes used for buffering edges in run
+  // generation; merge and write buffers are small and fixed.
+  ExternalCSRBuilder(const size_t mem_budget = (size_t)1 << 30,
+                     const size_t cores = 1) {
+    cores_ = cores == 0 ? 1 : cores;
+    block_size_ = mem_budget / (2 * sizeof(EdgeRecord));
+    if (block_size_ < cores_ * 1024) block_size_ = cores_ * 1024;
+  }
+
+  ~ExternalCSRBuilder() {
+    if (vertex_indicator_ != nullptr) delete vertex_indicator_;
+    if (global_border_vid_map_ != nullptr) delete global_border_vid_map_;
+  }
+
+  // Build fragments from an edge list in edgelist_csv format, or edgelist_bin
+  // format where src_pt is the prefix of minigraph_{meta, data}.bin.
+  // gid_by_vid, if provided, gives the fragment of every vertex of the edge
+  // list and replaces the id ranges.
+  bool Build(const std::string& src_pt, const GraphFormat& graph_format,
+             const std::string& dst_pt, const size_t num_partitions = 1,
+             const char separator_params = ',',
+             const std::vector<GID_T>* gid_by_vid = nullptr) {
+    dst_pt_ = dst_pt;
+    gid_by_vid_ = gid_by_vid;
+    tmp_pt_ = dst_pt + "minigraph_tmp/";
+    num_partitions_ = num_partitions == 0 ? 1 : num_partitions;
+    data_mngr_.MakeDirectory(tmp_pt_);
+
+    LOG_INFO("ExternalCSRBuilder: Generate runs, block_size: ", block_size_);
+    bool tag = false;
+    if (graph_format == edgelist_csv)
+      tag = GenerateRunsFromCSV(src_pt, separator_params);
+    else if (graph_format == edgelist_bin)
+      tag = GenerateRunsFromBin(src_pt + "minigraph_meta.bin",
+                                src_pt + "minigraph_data.bin");
+    if (!tag || num_edges_ == 0) {
+      XLOG(ERR, "ExternalCSRBuilder: no edges are read from ", src_pt);
+      return false;
+    }
+    if (gid_by_vid_ != nullptr && gid_by_vid_->size() <= max_vid_) {
+      XLOG(ERR, "ExternalCSRBuilder: gid_by_vid misses vid ", max_vid_);
+      return false;
+    }
+
+    num_vertexes_ = vertex_indicator_->get_num_bit();
+    aligned_max_vid_ =
+        ceil(((size_t)max_vid_ + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+    step_ = ceil((double)num_vertexes_ / (double)num_partitions_);
+    global_border_vid_map_ = new Bitmap(aligned_max_vid_);
+    global_border_vid_map_->clear();
+    LOG_INFO("ExternalCSRBuilder: num_vertexes: ", num_vertexes_,
+             " num_edges: ", num_edges_, " max_vid: ", max_vid_,
+             " runs: ", out_runs_.size());
+
+    fragments_.resize(num_partitions_);
+    num_cut_edges_.assign(num_partitions_ * num_partitions_, 0);
+    ForEachVertex([this](VID_T vid) {
+      auto& fragment = fragments_[GetGid(vid)];
+      fragment.num_vertexes++;
+      fragment.max_vid = vid;
+    });
+    for (GID_T gid = 0; gid < num_partitions_; gid++) {
+      std::string data_pt =
+          dst_pt_ + "minigraph_data/" + std::to_string(gid) + ".bin";
+      if (data_mngr_.Exist(data_pt)) remove(data_pt.c_str());
+      fragments_[gid].fd = open(data_pt.c_str(), O_RDWR | O_CREAT, 0644);
+      if (fragments_[gid].fd < 0) {
+        XLOG(ERR, "ExternalCSRBuilder: open fault: ", data_pt);
+        return false;
+      }
+    }
+
+    LOG_INFO("ExternalCSRBuilder: Merge in edges");
+    Sweep(ReduceRuns(in_runs_, "in"), false);
+    LOG_INFO("ExternalCSRBuilder: Merge out edges");
+    Sweep(ReduceRuns(out_runs_, "out"), true);
+    LOG_INFO("ExternalCSRBuilder: Write vertex maps");
+    WriteVertexMaps();
+    WriteFragments();
+    rmdir(tmp_pt_.c_str());
+    return true;
+  }
+
+ private:
+  static constexpr size_t kMaxFanIn = 128;
+  static constexpr size_t kReadBufSize = 1 << 16;
+  static constexpr size_t kWriteBufSize = 1 << 14;
+
+  size_t cores_ = 1;
+  size_t block_size_ = 0;
+  std::string dst_pt_;
+  std::string tmp_pt_;
+  size_t num_partitions_ = 1;
+  size_t num_runs_ = 0;
+
+  VID_T max_vid_ = 0;
+  VID_T aligned_max_vid_ = 0;
+  size_t num_vertexes_ = 0;
+  size_t num_edges_ = 0;
+  size_t step_ = 1;
+  const std::vector<GID_T>* gid_by_vid_ = nullptr;
+
+  Bitmap* vertex_indicator_ = nullptr;
+  Bitmap* global_border_vid_map_ = nullptr;
+  // Number of out edges from fragment x to fragment y, in
+  // [x * num_partitions_ + y].
+  std::vector<size_t> num_cut_edges_;
+  std::vector<std::string> out_runs_;
+  std::vector<std::string> in_runs_;
+  std::vector<Fragment> fragments_;
+  DataMngr<CSR_T> data_mngr_;
+
+  inline GID_T GetGid(const VID_T vid) const {
+    if (gid_by_vid_ != nullptr) return (*gid_by_vid_)[vid];
+    return (vid / step_) % num_partitions_;
+  }
+
+  template <typename F>
+  void ForEachVertex(F&& f) {
+    size_t num_words = WORD_OFFSET(vertex_indicator_->size_) + 1;
+    for (size_t w = 0; w < num_words; w++) {
+      auto word = vertex_indicator_->data_[w];
+      while (word != 0) {
+        VID_T vid = (w << 6) + __builtin_ctzl(word);
+        word &= word - 1;
+        if (vid > max_vid_) return;
+        f(vid);
+      }
+    }
+  }
+
+  template <typename F>
+  void ParallelFor(const size_t n, F&& f) {
+    auto thread_pool = CPUThreadPool(cores_, 1);
+    std::mutex mtx;
+    std::condition_variable finish_cv;
+    std::unique_lock<std::mutex> lck(mtx);
+    std::atomic<size_t> pending_packages(n);
+    for (size_t tid = 0; tid < n; tid++) {
+      thread_pool.Commit([tid, &f, &pending_packages, &finish_cv]() {
+        f(tid);
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
+    }
+    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+  }
+
+  // Grow the vertex indicator so that it covers max_vid.
+  void ReserveVertexIndicator(const VID_T max_vid) {
+    if (vertex_indicator_ != nullptr && vertex_indicator_->size_ >= max_vid)
+      return;
+    size_t size =
+        vertex_indicator_ == nullptr ? 1024 : vertex_indicator_->size_;
+    while (size < max_vid) size <<= 1;
+    auto bitmap = new Bitmap(size);
+    bitmap->clear();
+    if (vertex_indicator_ != nullptr) {
+      memcpy(bitmap->data_, vertex_indicator_->data_,
+             vertex_indicator_->get_data_size(vertex_indicator_->size_));
+      delete vertex_indicator_;
+    }
+    vertex_indicator_ = bitmap;
+  }
+
+  // Sort out edges of a block, derive and sort in edges, spill both.
+  // records holds num_edges <src, dst> records and is followed by room for
+  // another num_edges records.
+  void SpillBlock(EdgeRecord* records, const size_t num_edges,
+                  const VID_T block_max_vid) {
+    if (num_edges == 0) return;
+    num_edges_ += num_edges;
+    max_vid_ < block_max_vid ? max_vid_ = block_max_vid : 0;
+    ReserveVertexIndicator(block_max_vid);
+    EdgeRecord* in_records = records + num_edges;
+    size_t num_slices = cores_;
+    size_t slice = (num_edges + num_slices - 1) / num_slices;
+    ParallelFor(num_slices, [&](size_t tid) {
+      size_t begin = tid * slice;
+      size_t end = std::min(num_edges, begin + slice);
+      for (size_t i = begin; i < end; i++) {
+        in_records[i].key = records[i].nbr;
+        in_records[i].nbr = records[i].key;
+        vertex_indicator_->set_bit(records[i].key);
+        vertex_indicator_->set_bit(records[i].nbr);
+      }
+      if (begin >= end) return;
+      std::sort(records + begin, records + end);
+      std::sort(in_records + begin, in_records + end);
+    });
+    for (size_t tid = 0; tid < num_slices; tid++) {
+      size_t begin = tid * slice;
+      size_t end = std::min(num_edges, begin + slice);
+      if (begin >= end) continue;
+      out_runs_.push_back(WriteRun(records + begin, end - begin));
+      in_runs_.push_back(WriteRun(in_records + begin, end - begin));
+    }
+  }
+
+  std::string WriteRun(const EdgeRecord* records, const size_t n) {
+    std::string pt = tmp_pt_ + "run_" + std::to_string(num_runs_++) + ".bin";
+    std::ofstream run_file(pt, std::ios::binary | std::ios::trunc);
+    run_file.write((char*)records, sizeof(EdgeRecord) * n);
+    run_file.close();
+    return pt;
+  }
+
+  bool GenerateRunsFromCSV(const std::string& pt, const char separator) {
+    CSVEdgeParser<VID_T> parser(pt, cores_, separator);
+    if (!parser.Open()) return false;
+    EdgeRecord* records =
+        (EdgeRecord*)malloc(sizeof(EdgeRecord) * block_size_ * 2);
+    while (parser.NextWindow(block_size_)) {
+      VID_T block_max_vid = 0;
+      size_t n = 0;
+      if (!parser.Parse(&records[0].key, &records[0].nbr, &n,
+                        sizeof(EdgeRecord) / sizeof(VID_T), &block_max_vid,
+                        true)) {
+        free(records);
+        return false;
+      }
+      SpillBlock(records, n, block_max_vid);
+    }
+    free(records);
+    return true;
+  }
+
+  bool GenerateRunsFromBin(const std::string& meta_pt,
+                           const std::string& data_pt) {
+    if (!data_mngr_.Exist(meta_pt) || !data_mngr_.Exist(data_pt)) {
+      XLOG(ERR, "Read file fault: ", data_pt);
+      return false;
+    }
+    size_t meta_buff[2] = {0};
+    std::ifstream meta_file(meta_pt, std::ios::binary);
+    meta_file.read((char*)meta_buff, sizeof(size_t) * 2);
+    meta_file.close();
+
+    std::ifstream data_file(data_pt, std::ios::binary);
+    VID_T* buf = (VID_T*)malloc(sizeof(VID_T) * 2 * block_size_);
+    EdgeRecord* records =
+        (EdgeRecord*)malloc(sizeof(EdgeRecord) * block_size_ * 2);
+    size_t remain = meta_buff[1];
+    while (remain > 0) {
+      size_t n = std::min(remain, block_size_);
+      data_file.read((char*)buf, sizeof(VID_T) * 2 * n);
+      remain -= n;
+      size_t count = 0;
+      VID_T block_max_vid = 0;
+      for (size_t i = 0; i < n; i++) {
+        if (buf[i * 2] == buf[i * 2 + 1]) continue;
+        records[count].key = buf[i * 2];
+        records[count].nbr = buf[i * 2 + 1];
+        block_max_vid < buf[i * 2] ? block_max_vid = buf[i * 2] : 0;
+        block_max_vid < buf[i * 2 + 1] ? block_max_vid = buf[i * 2 + 1] : 0;
+        count++;
+      }
+      SpillBlock(records, count, block_max_vid);
+    }
+    data_file.close();
+    free(buf);
+    free(records);
+    return true;
+  }
+
+  // Merge runs until at most kMaxFanIn are left.
+  std::vector<std::string> ReduceRuns(std::vector<std::string> runs,
+                                      const std::string& tag) {
+    while (runs.size() > kMaxFanIn) {
+      std::vector<std::string> merged_runs;
+      for (size_t i = 0; i < runs.size(); i += kMaxFanIn) {
+        size_t end = std::min(runs.size(), i + kMaxFanIn);
+        std::vector<std::string> group(runs.begin() + i, runs.begin() + end);
+        std::string pt = tmp_pt_ + tag + "_merged_" +
+                         std::to_string(num_runs_++) + ".bin";
+        {
+          RunMerger merger(group, kReadBufSize);
+          std::ofstream run_file(pt, std::ios::binary | std::ios::trunc);
+          std::vector<EdgeRecord> buf;
+          buf.reserve(kReadBufSize);
+          while (!merger.Empty()) {
+            buf.push_back(merger.Top());
+            merger.Pop();
+            if (buf.size() == kReadBufSize) {
+              run_file.write((char*)buf.data(),
+                             sizeof(EdgeRecord) * buf.size());
+              buf.clear();
+            }
+          }
+          run_file.write((char*)buf.data(), sizeof(EdgeRecord) * buf.size());
+          run_file.close();
+        }
+        for (auto& run : group) remove(run.c_str());
+        merged_runs.push_back(pt);
+      }
+      runs.swap(merged_runs);
+    }
+    return runs;
+  }
+
+  // Walk all vertexes in vid order together with the merged stream and write
+  // degree, offset and adjacency sections of each fragment.
+  void Sweep(const std::vector<std::string>& runs, const bool is_out) {
+    for (auto& fragment : fragments_) {
+      fragment.cursor = 0;
+      fragment.offset = 0;
+      size_t start_degree =
+          is_out ? fragment.start_outdegree() : fragment.start_indegree();
+      size_t start_offset =
+          is_out ? fragment.start_out_offset() : fragment.start_in_offset();
+      size_t start_edges =
+          is_out ? fragment.start_out_edges() : fragment.start_in_edges();
+      fragment.degree =
+          new SectionWriter<size_t>(fragment.fd, start_degree, kWriteBufSize);
+      fragment.offsets =
+          new SectionWriter<size_t>(fragment.fd, start_offset, kWriteBufSize);
+      fragment.edges =
+          new SectionWriter<VID_T>(fragment.fd, start_edges, kWriteBufSize);
+    }
+
+    RunMerger merger(runs, kReadBufSize);
+    ForEachVertex([this, &merger, is_out](VID_T vid) {
+      GID_T gid = GetGid(vid);
+      auto& fragment = fragments_[gid];
+      size_t degree = 0;
+      size_t dlv = 0;
+      while (!merger.Empty() && merger.Top().key == vid) {
+        VID_T nbr = merger.Top().nbr;
+        merger.Pop();
+        fragment.edges->Put(fragment.offset + degree++, nbr);
+        if (GetGid(nbr) != gid) {
+          global_border_vid_map_->set_bit(nbr);
+          if (is_out) {
+            fragment.si.sum_out_border_vertexes++;
+            num_cut_edges_[gid * num_partitions_ + GetGid(nbr)]++;
+          }
+        } else {
+          dlv++;
+        }
+      }
+      fragment.degree->Put(fragment.cursor, degree);
+      fragment.offsets->Put(fragment.cursor, fragment.offset);
+      fragment.cursor++;
+      fragment.offset += degree;
+      if (is_out) {
+        fragment.si.sum_out_degree += dlv;
+        fragment.si.sum_dlv += dlv;
+        fragment.si.sum_dgv += degree;
+        fragment.si.sum_dlv_times_dlv += dlv * dlv;
+        fragment.si.sum_dlv_times_dgv += dlv * degree;
+        fragment.si.sum_dgv_times_dgv += degree * degree;
+      }
+    });
+
+    for (auto& fragment : fragments_) {
+      if (is_out)
+        fragment.sum_out_edges = fragment.offset;
+      else
+        fragment.sum_in_edges = fragment.offset;
+      delete fragment.degree;
+      delete fragment.offsets;
+      delete fragment.edges;
+      fragment.degree = nullptr;
+      fragment.offsets = nullptr;
+      fragment.edges = nullptr;
+    }
+    for (auto& run : runs) remove(run.c_str());
+  }
+
+  // Write globalid and localid_by_globalid of each fragment as well as the
+  // global vid_map.
+  void WriteVertexMaps() {
+    std::string vid_map_pt = dst_pt_ + "minigraph_message/vid_map.bin";
+    if (data_mngr_.Exist(vid_map_pt)) remove(vid_map_pt.c_str());
+    int vid_map_fd = open(vid_map_pt.c_str(), O_RDWR | O_CREAT, 0644);
+    size_t num_vids = (size_t)max_vid_ + 1;
+    pwrite(vid_map_fd, &num_vids, sizeof(size_t), 0);
+    if (ftruncate(vid_map_fd, sizeof(size_t) + sizeof(VID_T) * num_vids) != 0)
+      XLOG(ERR, "ftruncate fault: ", vid_map_pt);
+
+    std::vector<SectionWriter<VID_T>*> globalid_writers;
+    std::vector<SectionWriter<VID_T>*> localid_writers;
+    for (auto& fragment : fragments_) {
+      fragment.cursor = 0;
+      globalid_writers.push_back(
+          new SectionWriter<VID_T>(fragment.fd, 0, kWriteBufSize));
+      localid_writers.push_back(new SectionWriter<VID_T>(
+          fragment.fd, fragment.start_localid_by_globalid(), kWriteBufSize));
+    }
+    {
+      SectionWriter<VID_T> vid_map_writer(vid_map_fd, sizeof(size_t),
+                                          kWriteBufSize);
+      ForEachVertex([&](VID_T vid) {
+        GID_T gid = GetGid(vid);
+        auto& fragment = fragments_[gid];
+        VID_T local_id = fragment.cursor++;
+        globalid_writers[gid]->Put(local_id, vid);
+        localid_writers[gid]->Put(vid, local_id);
+        vid_map_writer.Put(vid, local_id);
+      });
+    }
+    for (GID_T gid = 0; gid < num_partitions_; gid++) {
+      delete globalid_writers[gid];
+      delete localid_writers[gid];
+    }
+    close(vid_map_fd);
+  }
+
+  // Finish the data files and write meta, vdata, si and the shared maps.
+  void WriteFragments() {
+    for (GID_T gid = 0; gid < num_partitions_; gid++) {
+      auto& fragment = fragments_[gid];
+      size_t total_size = fragment.start_localid_by_globalid() +
+                          sizeof(VID_T) * fragment.aligned_max_vid();
+      if (ftruncate(fragment.fd, total_size) != 0)
+        XLOG(ERR, "ftruncate fault, gid: ", gid);
+      close(fragment.fd);
+      fragment.fd = -1;
+
+      std::string meta_pt =
+          dst_pt_ + "minigraph_meta/" + std::to_string(gid) + ".bin";
+      std::string vdata_pt =
+          dst_pt_ + "minigraph_vdata/" + std::to_string(gid) + ".bin";
+      std::string si_pt =
+          dst_pt_ + "minigraph_si/" + std::to_string(gid) + ".yaml";
+      if (data_mngr_.Exist(meta_pt)) remove(meta_pt.c_str());
+      std::ofstream meta_file(meta_pt, std::ios::binary);
+      size_t buf_meta[3] = {fragment.num_vertexes, fragment.sum_in_edges,
+                            fragment.sum_out_edges};
+      meta_file.write((char*)buf_meta, sizeof(size_t) * 3);
+      meta_file.write((char*)&fragment.max_vid, sizeof(VID_T));
+      size_t num_localid_by_globalid = fragment.aligned_max_vid();
+      meta_file.write((char*)&num_localid_by_globalid, sizeof(size_t));
+      meta_file.close();
+
+      // vdata and edata are all zeros.
+      if (data_mngr_.Exist(vdata_pt)) remove(vdata_pt.c_str());
+      int vdata_fd = open(vdata_pt.c_str(), O_RDWR | O_CREAT, 0644);
+      size_t vdata_size = sizeof(VDATA_T) * fragment.num_vertexes +
+                          sizeof(EDATA_T) * fragment.sum_out_edges;
+      if (ftruncate(vdata_fd, vdata_size) != 0)
+        XLOG(ERR, "ftruncate fault: ", vdata_pt);
+      close(vdata_fd);
+
+      auto& si = fragment.si;
+      si.num_vertexes = fragment.num_vertexes;
+      si.num_active_vertexes = fragment.num_vertexes;
+      si.num_edges = fragment.sum_in_edges + fragment.sum_out_edges;
+      data_mngr_.WriteStatisticInfo(si, si_pt);
+      LOG_INFO("ExternalCSRBuilder: GID: ", gid,
+               " num_vertexes: ", fragment.num_vertexes,
+               " sum_in_edges: ", fragment.sum_in_edges,
+               " sum_out_edges: ", fragment.sum_out_edges,
+               " max_vid: ", fragment.max_vid);
+    }
+
+    // As PartitionerBase::SetCommunicationMatrix(), fragments joined by an
+    // edge depend on each other.
+    bool* communication_matrix =
+        (bool*)malloc(sizeof(bool) * num_partitions_ * num_partitions_);
+    for (size_t x = 0; x < num_partitions_; x++)
+      for (size_t y = 0; y < num_partitions_; y++)
+        communication_matrix[x * num_partitions_ + y] =
+            x != y && (num_cut_edges_[x * num_partitions_ + y] > 0 ||
+                       num_cut_edges_[y * num_partitions_ + x] > 0);
+    std::string communication_matrix_pt =
+        dst_pt_ + "minigraph_border_vertexes/communication_matrix.bin";
+    std::string global_border_vid_map_pt =
+        dst_pt_ + "minigraph_message/global_border_vid_map.bin";
+    remove(communication_matrix_pt.c_str());
+    remove(global_border_vid_map_pt.c_str());
+    data_mngr_.WriteCommunicationMatrix(communication_matrix_pt,
+                                        communication_matrix, num_partitions_);
+    data_mngr_.WriteBitmap(global_border_vid_map_, global_border_vid_map_pt);
+    free(communication_matrix);
+  }
+};
+
+}  // namespace io
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_IO_EXTERNAL_CSR_BUILDER_H
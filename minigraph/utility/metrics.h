@@ -0,0 +1,291 @@
+#ifndef MINIGRAPH_UTILITY_METRICS_H
+#define MINIGRAPH_UTILITY_METRICS_H
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utility/atomic.h"
+#include "utility/logging.h"
+
+namespace minigraph {
+namespace utility {
+
+// Metrics is a registry of the counters, gauges and histograms below, dumped
+// in the Prometheus text format every interval of StartDump(), e.g. for the
+// textfile collector of node_exporter, and summarized by LogSummary(). A
+// series is named by its metric and, for labelled metrics, an integer label
+// such as the gid. Nothing is recorded until Enable(), so that a disabled
+// registry costs one relaxed load per call.
+class Metrics {
+ public:
+  enum Type { kCounter, kGauge, kHistogram };
+
+  // Upper bounds of histogram buckets, in seconds.
+  static constexpr double kBuckets[] = {1e-4, 5e-4, 1e-3, 5e-3, 1e-2,
+                                        5e-2, 0.1,  0.5,  1,    5,
+                                        10,   50,   100};
+  static constexpr size_t kNumBuckets = sizeof(kBuckets) / sizeof(double);
+
+  static Metrics& Get() {
+    static Metrics metrics;
+    return metrics;
+  }
+
+  // Superstep of the fragment the calling thread evaluates. CC sets it, so
+  // that metrics recorded within PEval / IncEval are labelled by it.
+  static size_t& ThreadSuperstep() {
+    thread_local size_t superstep = 0;
+    return superstep;
+  }
+
+  void Enable() {
+    cas_retries_base_ = cas_retries.load();
+    count_cas_retries.store(true);
+    enabled_.store(true, std::memory_order_relaxed);
+  }
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void Add(const std::string& name, const double value,
+           const size_t label = 0) {
+    if (!IsEnabled()) return;
+    auto family = GetFamily(name);
+    if (family == nullptr) return;
+    std::lock_guard<std::mutex> lck(family->mtx);
+    family->series[label].sum += value;
+  }
+
+  void Set(const std::string& name, const double value,
+           const size_t label = 0) {
+    if (!IsEnabled()) return;
+    auto family = GetFamily(name);
+    if (family == nullptr) return;
+    std::lock_guard<std::mutex> lck(family->mtx);
+    family->series[label].sum = value;
+  }
+
+  // value in seconds.
+  void Observe(const std::string& name, const double value,
+               const size_t label = 0) {
+    if (!IsEnabled()) return;
+    auto family = GetFamily(name);
+    if (family == nullptr) return;
+    std::lock_guard<std::mutex> lck(family->mtx);
+    auto& series = family->series[label];
+    if (series.buckets.empty()) series.buckets.resize(kNumBuckets, 0);
+    for (size_t i = 0; i < kNumBuckets; i++)
+      if (value <= kBuckets[i]) series.buckets[i]++;
+    series.count++;
+    series.sum += value;
+  }
+
+  // Sum of a metric over all its series; the sum of observations for
+  // histograms.
+  double GetSum(const std::string& name) {
+    auto family = GetFamily(name);
+    if (family == nullptr) return 0;
+    std::lock_guard<std::mutex> lck(family->mtx);
+    double sum = 0;
+    for (auto& iter : family->series) sum += iter.second.sum;
+    return sum;
+  }
+
+  // Write all metrics to pt. The dump goes to a temporary file first and is
+  // renamed, so that readers never see a partial dump.
+  bool WritePrometheus(const std::string& pt) {
+    Sample();
+    std::string tmp_pt = pt + ".tmp";
+    std::ofstream fout(tmp_pt);
+    if (!fout) {
+      XLOG(ERR, "Write file fault: ", tmp_pt);
+      return false;
+    }
+    fout.precision(15);
+    for (auto& family : families_) {
+      const char* type = family->type == kCounter
+                             ? "counter"
+                             : (family->type == kGauge ? "gauge" : "histogram");
+      fout << "# HELP " << family->name << " " << family->help << "\n";
+      fout << "# TYPE " << family->name << " " << type << "\n";
+      std::lock_guard<std::mutex> lck(family->mtx);
+      for (auto& iter : family->series) {
+        std::string label = family->label == nullptr
+                                ? ""
+                                : std::string(family->label) + "=\"" +
+                                      std::to_string(iter.first) + "\"";
+        auto& series = iter.second;
+        if (family->type != kHistogram) {
+          fout << family->name << Braces(label) << " " << series.sum << "\n";
+          continue;
+        }
+        std::string sep = label == "" ? "" : label + ",";
+        for (size_t i = 0; i < kNumBuckets; i++)
+          fout << family->name << "_bucket{" << sep << "le=\"" << kBuckets[i]
+               << "\"} " << series.buckets[i] << "\n";
+        fout << family->name << "_bucket{" << sep << "le=\"+Inf\"} "
+             << series.count << "\n";
+        fout << family->name << "_sum" << Braces(label) << " " << series.sum
+             << "\n";
+        fout << family->name << "_count" << Braces(label) << " "
+             << series.count << "\n";
+      }
+    }
+    fout.close();
+    if (std::rename(tmp_pt.c_str(), pt.c_str()) != 0) {
+      XLOG(ERR, "Rename file fault: ", tmp_pt);
+      return false;
+    }
+    return true;
+  }
+
+  // Dump to pt every interval seconds, until StopDump().
+  void StartDump(const std::string& pt, const size_t interval) {
+    if (dump_thread_ != nullptr) return;
+    dump_pt_ = pt;
+    dump_switch_ = true;
+    dump_thread_ = std::make_unique<std::thread>([this, interval]() {
+      std::unique_lock<std::mutex> lck(dump_mtx_);
+      while (!dump_cv_.wait_for(lck, std::chrono::seconds(interval),
+                                [this] { return !dump_switch_; }))
+        WritePrometheus(dump_pt_);
+    });
+  }
+
+  // Stop the periodic dump, and write a last one.
+  void StopDump() {
+    if (dump_thread_ == nullptr) return;
+    {
+      std::lock_guard<std::mutex> lck(dump_mtx_);
+      dump_switch_ = false;
+    }
+    dump_cv_.notify_all();
+    dump_thread_->join();
+    dump_thread_.reset();
+    WritePrometheus(dump_pt_);
+  }
+
+  void LogSummary() {
+    Sample();
+    double read_time = GetSum("minigraph_load_seconds");
+    double compute_time = GetSum("minigraph_compute_seconds");
+    double write_time = GetSum("minigraph_discharge_seconds");
+    LOG_INFO("Metrics: bytes read: ", GetSum("minigraph_read_bytes_total"),
+             ", bytes written: ", GetSum("minigraph_written_bytes_total"),
+             ", shortcut reads: ", GetSum("minigraph_shortcut_reads_total"),
+             ", active vertexes: ", GetSum("minigraph_active_vertexes_total"),
+             ", cas retries: ", GetSum("minigraph_cas_retries_total"),
+             ", resident memory: ", GetSum("minigraph_resident_memory_bytes"));
+    LOG_INFO("Metrics: load: ", read_time, "s, compute: ", compute_time,
+             "s, discharge: ", write_time,
+             "s, io ratio: ", GetSum("minigraph_io_ratio"));
+  }
+
+ private:
+  struct Series {
+    double sum = 0;
+    size_t count = 0;
+    std::vector<size_t> buckets;
+  };
+
+  struct Family {
+    std::string name;
+    Type type;
+    const char* help;
+    // Name of the integer label, or nullptr.
+    const char* label;
+    std::mutex mtx;
+    std::map<size_t, Series> series;
+  };
+
+  std::atomic<bool> enabled_{false};
+  // Families are fixed at construction, so that lookups need no lock.
+  std::vector<std::unique_ptr<Family>> families_;
+  size_t cas_retries_base_ = 0;
+
+  std::string dump_pt_;
+  bool dump_switch_ = false;
+  std::mutex dump_mtx_;
+  std::condition_variable dump_cv_;
+  std::unique_ptr<std::thread> dump_thread_;
+
+  Metrics() {
+    Register("minigraph_read_bytes_total", kCounter,
+             "Bytes read from disk per fragment.", "gid");
+    Register("minigraph_written_bytes_total", kCounter,
+             "Bytes written to disk per fragment.", "gid");
+    Register("minigraph_load_seconds", kHistogram,
+             "Latency of reading a fragment in LC.");
+    Register("minigraph_compute_seconds", kHistogram,
+             "Latency of PEval (inc_type 0) or IncEval (inc_type 1) in CC.",
+             "inc_type");
+    Register("minigraph_discharge_seconds", kHistogram,
+             "Latency of writing back and erasing a fragment in DC.");
+    Register("minigraph_task_queue_depth", kGauge,
+             "Fragments waiting in the task queue for CC.");
+    Register("minigraph_partial_result_queue_depth", kGauge,
+             "Fragments waiting in the partial result queue for DC.");
+    Register("minigraph_shortcut_reads_total", kCounter,
+             "Fragments passed from LC to DC without being read.");
+    Register("minigraph_active_vertexes_total", kCounter,
+             "Vertexes active per superstep.", "superstep");
+    Register("minigraph_cas_retries_total", kCounter,
+             "Failed compare and swaps in write_min / write_max / write_add.");
+    Register("minigraph_resident_memory_bytes", kGauge,
+             "Resident set size of the process.");
+    Register("minigraph_io_ratio", kGauge,
+             "Share of load and discharge in the load, compute and discharge "
+             "time, close to 1 for I/O-bound runs.");
+  }
+
+  void Register(const char* name, const Type type, const char* help,
+                const char* label = nullptr) {
+    auto family = std::make_unique<Family>();
+    family->name = name;
+    family->type = type;
+    family->help = help;
+    family->label = label;
+    families_.push_back(std::move(family));
+  }
+
+  Family* GetFamily(const std::string& name) {
+    for (auto& family : families_)
+      if (family->name == name) return family.get();
+    XLOG(ERR, "Unknown metric: ", name);
+    return nullptr;
+  }
+
+  // Update the metrics sampled rather than recorded as they happen.
+  void Sample() {
+    if (!IsEnabled()) return;
+    Set("minigraph_cas_retries_total", cas_retries.load() - cas_retries_base_);
+    size_t pages = 0, resident_pages = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (statm >> pages >> resident_pages)
+      Set("minigraph_resident_memory_bytes",
+          (double)resident_pages * sysconf(_SC_PAGESIZE));
+    double io_time = GetSum("minigraph_load_seconds") +
+                     GetSum("minigraph_discharge_seconds");
+    double total_time = io_time + GetSum("minigraph_compute_seconds");
+    Set("minigraph_io_ratio", total_time > 0 ? io_time / total_time : 0);
+  }
+
+  static std::string Braces(const std::string& label) {
+    return label == "" ? "" : "{" + label + "}";
+  }
+};
+
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_METRICS_H
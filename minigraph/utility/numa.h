@@ -0,0 +1,80 @@
+#ifndef MINIGRAPH_UTILITY_NUMA_H
+#define MINIGRAPH_UTILITY_NUMA_H
+
+#include <sched.h>
+
+#include <algorithm>
+#include <cstddef>
+
+#ifdef USE_NUMA
+#include <numa.h>
+#endif
+
+namespace minigraph {
+namespace utility {
+
+// Helpers to place fragments and the threads computing on them on NUMA
+// nodes. Fragment gid lives on node gid % NumNUMANodes(): DataMngr reads it
+// with the loading thread bound to that node, so that its buffers are first
+// touched there, and ComputingComponent runs it on the thread pool pinned to
+// that node. Without libnuma (USE_NUMA), or on a single node, all of these
+// are no-ops.
+
+inline size_t NumNUMANodes() {
+#ifdef USE_NUMA
+  static const size_t num_nodes =
+      numa_available() < 0 ? 1 : std::max(numa_num_configured_nodes(), 1);
+  return num_nodes;
+#else
+  return 1;
+#endif
+}
+
+template <typename GID_T>
+size_t NUMANodeOf(const GID_T gid) {
+  return (size_t)gid % NumNUMANodes();
+}
+
+// Restrict the calling thread to the cpus of node.
+inline bool PinThreadToNUMANode(const size_t node) {
+#ifdef USE_NUMA
+  if (NumNUMANodes() <= 1) return false;
+  return numa_run_on_node((int)node) == 0;
+#else
+  return false;
+#endif
+}
+
+// Binds the calling thread to a node within its scope: it runs on the cpus
+// of the node, and allocates pages there first.
+class NUMANodeBinding {
+ public:
+  explicit NUMANodeBinding(const size_t node) {
+#ifdef USE_NUMA
+    if (NumNUMANodes() <= 1) return;
+    if (sched_getaffinity(0, sizeof(cpu_set_), &cpu_set_) != 0) return;
+    bound_ = PinThreadToNUMANode(node);
+    numa_set_preferred((int)node);
+#endif
+  }
+
+  ~NUMANodeBinding() {
+#ifdef USE_NUMA
+    if (NumNUMANodes() <= 1) return;
+    numa_set_localalloc();
+    if (bound_) sched_setaffinity(0, sizeof(cpu_set_), &cpu_set_);
+#endif
+  }
+
+  NUMANodeBinding(const NUMANodeBinding&) = delete;
+  NUMANodeBinding& operator=(const NUMANodeBinding&) = delete;
+
+ private:
+  cpu_set_t cpu_set_;
+  bool bound_ = false;
+};
+
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_NUMA_H
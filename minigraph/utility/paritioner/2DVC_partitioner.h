@@ -58,7 +58,8 @@ class TwoDVCPartitioner : public PartitionerBase<GRAPH_T> {
 
     minigraph::utility::io::DataMngr<CSR_T> data_mngr;
     VID_T aligned_max_vid =
-        ceil(edgelist_graph->max_vid_ / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+        ceil(((size_t)edgelist_graph->max_vid_ + 1) / ALIGNMENT_FACTOR) *
+        ALIGNMENT_FACTOR;
     this->vid_map_ = (VID_T*)malloc(sizeof(VID_T) * aligned_max_vid);
     memset(this->vid_map_, 0, sizeof(VID_T) * aligned_max_vid);
     size_t* num_in_edges = (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
@@ -0,0 +1,182 @@
+#ifndef MINIGRAPH_UTILITY_COST_BALANCED_PARTITIONER_H
+#define MINIGRAPH_UTILITY_COST_BALANCED_PARTITIONER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "graphs/csr_builder.h"
+#include "portability/sys_types.h"
+#include "utility/bitmap.h"
+#include "utility/cost_model.h"
+#include "utility/logging.h"
+#include "utility/paritioner/partitioner_base.h"
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+// CostBalancedPartitioner cuts the vid space into contiguous ranges, as
+// EdgeCutPartitioner does, but places the boundaries so that every fragment
+// gets the same predicted cost instead of the same number of vertexes. The
+// cost of a fragment is the CostModel prediction on its StatisticInfo plus
+// the time to load its bytes at load_bandwidth MB/s. Both are sums over
+// vertexes once dlv, the number of out-neighbors in the same fragment, is
+// known, so boundaries are found by a prefix sum over per vertex costs. As
+// dlv depends on the boundaries, this is repeated from dlv = dgv until the
+// boundaries no longer move, for at most kMaxRounds rounds.
+template <typename GRAPH_T>
+class CostBalancedPartitioner : public PartitionerBase<GRAPH_T> {
+  using GID_T = typename GRAPH_T::gid_t;
+  using VID_T = typename GRAPH_T::vid_t;
+  using VDATA_T = typename GRAPH_T::vdata_t;
+  using EDATA_T = typename GRAPH_T::edata_t;
+  using CSR_BUILDER_T = graphs::CSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T>;
+  using EDGE_LIST_T =
+      minigraph::graphs::EdgeList<gid_t, vid_t, vdata_t, edata_t>;
+
+ public:
+  CostBalancedPartitioner(const CostModel& cost_model = CostModel(),
+                          const double load_bandwidth = 1024) {
+    cost_model_ = cost_model;
+    seconds_per_byte_ = 1 / (load_bandwidth * 1024 * 1024);
+  }
+  ~CostBalancedPartitioner() = default;
+
+  bool ParallelPartition(EDGE_LIST_T* edgelist_graph,
+                         const size_t num_partitions = 1,
+                         const size_t cores = 1, const std::string dst_pt = "",
+                         bool delete_graph = false) override {
+    LOG_INFO("ParallelPartition(): CostBalanced");
+    this->max_vid_ = edgelist_graph->get_max_vid();
+    this->num_edges_ = edgelist_graph->get_num_edges();
+    this->num_vertexes_ = edgelist_graph->get_num_vertexes();
+
+    LOG_INFO("Run: Count degrees, scan offsets and scatter edges");
+    CSR_BUILDER_T csr_builder(edgelist_graph->buf_graph_, this->num_edges_,
+                              this->max_vid_, cores, true);
+    delete edgelist_graph;
+    // As vid_map_ and the border bits, set from csr_builder.
+    this->aligned_max_vid_ = csr_builder.get_aligned_max_vid();
+
+    size_t num_vids = (size_t)this->max_vid_ + 1;
+    std::vector<GID_T> gid_by_vid(num_vids, 0);
+    std::vector<double> cost(num_vids, 0);
+    std::vector<size_t> bounds(num_partitions + 1, 0);
+    for (size_t round = 0; round < kMaxRounds; round++) {
+      ComputeCost(csr_builder, gid_by_vid, round == 0, cores, &cost);
+      std::vector<size_t> new_bounds = Cut(cost, num_partitions);
+      if (new_bounds == bounds) break;
+      bounds.swap(new_bounds);
+      for (GID_T gid = 0; gid < num_partitions; gid++)
+        std::fill(gid_by_vid.begin() + bounds[gid],
+                  gid_by_vid.begin() + bounds[gid + 1], gid);
+      LOG_INFO("  round: ", round, " max / mean cost: ",
+               MaxOverMean(cost, bounds));
+    }
+
+    this->BuildEdgeCutFragments(csr_builder, gid_by_vid, num_partitions,
+                                cores, dst_pt, delete_graph);
+    return true;
+  }
+
+ private:
+  static constexpr size_t kMaxRounds = 5;
+
+  CostModel cost_model_;
+  double seconds_per_byte_ = 0;
+
+  // Cost of each vertex as a member of the fragment gid_by_vid assigns it
+  // to, or of a fragment holding all its out-neighbors if no_cut.
+  void ComputeCost(const CSR_BUILDER_T& csr_builder,
+                   const std::vector<GID_T>& gid_by_vid, const bool no_cut,
+                   const size_t cores, std::vector<double>* cost) {
+    auto thread_pool = CPUThreadPool(cores, 1);
+    std::mutex mtx;
+    std::condition_variable finish_cv;
+    std::unique_lock<std::mutex> lck(mtx);
+    std::atomic<size_t> pending_packages(cores);
+    Bitmap* vertex_indicator = csr_builder.GetVertexIndicator();
+    size_t num_vids = cost->size();
+    size_t vertex_bytes = sizeof(VID_T) + 4 * sizeof(size_t) + sizeof(VDATA_T);
+    for (size_t tid = 0; tid < cores; tid++) {
+      thread_pool.Commit([this, tid, &cores, &num_vids, &vertex_bytes,
+                          &vertex_indicator, &csr_builder, &gid_by_vid,
+                          &no_cut, &cost, &pending_packages, &finish_cv]() {
+        StatisticInfo si;
+        for (size_t vid = tid; vid < num_vids; vid += cores) {
+          if (!vertex_indicator->get_bit(vid)) {
+            (*cost)[vid] = 0;
+            continue;
+          }
+          size_t dgv = csr_builder.get_outdegree(vid);
+          size_t dlv = dgv;
+          if (!no_cut) {
+            auto out_edges = csr_builder.get_out_edges(vid);
+            for (size_t i = 0; i < dgv; i++)
+              if (gid_by_vid[out_edges[i]] != gid_by_vid[vid]) dlv--;
+          }
+          si.sum_dlv = dlv;
+          si.sum_dgv = dgv;
+          si.sum_dlv_times_dlv = dlv * dlv;
+          si.sum_dlv_times_dgv = dlv * dgv;
+          si.sum_dgv_times_dgv = dgv * dgv;
+          si.sum_out_border_vertexes = dgv - dlv;
+          si.num_edges = csr_builder.get_indegree(vid) + dgv;
+          si.num_vertexes = 1;
+          // PEval starts from every vertex. niters is not a sum over
+          // vertexes, hence left out.
+          si.num_active_vertexes = 1;
+          (*cost)[vid] = cost_model_.PredictVariable(si) +
+                         seconds_per_byte_ *
+                             (vertex_bytes + sizeof(VID_T) * si.num_edges);
+        }
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
+    }
+    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+  }
+
+  // Fragment gid takes vids [bounds[gid], bounds[gid + 1]), where the prefix
+  // sum of costs crosses gid / num_partitions of the total.
+  std::vector<size_t> Cut(const std::vector<double>& cost,
+                          const size_t num_partitions) {
+    double total = 0;
+    for (auto c : cost) total += c;
+    std::vector<size_t> bounds(num_partitions + 1, cost.size());
+    bounds[0] = 0;
+    double prefix = 0;
+    size_t gid = 1;
+    for (size_t vid = 0; vid < cost.size() && gid < num_partitions; vid++) {
+      while (gid < num_partitions && prefix >= total * gid / num_partitions)
+        bounds[gid++] = vid;
+      prefix += cost[vid];
+    }
+    return bounds;
+  }
+
+  double MaxOverMean(const std::vector<double>& cost,
+                     const std::vector<size_t>& bounds) {
+    double max_cost = 0, total = 0;
+    for (size_t gid = 0; gid + 1 < bounds.size(); gid++) {
+      double fragment_cost = 0;
+      for (size_t vid = bounds[gid]; vid < bounds[gid + 1]; vid++)
+        fragment_cost += cost[vid];
+      max_cost = std::max(max_cost, fragment_cost);
+      total += fragment_cost;
+    }
+    return total > 0 ? max_cost * (bounds.size() - 1) / total : 1;
+  }
+};
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_COST_BALANCED_PARTITIONER_H
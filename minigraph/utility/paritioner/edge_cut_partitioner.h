@@ -1,6 +1,7 @@
 #ifndef MINIGRAPH_UTILITY_EDGE_CUT_PARTITIONER_H
 #define MINIGRAPH_UTILITY_EDGE_CUT_PARTITIONER_H
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <stdio.h>
@@ -10,6 +11,7 @@
 #include <folly/AtomicHashMap.h>
 #include <folly/FBVector.h>
 
+#include "graphs/csr_builder.h"
 #include "portability/sys_types.h"
 #include "utility/bitmap.h"
 #include "utility/io/csr_io_adapter.h"
@@ -65,139 +67,24 @@ class EdgeCutPartitioner : public PartitionerBase<GRAPH_T> {
 
     auto max_vid = edgelist_graph->get_max_vid();
     this->max_vid_ = edgelist_graph->get_max_vid();
-    this->aligned_max_vid_ =
-        ceil(edgelist_graph->get_aligned_max_vid() / ALIGNMENT_FACTOR) *
-        ALIGNMENT_FACTOR;
-    auto aligned_max_vid = this->aligned_max_vid_;
     auto num_vertexes = edgelist_graph->get_num_vertexes();
     this->num_vertexes_ = edgelist_graph->get_num_vertexes();
     auto num_edges = edgelist_graph->get_num_edges();
     this->num_edges_ = edgelist_graph->get_num_edges();
     size_t num_new_buckets = NUM_NEW_BUCKETS;
     this->num_partitions = num_partitions + NUM_NEW_BUCKETS - 1;
-    this->global_border_vid_map_ = new Bitmap(this->aligned_max_vid_);
-    this->global_border_vid_map_->clear();
-
-    Bitmap* vertex_indicator =
-        new Bitmap(edgelist_graph->get_aligned_max_vid());
-    vertex_indicator->clear();
-
-    size_t* num_in_edges =
-        (size_t*)malloc(sizeof(size_t) * edgelist_graph->get_aligned_max_vid());
-    size_t* num_out_edges =
-        (size_t*)malloc(sizeof(size_t) * edgelist_graph->get_aligned_max_vid());
-    memset(num_in_edges, 0,
-           sizeof(size_t) * edgelist_graph->get_aligned_max_vid());
-    memset(num_out_edges, 0,
-           sizeof(size_t) * edgelist_graph->get_aligned_max_vid());
-
-    LOG_INFO("Run: Go through every edges to count the size of each vertex");
-    pending_packages.store(cores);
-    for (size_t tid = 0; tid < cores; tid++) {
-      thread_pool.Commit([tid, &cores, &edgelist_graph, &vertex_indicator,
-                          &num_out_edges, &num_in_edges, &pending_packages,
-                          &finish_cv]() {
-        for (size_t j = tid; j < edgelist_graph->get_num_edges(); j += cores) {
-          auto src_vid = edgelist_graph->buf_graph_[j * 2];
-          auto dst_vid = edgelist_graph->buf_graph_[j * 2 + 1];
-	  if(src_vid == dst_vid) continue;
-          if (!vertex_indicator->get_bit(src_vid)) {
-            vertex_indicator->set_bit(src_vid);
-          }
-          if (!vertex_indicator->get_bit(dst_vid)) {
-            vertex_indicator->set_bit(dst_vid);
-          }
-          write_add(num_out_edges + src_vid, (size_t)1);
-          write_add(num_in_edges + dst_vid, (size_t)1);
-        }
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
-    }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
-
-    graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>** vertexes = nullptr;
-    vertexes = (graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>**)malloc(
-        sizeof(graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>*) *
-        edgelist_graph->get_aligned_max_vid());
-
-    for (size_t i = 0; i < aligned_max_vid; i++) vertexes[i] = nullptr;
-
-    LOG_INFO("Run: Pre join edges");
-    pending_packages.store(cores);
-
-    for (size_t tid = 0; tid < cores; tid++) {
-      thread_pool.Commit([tid, &cores, aligned_max_vid, &vertex_indicator,
-                          &num_in_edges, &num_out_edges, &vertexes,
-                          &pending_packages, &finish_cv]() {
-        for (size_t global_id = tid; global_id < aligned_max_vid;
-             global_id += cores) {
-          if (!vertex_indicator->get_bit(global_id)) continue;
-          auto u = new graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>();
-          u->vid = global_id;
-          u->indegree = num_in_edges[u->vid];
-          u->outdegree = num_out_edges[u->vid];
-          u->in_edges = (VID_T*)malloc(sizeof(VID_T) * (u->indegree));
-          memset(u->in_edges, 0, sizeof(VID_T) * (u->indegree));
-          u->out_edges = (VID_T*)malloc(sizeof(VID_T) * (u->outdegree));
-          memset(u->out_edges, 0, sizeof(VID_T) * (u->outdegree));
-          vertexes[global_id] = u;
-        }
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
-    }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
-
-    free(num_in_edges);
-    free(num_out_edges);
-    num_in_edges = nullptr;
-    num_out_edges = nullptr;
-
-    LOG_INFO("Run: Join edges");
-    size_t* offset_in_edges = (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
-    size_t* offset_out_edges =
-        (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
-    memset(offset_in_edges, 0, sizeof(size_t) * aligned_max_vid);
-    memset(offset_out_edges, 0, sizeof(size_t) * aligned_max_vid);
-
-    pending_packages.store(cores);
-    for (size_t tid = 0; tid < cores; tid++) {
-      thread_pool.Commit([tid, &cores, &edgelist_graph, &vertexes, &num_edges,
-                          &offset_in_edges, &offset_out_edges, &lck,
-                          &pending_packages, &finish_cv]() {
-        for (size_t j = tid; j < num_edges; j += cores) {
-          auto src_vid = edgelist_graph->buf_graph_[j * 2];
-          auto dst_vid = edgelist_graph->buf_graph_[j * 2 + 1];
-	  if(src_vid == dst_vid) continue;
-          assert(vertexes[src_vid] != nullptr);
-          assert(vertexes[dst_vid] != nullptr);
-          auto offset_out = __sync_fetch_and_add(offset_out_edges + src_vid, 1);
-          auto offset_in = __sync_fetch_and_add(offset_in_edges + dst_vid, 1);
-          vertexes[src_vid]->out_edges[offset_out] = dst_vid;
-          vertexes[dst_vid]->in_edges[offset_in] = src_vid;
-          // vertexes[src_vid]
-          //     ->out_edges[__sync_fetch_and_add(offset_out_edges + src_vid,
-          //     1)] = dst_vid;
-          // vertexes[dst_vid]
-          //     ->in_edges[__sync_fetch_and_add(offset_in_edges + dst_vid, 1)]
-          //     = src_vid;
-        }
-
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
-    }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
 
-    VID_T local_id_for_each_bucket[num_partitions] = {0};
+    LOG_INFO("Run: Count degrees, scan offsets and scatter edges");
+    graphs::CSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T> csr_builder(
+        edgelist_graph->buf_graph_, num_edges, max_vid, cores, true);
     delete edgelist_graph;
-    free(offset_in_edges);
-    free(offset_out_edges);
+    // Vid-indexed maps hold max_vid + 1 entries, as those of csr_builder.
+    this->aligned_max_vid_ = csr_builder.get_aligned_max_vid();
+    auto aligned_max_vid = this->aligned_max_vid_;
+    this->global_border_vid_map_ = new Bitmap(aligned_max_vid);
+    this->global_border_vid_map_->clear();
+    Bitmap* vertex_indicator = csr_builder.GetVertexIndicator();
 
-    LOG_INFO("  Init");
-    size_t* offset_fragments = (size_t*)malloc(sizeof(size_t) * num_partitions);
-    memset(offset_fragments, 0, sizeof(size_t) * num_partitions);
     size_t* sum_in_edges_by_fragments =
         (size_t*)malloc(sizeof(size_t) * num_partitions);
     memset(sum_in_edges_by_fragments, 0, sizeof(size_t) * num_partitions);
@@ -205,25 +92,18 @@ class EdgeCutPartitioner : public PartitionerBase<GRAPH_T> {
         (size_t*)malloc(sizeof(size_t) * num_partitions);
     memset(sum_out_edges_by_fragments, 0, sizeof(size_t) * num_partitions);
 
-    auto fragments = (graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>***)malloc(
-        sizeof(graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>**) * num_partitions);
-
-    for (size_t i = 0; i < num_partitions; i++) {
-      fragments[i] = (graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>**)malloc(
-          sizeof(graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>*) *
-          (this->aligned_max_vid_));
-      for (size_t j = 0; j < this->aligned_max_vid_; j++)
-        fragments[i][j] = nullptr;
-    }
-
     size_t num_vertexes_per_bucket[num_partitions] = {0};
-    VID_T max_vid_per_bucket[num_partitions] = {0};
     Bitmap* is_in_bucketX[num_partitions + num_new_buckets];
     for (size_t i = 0; i < num_partitions + num_new_buckets; i++) {
       is_in_bucketX[i] = new Bitmap(aligned_max_vid);
       is_in_bucketX[i]->clear();
     }
 
+    // Bucket of each vertex, then its fragment.
+    std::vector<GID_T> gid_by_vid(aligned_max_vid, GID_MAX);
+    std::vector<GID_T> gid_by_bucket(num_partitions + num_new_buckets,
+                                     GID_MAX);
+
     auto set_graphs = (graphs::Graph<GID_T, VID_T, VDATA_T, EDATA_T>**)malloc(
         sizeof(graphs::Graph<GID_T, VID_T, VDATA_T, EDATA_T>*) *
         (num_partitions + num_new_buckets));
@@ -231,34 +111,29 @@ class EdgeCutPartitioner : public PartitionerBase<GRAPH_T> {
       set_graphs[i] = nullptr;
 
     LOG_INFO("Run: Fill buckets.");
-    size_t count = 0;
-    GID_T gid = 0;
     pending_packages.store(cores);
     for (size_t tid = 0; tid < cores; tid++) {
-      thread_pool.Commit([tid, &cores, &is_in_bucketX, &aligned_max_vid,
-                          &num_vertexes, &vertexes, &fragments,
-                          &max_vid_per_bucket, &num_partitions,
-                          &local_id_for_each_bucket, &sum_in_edges_by_fragments,
+      thread_pool.Commit([tid, &cores, &is_in_bucketX, &max_vid,
+                          &csr_builder, &num_partitions, &gid_by_vid,
+                          &sum_in_edges_by_fragments,
                           &sum_out_edges_by_fragments, &vertex_indicator,
                           &num_vertexes_per_bucket, &num_vertexes,
                           &pending_packages, &finish_cv]() {
-        for (VID_T global_vid = tid; global_vid < aligned_max_vid;
+        for (size_t global_vid = tid; global_vid <= max_vid;
              global_vid += cores) {
           if (!vertex_indicator->get_bit(global_vid)) continue;
-          auto u = vertexes[global_vid];
 
           // GID_T gid = (global_vid % num_partitions);
           GID_T gid = (unsigned)floor(
                           ((double)global_vid / ceil((double)num_vertexes /
                                                      (double)num_partitions))) %
                       num_partitions;
-          fragments[gid][global_vid] = u;
-          if (max_vid_per_bucket[gid] < global_vid)
-            write_max(max_vid_per_bucket + gid, (VID_T)global_vid);
           is_in_bucketX[gid]->set_bit(global_vid);
-          u->vid = global_vid;
-          write_add(sum_in_edges_by_fragments + gid, u->indegree);
-          write_add(sum_out_edges_by_fragments + gid, u->outdegree);
+          gid_by_vid[global_vid] = gid;
+          write_add(sum_in_edges_by_fragments + gid,
+                    csr_builder.get_indegree(global_vid));
+          write_add(sum_out_edges_by_fragments + gid,
+                    csr_builder.get_outdegree(global_vid));
           write_add(num_vertexes_per_bucket + gid, (size_t)1);
         }
         if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
@@ -267,11 +142,9 @@ class EdgeCutPartitioner : public PartitionerBase<GRAPH_T> {
     }
     finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
 
-    free(vertexes);
-
-    auto vid_map = (VID_T*)malloc(sizeof(VID_T) * this->aligned_max_vid_);
+    auto vid_map = (VID_T*)malloc(sizeof(VID_T) * aligned_max_vid);
     this->vid_map_ = vid_map;
-    memset(this->vid_map_, 0, sizeof(VID_T) * this->aligned_max_vid_);
+    memset(this->vid_map_, 0, sizeof(VID_T) * aligned_max_vid);
 
     // this->vid_map_ = (VID_T*)malloc(sizeof(VID_T) * this->aligned_max_vid_);
     // memset(this->vid_map_, 0, sizeof(VID_T) * this->aligned_max_vid_);
@@ -294,78 +167,38 @@ class EdgeCutPartitioner : public PartitionerBase<GRAPH_T> {
       }
 
       LOG_INFO("  Split gid: ", bucket_id_to_be_splitted);
+      Bitmap* bucket_to_be_splitted = is_in_bucketX[bucket_id_to_be_splitted];
       is_in_bucketX[bucket_id_to_be_splitted] = nullptr;
-      size_t* sum_in_edges_by_new_fragments =
-          (size_t*)malloc(sizeof(size_t) * num_new_buckets);
-      memset(sum_in_edges_by_new_fragments, 0,
-             sizeof(size_t) * num_new_buckets);
-      size_t* sum_out_edges_by_new_fragments =
-          (size_t*)malloc(sizeof(size_t) * num_new_buckets);
-      memset(sum_out_edges_by_new_fragments, 0,
-             sizeof(size_t) * num_new_buckets);
-      size_t num_vertexes_per_new_bucket[num_new_buckets] = {0};
-
-      auto new_fragments =
-          (graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>***)malloc(
-              sizeof(graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>**) *
-              num_new_buckets);
-
-      for (size_t i = 0; i < num_new_buckets; i++) {
-        new_fragments[i] =
-            (graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>**)malloc(
-                sizeof(graphs::VertexInfo<VID_T, VDATA_T, EDATA_T>*) *
-                (this->aligned_max_vid_));
-        for (size_t j = 0; j < this->aligned_max_vid_; j++)
-          new_fragments[i][j] = nullptr;
-      }
 
       LOG_INFO("Run: Prepare splitting");
-
       pending_packages.store(cores);
       for (size_t tid = 0; tid < cores; tid++) {
-        thread_pool.Commit(
-            [tid, &cores, &is_in_bucketX, &aligned_max_vid, &num_new_buckets,
-             &new_fragments, &fragments, &bucket_id_to_be_splitted,
-             &num_partitions, &vertex_indicator, &local_id_for_each_bucket,
-             &sum_in_edges_by_new_fragments, &sum_out_edges_by_new_fragments,
-             &num_vertexes_per_new_bucket, &num_vertexes_per_bucket,
-             &pending_packages, &finish_cv]() {
-              for (VID_T global_vid = tid; global_vid < aligned_max_vid;
-                   global_vid += cores) {
-                if (fragments[bucket_id_to_be_splitted][global_vid] == nullptr)
-                  continue;
-                auto u = fragments[bucket_id_to_be_splitted][global_vid];
-                GID_T gid = (global_vid % num_new_buckets);
-                is_in_bucketX[gid + num_partitions]->set_bit(global_vid);
-                new_fragments[gid][u->vid] = u;
-                write_add(sum_in_edges_by_new_fragments + gid,
-                          (size_t)u->indegree);
-                write_add(sum_out_edges_by_new_fragments + gid,
-                          (size_t)u->outdegree);
-                write_add(num_vertexes_per_new_bucket + gid, (size_t)1);
-              }
-
-              if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-              return;
-            });
+        thread_pool.Commit([tid, &cores, &is_in_bucketX, &max_vid,
+                            &num_new_buckets, &bucket_to_be_splitted,
+                            &num_partitions, &gid_by_vid, &pending_packages,
+                            &finish_cv]() {
+          for (size_t global_vid = tid; global_vid <= max_vid;
+               global_vid += cores) {
+            if (!bucket_to_be_splitted->get_bit(global_vid)) continue;
+            GID_T gid = (global_vid % num_new_buckets);
+            is_in_bucketX[gid + num_partitions]->set_bit(global_vid);
+            gid_by_vid[global_vid] = gid + num_partitions;
+          }
+
+          if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+          return;
+        });
       }
       finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+      delete bucket_to_be_splitted;
 
       LOG_INFO("Run: Construct splitted sub-graphs");
 
       for (size_t gid = 0; gid < num_new_buckets; gid++) {
         auto local_gid = __sync_fetch_and_add(&atom_gid, 1);
-        auto graph = new graphs::ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>(
-            local_gid, new_fragments[gid], num_vertexes_per_new_bucket[gid],
-            sum_in_edges_by_new_fragments[gid],
-            sum_out_edges_by_new_fragments[gid],
-            max_vid_per_bucket[bucket_id_to_be_splitted], vid_map);
-
-        for (size_t i = 0; i < max_vid_per_bucket[bucket_id_to_be_splitted];
-             i++) {
-          if (new_fragments[gid][i] != nullptr) delete new_fragments[gid][i];
-        }
-        free(new_fragments[gid]);
+        gid_by_bucket[gid + num_partitions] = local_gid;
+        auto graph = csr_builder.Build(
+            local_gid, is_in_bucketX[gid + num_partitions], vid_map);
         if (!delete_graph) {
           set_graphs[local_gid] =
               (graphs::Graph<GID_T, VID_T, VDATA_T, EDATA_T>*)graph;
@@ -396,14 +229,8 @@ class EdgeCutPartitioner : public PartitionerBase<GRAPH_T> {
     for (size_t gid = 0; gid < num_partitions; gid++) {
       if (gid == bucket_id_to_be_splitted) continue;
       auto local_gid = __sync_fetch_and_add(&atom_gid, 1);
-      auto graph = new graphs::ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>(
-          local_gid, fragments[gid], num_vertexes_per_bucket[gid],
-          sum_in_edges_by_fragments[gid], sum_out_edges_by_fragments[gid],
-          max_vid_per_bucket[gid], vid_map);
-      for (size_t i = 0; i < max_vid_per_bucket[gid]; i++) {
-        delete fragments[gid][i];
-      }
-      free(fragments[gid]);
+      gid_by_bucket[gid] = local_gid;
+      auto graph = csr_builder.Build(local_gid, is_in_bucketX[gid], vid_map);
       graph->InitVdata2AllX(0);
       graph->SetGlobalBorderVidMap(this->global_border_vid_map_, is_in_bucketX,
                                    (num_partitions + num_new_buckets - 1));
@@ -438,19 +265,12 @@ class EdgeCutPartitioner : public PartitionerBase<GRAPH_T> {
     }
 
     LOG_INFO("Run: Set communication matrix");
-    this->communication_matrix_ =
-        (bool*)malloc(sizeof(bool) * (num_partitions + num_new_buckets - 1) *
-                      (num_partitions + num_new_buckets - 1));
-    memset(this->communication_matrix_, 0,
-           sizeof(bool) * (num_partitions + num_new_buckets - 1) *
-               (num_partitions + num_new_buckets - 1));
-    for (size_t i = 0; i < (num_partitions + num_new_buckets - 1) *
-                               (num_partitions + num_new_buckets - 1);
-         i++)
-      this->communication_matrix_[i] = 1;
-    for (size_t i = 0; i < (num_partitions + num_new_buckets - 1); i++)
-      *(this->communication_matrix_ +
-        i * (num_partitions + num_new_buckets - 1) + i) = 0;
+    for (auto& gid : gid_by_vid)
+      if (gid != GID_MAX) gid = gid_by_bucket[gid];
+    this->SetCommunicationMatrix(
+        this->CountCutEdges(csr_builder, gid_by_vid,
+                            num_partitions + num_new_buckets - 1, cores),
+        num_partitions + num_new_buckets - 1);
 
     LOG_INFO("Run: Set global_border_vid_map");
 
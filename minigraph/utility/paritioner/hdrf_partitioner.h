@@ -0,0 +1,237 @@
+#ifndef MINIGRAPH_UTILITY_HDRF_PARTITIONER_H
+#define MINIGRAPH_UTILITY_HDRF_PARTITIONER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "graphs/edgelist.h"
+#include "portability/sys_types.h"
+#include "utility/atomic.h"
+#include "utility/bitmap.h"
+#include "utility/io/csr_io_adapter.h"
+#include "utility/io/data_mngr.h"
+#include "utility/logging.h"
+#include "utility/paritioner/partitioner_base.h"
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+// HDRFPartitioner is a streaming vertex-cut partitioner using the High-Degree
+// Replicated First heuristic. Edges are placed one at a time, in input
+// order, on the fragment p that maximizes
+//   C_REP(u, v, p) + C_BAL(p)
+// with
+//   C_REP = g(u, p) + g(v, p), g(u, p) = 1 + (1 - theta(u)) if u is already
+//   on p, 0 otherwise, theta(u) = d(u) / (d(u) + d(v)),
+//   C_BAL = lambda * (max_size - |p|) / (epsilon + max_size - min_size),
+// where d() are the degrees seen so far. Vertexes of lower degree thus stay
+// on fewer fragments and hubs get replicated instead. lambda trades
+// replication for balance: 0 ignores balance apart from ties, large values
+// tend to round robin.
+template <typename GRAPH_T>
+class HDRFPartitioner : public PartitionerBase<GRAPH_T> {
+  using GID_T = typename GRAPH_T::gid_t;
+  using VID_T = typename GRAPH_T::vid_t;
+  using VDATA_T = typename GRAPH_T::vdata_t;
+  using EDATA_T = typename GRAPH_T::edata_t;
+  using CSR_T = graphs::ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>;
+  using EDGE_LIST_T =
+      minigraph::graphs::EdgeList<gid_t, vid_t, vdata_t, edata_t>;
+
+ public:
+  HDRFPartitioner(const double lambda = 1.0, const double epsilon = 1.0) {
+    lambda_ = lambda;
+    epsilon_ = epsilon;
+  }
+  ~HDRFPartitioner() = default;
+
+  bool ParallelPartition(EDGE_LIST_T* edgelist_graph,
+                         const size_t num_partitions = 1,
+                         const size_t cores = 1, const std::string dst_pt = "",
+                         bool delete_graph = false) override {
+    LOG_INFO("ParallelPartition(): HDRF, lambda: ", lambda_);
+    auto thread_pool = CPUThreadPool(cores, 1);
+    std::mutex mtx;
+    std::condition_variable finish_cv;
+    std::unique_lock<std::mutex> lck(mtx);
+    std::atomic<size_t> pending_packages(cores);
+
+    minigraph::utility::io::DataMngr<CSR_T> data_mngr;
+    this->max_vid_ = edgelist_graph->get_max_vid();
+    this->aligned_max_vid_ =
+        ceil(((size_t)this->max_vid_ + 1) / ALIGNMENT_FACTOR) *
+        ALIGNMENT_FACTOR;
+    VID_T aligned_max_vid = this->aligned_max_vid_;
+    this->vid_map_ = (VID_T*)malloc(sizeof(VID_T) * aligned_max_vid);
+    memset(this->vid_map_, 0, sizeof(VID_T) * aligned_max_vid);
+    this->global_border_vid_map_ = new Bitmap(aligned_max_vid);
+    this->global_border_vid_map_->clear();
+    this->num_partitions = num_partitions;
+    size_t num_edges = edgelist_graph->get_num_edges();
+
+    // is_in_bucketX[i] doubles as the replica set of fragment i.
+    Bitmap* is_in_bucketX[num_partitions];
+    for (size_t i = 0; i < num_partitions; i++) {
+      is_in_bucketX[i] = new Bitmap(aligned_max_vid);
+      is_in_bucketX[i]->clear();
+    }
+    size_t* size_per_bucket = new size_t[num_partitions];
+    memset(size_per_bucket, 0, sizeof(size_t) * num_partitions);
+    GID_T* gid_by_edge = (GID_T*)malloc(sizeof(GID_T) * num_edges);
+
+    LOG_INFO("Run: Stream edges.");
+    Assign(edgelist_graph, num_partitions, is_in_bucketX, size_per_bucket,
+           gid_by_edge);
+
+    VID_T** edges_buckets = (VID_T**)malloc(sizeof(VID_T*) * num_partitions);
+    for (GID_T i = 0; i < num_partitions; i++)
+      edges_buckets[i] = (VID_T*)malloc(sizeof(VID_T) * 2 * size_per_bucket[i]);
+    size_t* buckets_offset = new size_t[num_partitions];
+    memset(buckets_offset, 0, sizeof(size_t) * num_partitions);
+    VID_T* max_vid_per_bucket = new VID_T[num_partitions];
+    memset(max_vid_per_bucket, 0, sizeof(VID_T) * num_partitions);
+
+    LOG_INFO("Run: Drop edges into buckets.");
+    pending_packages.store(cores);
+    for (size_t tid = 0; tid < cores; tid++) {
+      thread_pool.Commit([tid, &cores, &num_edges, &edgelist_graph,
+                          &gid_by_edge, &max_vid_per_bucket, &buckets_offset,
+                          &edges_buckets, &pending_packages, &finish_cv]() {
+        for (size_t j = tid; j < num_edges; j += cores) {
+          auto src_vid = edgelist_graph->buf_graph_[j * 2];
+          auto dst_vid = edgelist_graph->buf_graph_[j * 2 + 1];
+          auto bucket_id = gid_by_edge[j];
+          write_max(max_vid_per_bucket + bucket_id, src_vid);
+          write_max(max_vid_per_bucket + bucket_id, dst_vid);
+          auto offset = __sync_fetch_and_add(buckets_offset + bucket_id, 1);
+          edges_buckets[bucket_id][offset * 2] = src_vid;
+          edges_buckets[bucket_id][offset * 2 + 1] = dst_vid;
+        }
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
+    }
+    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+    free(gid_by_edge);
+    delete edgelist_graph;
+
+    minigraph::utility::io::CSRIOAdapter<GID_T, VID_T, VDATA_T, EDATA_T>
+        csr_io_adapter;
+
+    LOG_INFO("Run: Construct sub-graphs");
+    if (this->fragments_ != nullptr) this->fragments_->clear();
+    for (size_t gid = 0; gid < num_partitions; gid++) {
+      auto edgelist_graph = new EDGE_LIST_T(
+          gid, size_per_bucket[gid], is_in_bucketX[gid]->get_num_bit(),
+          max_vid_per_bucket[gid], edges_buckets[gid]);
+      auto csr_graph = csr_io_adapter.EdgeList2CSR(gid, edgelist_graph, cores);
+      delete edgelist_graph;
+      free(edges_buckets[gid]);
+      csr_graph->InitVdata2AllX(0);
+      csr_graph->SetGlobalBorderVidMap(this->global_border_vid_map_,
+                                       is_in_bucketX, num_partitions);
+      csr_graph->Sort(cores);
+      if (!delete_graph) {
+        this->fragments_->push_back(csr_graph);
+      } else {
+        std::string meta_pt =
+            dst_pt + "minigraph_meta/" + std::to_string(gid) + ".bin";
+        std::string data_pt =
+            dst_pt + "minigraph_data/" + std::to_string(gid) + ".bin";
+        std::string vdata_pt =
+            dst_pt + "minigraph_vdata/" + std::to_string(gid) + ".bin";
+        data_mngr.csr_io_adapter_->Write(*csr_graph, csr_bin, false, meta_pt,
+                                         data_pt, vdata_pt);
+        StatisticInfo&& si = this->ParallelSetStatisticInfo(*csr_graph, cores);
+        std::string si_pt =
+            dst_pt + "minigraph_si/" + std::to_string(gid) + ".yaml";
+        data_mngr.WriteStatisticInfo(si, si_pt);
+        delete csr_graph;
+      }
+    }
+
+    LOG_INFO("Run: Set communication matrix");
+    this->SetCommunicationMatrix(
+        this->CountSharedVertexes(is_in_bucketX, num_partitions),
+        num_partitions);
+
+    for (size_t i = 0; i < num_partitions; i++) delete is_in_bucketX[i];
+    free(edges_buckets);
+    delete[] buckets_offset;
+    delete[] max_vid_per_bucket;
+    delete[] size_per_bucket;
+    LOG_INFO("END");
+    return true;
+  }
+
+ private:
+  double lambda_ = 1.0;
+  double epsilon_ = 1.0;
+
+  // Edges are placed in a single sequential pass, as every placement depends
+  // on the replica sets and sizes left by the previous ones.
+  void Assign(EDGE_LIST_T* edgelist_graph, const size_t num_partitions,
+              Bitmap** is_in_bucketX, size_t* size_per_bucket,
+              GID_T* gid_by_edge) {
+    size_t num_edges = edgelist_graph->get_num_edges();
+    size_t* partial_degree =
+        (size_t*)malloc(sizeof(size_t) * ((size_t)this->max_vid_ + 1));
+    memset(partial_degree, 0, sizeof(size_t) * ((size_t)this->max_vid_ + 1));
+    size_t max_size = 0, min_size = 0;
+
+    for (size_t j = 0; j < num_edges; j++) {
+      auto src_vid = edgelist_graph->buf_graph_[j * 2];
+      auto dst_vid = edgelist_graph->buf_graph_[j * 2 + 1];
+      double d_src = ++partial_degree[src_vid];
+      double d_dst = ++partial_degree[dst_vid];
+      double theta_src = d_src / (d_src + d_dst);
+      double theta_dst = 1 - theta_src;
+
+      GID_T best = 0;
+      double best_score = 0;
+      for (GID_T gid = 0; gid < num_partitions; gid++) {
+        double score = lambda_ * (max_size - size_per_bucket[gid]) /
+                       (epsilon_ + max_size - min_size);
+        if (is_in_bucketX[gid]->get_bit(src_vid)) score += 2 - theta_src;
+        if (is_in_bucketX[gid]->get_bit(dst_vid)) score += 2 - theta_dst;
+        if (gid == 0 || score > best_score ||
+            (score == best_score &&
+             size_per_bucket[gid] < size_per_bucket[best])) {
+          best = gid;
+          best_score = score;
+        }
+      }
+      gid_by_edge[j] = best;
+      if (!is_in_bucketX[best]->get_bit(src_vid))
+        is_in_bucketX[best]->set_bit(src_vid);
+      if (!is_in_bucketX[best]->get_bit(dst_vid))
+        is_in_bucketX[best]->set_bit(dst_vid);
+      if (++size_per_bucket[best] > max_size) max_size = size_per_bucket[best];
+      if (size_per_bucket[best] - 1 == min_size)
+        min_size = *std::min_element(size_per_bucket,
+                                     size_per_bucket + num_partitions);
+    }
+    free(partial_degree);
+
+    size_t num_replicas = 0;
+    for (size_t i = 0; i < num_partitions; i++) {
+      num_replicas += is_in_bucketX[i]->get_num_bit();
+      LOG_INFO("  GID: ", i, " num_edges: ", size_per_bucket[i]);
+    }
+    if (edgelist_graph->get_num_vertexes() > 0)
+      LOG_INFO("Replication factor: ",
+               (double)num_replicas / edgelist_graph->get_num_vertexes());
+  }
+};
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_HDRF_PARTITIONER_H
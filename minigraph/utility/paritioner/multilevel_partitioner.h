@@ -0,0 +1,364 @@
+#ifndef MINIGRAPH_UTILITY_MULTILEVEL_PARTITIONER_H
+#define MINIGRAPH_UTILITY_MULTILEVEL_PARTITIONER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graphs/csr_builder.h"
+#include "portability/sys_types.h"
+#include "utility/bitmap.h"
+#include "utility/logging.h"
+#include "utility/paritioner/partitioner_base.h"
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+// MultilevelPartitioner is a METIS-like edge-cut partitioner, for graphs
+// partitioned once and processed many times. It works on the undirected
+// graph, where an edge weighs the number of directed edges between its
+// endpoints:
+//  - coarsening: vertexes are matched with their unmatched neighbor of the
+//    heaviest edge and each pair is contracted into one vertex, until few
+//    vertexes are left or matching stops shrinking the graph.
+//  - initial partition: fragments are grown one after another on the
+//    coarsest graph, each time taking the vertex most connected to the
+//    fragment, up to total_weight / k.
+//  - refinement: the partition is projected back level by level, and at each
+//    level boundary vertexes greedily move to the fragment they are most
+//    connected to (k-way FM without hill climbing), as long as fragments stay
+//    below (1 + imbalance) * total_weight / k.
+// The edge cut is what drives sum_out_border_vertexes, so this trades a much
+// longer partitioning time for fewer messages at every IncEval.
+template <typename GRAPH_T>
+class MultilevelPartitioner : public PartitionerBase<GRAPH_T> {
+  using GID_T = typename GRAPH_T::gid_t;
+  using VID_T = typename GRAPH_T::vid_t;
+  using VDATA_T = typename GRAPH_T::vdata_t;
+  using EDATA_T = typename GRAPH_T::edata_t;
+  using CSR_BUILDER_T = graphs::CSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T>;
+  using EDGE_LIST_T =
+      minigraph::graphs::EdgeList<gid_t, vid_t, vdata_t, edata_t>;
+
+  // Undirected weighted graph of one level, in CSR. cmap maps each vertex
+  // to its vertex in the next, coarser, level.
+  struct Level {
+    std::vector<size_t> xadj;
+    std::vector<VID_T> adj;
+    std::vector<size_t> adjwgt;
+    std::vector<size_t> vwgt;
+    std::vector<VID_T> cmap;
+    size_t get_num_vertexes() const { return vwgt.size(); }
+  };
+
+ public:
+  MultilevelPartitioner(const double imbalance = 0.03,
+                        const size_t refine_passes = 8) {
+    imbalance_ = imbalance;
+    refine_passes_ = refine_passes;
+  }
+  ~MultilevelPartitioner() = default;
+
+  bool ParallelPartition(EDGE_LIST_T* edgelist_graph,
+                         const size_t num_partitions = 1,
+                         const size_t cores = 1, const std::string dst_pt = "",
+                         bool delete_graph = false) override {
+    LOG_INFO("ParallelPartition(): Multilevel");
+    this->max_vid_ = edgelist_graph->get_max_vid();
+    this->aligned_max_vid_ =
+        ceil(((size_t)this->max_vid_ + 1) / ALIGNMENT_FACTOR) *
+        ALIGNMENT_FACTOR;
+    this->num_edges_ = edgelist_graph->get_num_edges();
+    this->num_vertexes_ = edgelist_graph->get_num_vertexes();
+
+    LOG_INFO("Run: Count degrees, scan offsets and scatter edges");
+    CSR_BUILDER_T csr_builder(edgelist_graph->buf_graph_, this->num_edges_,
+                              this->max_vid_, cores, true);
+    delete edgelist_graph;
+
+    // Vertexes of the edge list get dense ids in the finest level.
+    std::vector<VID_T> vid_by_index;
+    vid_by_index.reserve(csr_builder.get_num_vertexes());
+    Bitmap* vertex_indicator = csr_builder.GetVertexIndicator();
+    for (size_t vid = 0; vid <= this->max_vid_; vid++)
+      if (vertex_indicator->get_bit(vid)) vid_by_index.push_back(vid);
+
+    std::vector<Level> levels(1);
+    BuildFinestLevel(csr_builder, vid_by_index, &levels[0]);
+    size_t coarsen_to = std::max((size_t)kMinCoarseVertexes * num_partitions,
+                                 (size_t)kMinCoarseVertexes);
+    LOG_INFO("Run: Coarsen. num_vertexes: ", levels[0].get_num_vertexes());
+    while (levels.back().get_num_vertexes() > coarsen_to) {
+      Level coarse;
+      size_t n = levels.back().get_num_vertexes();
+      if (!Coarsen(&levels.back(), coarsen_to, &coarse)) break;
+      LOG_INFO("  level: ", levels.size(), " num_vertexes: ",
+               coarse.get_num_vertexes(), " num_edges: ", coarse.adj.size());
+      levels.push_back(std::move(coarse));
+      if (levels.back().get_num_vertexes() > kMinShrink * n) break;
+    }
+
+    LOG_INFO("Run: Initial partition");
+    std::vector<GID_T> part;
+    InitialPartition(levels.back(), num_partitions, &part);
+    Refine(levels.back(), num_partitions, &part);
+    for (size_t i = levels.size() - 1; i > 0; i--) {
+      std::vector<GID_T> finer_part(levels[i - 1].get_num_vertexes());
+      for (size_t v = 0; v < finer_part.size(); v++)
+        finer_part[v] = part[levels[i - 1].cmap[v]];
+      part.swap(finer_part);
+      Refine(levels[i - 1], num_partitions, &part);
+    }
+    levels.clear();
+
+    std::vector<GID_T> gid_by_vid((size_t)this->max_vid_ + 1, GID_MAX);
+    for (size_t i = 0; i < vid_by_index.size(); i++)
+      gid_by_vid[vid_by_index[i]] = part[i];
+    this->BuildEdgeCutFragments(csr_builder, gid_by_vid, num_partitions,
+                                cores, dst_pt, delete_graph);
+    return true;
+  }
+
+ private:
+  // Coarsening stops at kMinCoarseVertexes vertexes per fragment, or once a
+  // level keeps more than kMinShrink of the vertexes of the previous one.
+  static constexpr size_t kMinCoarseVertexes = 64;
+  static constexpr double kMinShrink = 0.95;
+
+  double imbalance_ = 0.03;
+  size_t refine_passes_ = 8;
+
+  // Merge the in- and out-edges of each vertex into one weighted list.
+  void BuildFinestLevel(const CSR_BUILDER_T& csr_builder,
+                        const std::vector<VID_T>& vid_by_index, Level* level) {
+    size_t n = vid_by_index.size();
+    std::vector<VID_T> index_by_vid((size_t)this->max_vid_ + 1, 0);
+    for (size_t i = 0; i < n; i++) index_by_vid[vid_by_index[i]] = i;
+
+    level->xadj.assign(n + 1, 0);
+    level->vwgt.assign(n, 1);
+    level->adj.reserve(csr_builder.get_num_edges() * 2);
+    level->adjwgt.reserve(csr_builder.get_num_edges() * 2);
+    std::vector<size_t> slot(n, SIZE_MAX);
+    auto add = [&](const VID_T* nbrs, const size_t degree) {
+      for (size_t j = 0; j < degree; j++) {
+        VID_T u = index_by_vid[nbrs[j]];
+        if (slot[u] != SIZE_MAX) {
+          level->adjwgt[slot[u]]++;
+          continue;
+        }
+        slot[u] = level->adj.size();
+        level->adj.push_back(u);
+        level->adjwgt.push_back(1);
+      }
+    };
+    for (size_t i = 0; i < n; i++) {
+      VID_T vid = vid_by_index[i];
+      size_t begin = level->adj.size();
+      add(csr_builder.get_in_edges(vid), csr_builder.get_indegree(vid));
+      add(csr_builder.get_out_edges(vid), csr_builder.get_outdegree(vid));
+      for (size_t j = begin; j < level->adj.size(); j++)
+        slot[level->adj[j]] = SIZE_MAX;
+      level->xadj[i + 1] = level->adj.size();
+    }
+  }
+
+  // Heavy-edge matching in random order, then contraction of the matched
+  // pairs. Coarse vertexes weigh at most 1.5x the mean vertex weight at
+  // coarsen_to vertexes, to leave the initial partition room for balance.
+  bool Coarsen(Level* fine, const size_t coarsen_to, Level* coarse) {
+    size_t n = fine->get_num_vertexes();
+    size_t total_weight = 0;
+    for (auto w : fine->vwgt) total_weight += w;
+    size_t max_vwgt = std::max((size_t)1, (size_t)(1.5 * total_weight /
+                                                   coarsen_to));
+
+    std::vector<VID_T> order(n);
+    for (size_t v = 0; v < n; v++) order[v] = v;
+    std::mt19937 rng(n);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<VID_T> match(n, (VID_T)-1);
+    for (auto v : order) {
+      if (match[v] != (VID_T)-1) continue;
+      VID_T best = v;
+      size_t best_wgt = 0;
+      for (size_t j = fine->xadj[v]; j < fine->xadj[v + 1]; j++) {
+        VID_T u = fine->adj[j];
+        if (match[u] != (VID_T)-1 || u == v) continue;
+        if (fine->vwgt[v] + fine->vwgt[u] > max_vwgt) continue;
+        if (fine->adjwgt[j] > best_wgt) {
+          best = u;
+          best_wgt = fine->adjwgt[j];
+        }
+      }
+      match[v] = best;
+      match[best] = v;
+    }
+
+    fine->cmap.assign(n, 0);
+    size_t nc = 0;
+    for (size_t v = 0; v < n; v++) {
+      if (match[v] < v) continue;
+      fine->cmap[v] = nc;
+      fine->cmap[match[v]] = nc;
+      nc++;
+    }
+    if (nc == n) return false;
+
+    coarse->xadj.assign(nc + 1, 0);
+    coarse->vwgt.assign(nc, 0);
+    coarse->adj.reserve(fine->adj.size());
+    coarse->adjwgt.reserve(fine->adj.size());
+    std::vector<size_t> slot(nc, SIZE_MAX);
+    VID_T c = 0;
+    for (size_t v = 0; v < n; v++) {
+      if (match[v] < v) continue;
+      size_t begin = coarse->adj.size();
+      VID_T pair[2] = {(VID_T)v, match[v]};
+      for (size_t k = 0; k < (match[v] == v ? 1 : 2); k++) {
+        VID_T x = pair[k];
+        coarse->vwgt[c] += fine->vwgt[x];
+        for (size_t j = fine->xadj[x]; j < fine->xadj[x + 1]; j++) {
+          VID_T u = fine->cmap[fine->adj[j]];
+          if (u == c) continue;
+          if (slot[u] != SIZE_MAX) {
+            coarse->adjwgt[slot[u]] += fine->adjwgt[j];
+            continue;
+          }
+          slot[u] = coarse->adj.size();
+          coarse->adj.push_back(u);
+          coarse->adjwgt.push_back(fine->adjwgt[j]);
+        }
+      }
+      for (size_t j = begin; j < coarse->adj.size(); j++)
+        slot[coarse->adj[j]] = SIZE_MAX;
+      coarse->xadj[++c] = coarse->adj.size();
+    }
+    return true;
+  }
+
+  // Grow fragments 0 .. k - 2 from the heaviest vertex left, by connectivity;
+  // the last fragment takes the remainder.
+  void InitialPartition(const Level& level, const size_t num_partitions,
+                        std::vector<GID_T>* part) {
+    size_t n = level.get_num_vertexes();
+    size_t total_weight = 0;
+    for (auto w : level.vwgt) total_weight += w;
+    part->assign(n, num_partitions - 1);
+    std::vector<char> assigned(n, 0);
+    std::vector<size_t> conn(n, 0);
+    std::vector<VID_T> by_weight(n);
+    for (size_t v = 0; v < n; v++) by_weight[v] = v;
+    std::stable_sort(by_weight.begin(), by_weight.end(),
+                     [&level](VID_T a, VID_T b) {
+                       return level.vwgt[a] > level.vwgt[b];
+                     });
+    size_t cursor = 0;
+    size_t assigned_weight = 0;
+    for (GID_T gid = 0; gid + 1 < num_partitions; gid++) {
+      size_t target =
+          (total_weight - assigned_weight) / (num_partitions - gid);
+      size_t weight = 0;
+      std::priority_queue<std::pair<size_t, VID_T>> heap;
+      std::vector<VID_T> touched;
+      while (weight < target) {
+        VID_T v = 0;
+        bool found = false;
+        while (!heap.empty()) {
+          auto top = heap.top();
+          heap.pop();
+          if (assigned[top.second] || conn[top.second] != top.first) continue;
+          v = top.second;
+          found = true;
+          break;
+        }
+        if (!found) {
+          while (cursor < n && assigned[by_weight[cursor]]) cursor++;
+          if (cursor == n) break;
+          v = by_weight[cursor];
+        }
+        if (weight > 0 && weight + level.vwgt[v] > target + target / 2)
+          break;
+        assigned[v] = 1;
+        (*part)[v] = gid;
+        weight += level.vwgt[v];
+        for (size_t j = level.xadj[v]; j < level.xadj[v + 1]; j++) {
+          VID_T u = level.adj[j];
+          if (assigned[u]) continue;
+          if (conn[u] == 0) touched.push_back(u);
+          conn[u] += level.adjwgt[j];
+          heap.push(std::make_pair(conn[u], u));
+        }
+      }
+      for (auto u : touched) conn[u] = 0;
+      assigned_weight += weight;
+    }
+  }
+
+  // Greedy k-way refinement. A vertex moves to the fragment it has the most
+  // edge weight to if that lowers the cut, or keeps it and evens the
+  // weights, or if its own fragment is overweight.
+  void Refine(const Level& level, const size_t num_partitions,
+              std::vector<GID_T>* part) {
+    size_t n = level.get_num_vertexes();
+    if (n == 0) return;
+    size_t total_weight = 0;
+    for (auto w : level.vwgt) total_weight += w;
+    size_t max_pwgt = std::max(
+        (size_t)ceil((1 + imbalance_) * total_weight / num_partitions),
+        *std::max_element(level.vwgt.begin(), level.vwgt.end()));
+    std::vector<size_t> pwgt(num_partitions, 0);
+    for (size_t v = 0; v < n; v++) pwgt[(*part)[v]] += level.vwgt[v];
+
+    std::vector<size_t> conn(num_partitions, 0);
+    std::vector<GID_T> touched;
+    for (size_t pass = 0; pass < refine_passes_; pass++) {
+      size_t num_moves = 0;
+      for (size_t v = 0; v < n; v++) {
+        GID_T from = (*part)[v];
+        size_t vwgt = level.vwgt[v];
+        for (size_t j = level.xadj[v]; j < level.xadj[v + 1]; j++) {
+          GID_T gid = (*part)[level.adj[j]];
+          if (conn[gid] == 0) touched.push_back(gid);
+          conn[gid] += level.adjwgt[j];
+        }
+        bool overweight = pwgt[from] > max_pwgt;
+        GID_T to = from;
+        for (auto gid : touched) {
+          if (gid == from || pwgt[gid] + vwgt > max_pwgt) continue;
+          if (to == from || conn[gid] > conn[to] ||
+              (conn[gid] == conn[to] && pwgt[gid] < pwgt[to]))
+            to = gid;
+        }
+        if (overweight && to == from) {
+          to = std::min_element(pwgt.begin(), pwgt.end()) - pwgt.begin();
+        } else if (to != from && !overweight) {
+          bool better_cut = conn[to] > conn[from];
+          bool better_balance =
+              conn[to] == conn[from] && pwgt[to] + vwgt < pwgt[from];
+          if (!better_cut && !better_balance) to = from;
+        }
+        for (auto gid : touched) conn[gid] = 0;
+        touched.clear();
+        if (to == from) continue;
+        (*part)[v] = to;
+        pwgt[from] -= vwgt;
+        pwgt[to] += vwgt;
+        num_moves++;
+      }
+      if (num_moves == 0) break;
+    }
+  }
+};
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_MULTILEVEL_PARTITIONER_H
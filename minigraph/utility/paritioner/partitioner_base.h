@@ -1,7 +1,10 @@
 #ifndef MINIGRAPH_PARTITIONER_BASE_H
 #define MINIGRAPH_PARTITIONER_BASE_H
 
+#include "graphs/csr_builder.h"
 #include "graphs/graph.h"
+#include "utility/bitmap.h"
+#include "utility/io/data_mngr.h"
 
 namespace minigraph {
 namespace utility {
@@ -17,6 +20,7 @@ class PartitionerBase {
   using CSR_T = graphs::ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>;
   using EDGE_LIST_T =
       minigraph::graphs::EdgeList<gid_t, vid_t, vdata_t, edata_t>;
+  using CSR_BUILDER_T = graphs::CSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T>;
 
  public:
   PartitionerBase() {
@@ -30,7 +34,8 @@ class PartitionerBase {
                                  const size_t cores = 1, const std::string = "",
                                  bool delete_graph = false) = 0;
 
-  StatisticInfo ParallelSetStatisticInfo(CSR_T& csr_graph, const size_t cores) {
+  static StatisticInfo ParallelSetStatisticInfo(CSR_T& csr_graph,
+                                                const size_t cores) {
     auto thread_pool = minigraph::utility::EDFThreadPool(cores);
     std::mutex mtx;
     std::condition_variable finish_cv;
@@ -92,6 +97,182 @@ class PartitionerBase {
     return si;
   }
 
+  // Cut one edge-cut fragment per bucket of is_in_bucketX out of csr_builder
+  // and set vid_map_ and global_border_vid_map_. Fragments are written to
+  // dst_pt if delete_graph, kept in fragments_ otherwise.
+  void BuildEdgeCutFragments(CSR_BUILDER_T& csr_builder, Bitmap** is_in_bucketX,
+                             const size_t num_partitions, const size_t cores,
+                             const std::string& dst_pt, bool delete_graph) {
+    minigraph::utility::io::DataMngr<CSR_T> data_mngr;
+    this->num_partitions = num_partitions;
+    size_t aligned_max_vid = csr_builder.get_aligned_max_vid();
+    if (global_border_vid_map_ == nullptr)
+      global_border_vid_map_ = new Bitmap(aligned_max_vid);
+    global_border_vid_map_->clear();
+    if (vid_map_ != nullptr) free(vid_map_);
+    vid_map_ = (VID_T*)malloc(sizeof(VID_T) * aligned_max_vid);
+    memset(vid_map_, 0, sizeof(VID_T) * aligned_max_vid);
+
+    LOG_INFO("Run: Construct sub-graphs");
+    for (GID_T gid = 0; gid < num_partitions; gid++) {
+      auto graph = csr_builder.Build(gid, is_in_bucketX[gid], vid_map_);
+      graph->InitVdata2AllX(0);
+      graph->SetGlobalBorderVidMap(global_border_vid_map_, is_in_bucketX,
+                                   num_partitions);
+      graph->Sort(cores);
+      if (!delete_graph) {
+        fragments_->push_back((GRAPH_BASE_T*)graph);
+        continue;
+      }
+      std::string meta_pt =
+          dst_pt + "minigraph_meta/" + std::to_string(gid) + ".bin";
+      std::string data_pt =
+          dst_pt + "minigraph_data/" + std::to_string(gid) + ".bin";
+      std::string vdata_pt =
+          dst_pt + "minigraph_vdata/" + std::to_string(gid) + ".bin";
+      data_mngr.csr_io_adapter_->Write(*graph, csr_bin, false, meta_pt,
+                                       data_pt, vdata_pt);
+      StatisticInfo&& si = ParallelSetStatisticInfo(*graph, cores);
+      std::string si_pt =
+          dst_pt + "minigraph_si/" + std::to_string(gid) + ".yaml";
+      data_mngr.WriteStatisticInfo(si, si_pt);
+      delete graph;
+    }
+  }
+
+  // As above, with the fragment of each vertex given by gid_by_vid, and set
+  // the communication matrix from the edges cut. Used by partitioners that
+  // only decide where vertexes go.
+  void BuildEdgeCutFragments(CSR_BUILDER_T& csr_builder,
+                             const std::vector<GID_T>& gid_by_vid,
+                             const size_t num_partitions, const size_t cores,
+                             const std::string& dst_pt, bool delete_graph) {
+    LOG_INFO("Run: Fill buckets.");
+    auto thread_pool = CPUThreadPool(cores, 1);
+    std::mutex mtx;
+    std::condition_variable finish_cv;
+    std::unique_lock<std::mutex> lck(mtx);
+    std::atomic<size_t> pending_packages(cores);
+    Bitmap* vertex_indicator = csr_builder.GetVertexIndicator();
+    VID_T max_vid = csr_builder.get_max_vid();
+    Bitmap* is_in_bucketX[num_partitions];
+    for (size_t i = 0; i < num_partitions; i++) {
+      is_in_bucketX[i] = new Bitmap(csr_builder.get_aligned_max_vid());
+      is_in_bucketX[i]->clear();
+    }
+    for (size_t tid = 0; tid < cores; tid++) {
+      thread_pool.Commit([tid, &cores, &max_vid, &is_in_bucketX, &gid_by_vid,
+                          &vertex_indicator, &pending_packages, &finish_cv]() {
+        for (size_t vid = tid; vid <= max_vid; vid += cores) {
+          if (!vertex_indicator->get_bit(vid)) continue;
+          is_in_bucketX[gid_by_vid[vid]]->set_bit(vid);
+        }
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
+    }
+    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+
+    BuildEdgeCutFragments(csr_builder, is_in_bucketX, num_partitions, cores,
+                          dst_pt, delete_graph);
+    for (size_t i = 0; i < num_partitions; i++) delete is_in_bucketX[i];
+
+    LOG_INFO("Run: Set communication matrix");
+    SetCommunicationMatrix(
+        CountCutEdges(csr_builder, gid_by_vid, num_partitions, cores),
+        num_partitions);
+  }
+
+  // Number of edges of csr_builder from fragment x to fragment y, in
+  // [x * num_partitions + y], given the fragment of each vertex. Vertexes
+  // out of any fragment are left out.
+  static std::vector<size_t> CountCutEdges(CSR_BUILDER_T& csr_builder,
+                                           const std::vector<GID_T>& gid_by_vid,
+                                           const size_t num_partitions,
+                                           const size_t cores) {
+    auto thread_pool = CPUThreadPool(cores, 1);
+    std::mutex mtx;
+    std::condition_variable finish_cv;
+    std::unique_lock<std::mutex> lck(mtx);
+    std::atomic<size_t> pending_packages(cores);
+    Bitmap* vertex_indicator = csr_builder.GetVertexIndicator();
+    VID_T max_vid = csr_builder.get_max_vid();
+    std::vector<size_t> num_cut_edges(num_partitions * num_partitions, 0);
+    std::mutex count_mtx;
+    for (size_t tid = 0; tid < cores; tid++) {
+      thread_pool.Commit([tid, &cores, &max_vid, &gid_by_vid, &num_partitions,
+                          &vertex_indicator, &csr_builder, &num_cut_edges,
+                          &count_mtx, &pending_packages, &finish_cv]() {
+        std::vector<size_t> local(num_partitions * num_partitions, 0);
+        for (size_t vid = tid; vid <= max_vid; vid += cores) {
+          if (!vertex_indicator->get_bit(vid)) continue;
+          GID_T x = gid_by_vid[vid];
+          if (x >= num_partitions) continue;
+          auto out_edges = csr_builder.get_out_edges(vid);
+          for (size_t i = 0; i < csr_builder.get_outdegree(vid); i++) {
+            GID_T y = gid_by_vid[out_edges[i]];
+            if (x != y && y < num_partitions) local[x * num_partitions + y]++;
+          }
+        }
+        {
+          std::lock_guard<std::mutex> count_lck(count_mtx);
+          for (size_t i = 0; i < local.size(); i++)
+            num_cut_edges[i] += local[i];
+        }
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
+    }
+    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+    return num_cut_edges;
+  }
+
+  // Number of vertexes shared by each pair of fragments of a vertex-cut,
+  // whose vertexes are given by is_in_bucketX.
+  static std::vector<size_t> CountSharedVertexes(Bitmap** is_in_bucketX,
+                                                 const size_t num_partitions) {
+    std::vector<size_t> num_shared(num_partitions * num_partitions, 0);
+    for (size_t x = 0; x < num_partitions; x++) {
+      for (size_t y = x + 1; y < num_partitions; y++) {
+        size_t num_words = WORD_OFFSET(std::min(is_in_bucketX[x]->size_,
+                                                is_in_bucketX[y]->size_)) +
+                           1;
+        size_t count = 0;
+        for (size_t w = 0; w < num_words; w++)
+          count += __builtin_popcountl(is_in_bucketX[x]->data_[w] &
+                                       is_in_bucketX[y]->data_[w]);
+        num_shared[x * num_partitions + y] = count;
+        num_shared[y * num_partitions + x] = count;
+      }
+    }
+    return num_shared;
+  }
+
+  // Set communication_matrix_ so that x depends on y, i.e. consumes messages
+  // of y, iff num_links[x * num_partitions + y] or its transpose is not 0.
+  // Applications pass messages along either direction of an edge, so the
+  // dependency is kept both ways. Fragments with no links are neither read
+  // again by LC nor waited for once they stop changing.
+  void SetCommunicationMatrix(const std::vector<size_t>& num_links,
+                              const size_t num_partitions) {
+    if (communication_matrix_ != nullptr) free(communication_matrix_);
+    communication_matrix_ =
+        (bool*)malloc(sizeof(bool) * num_partitions * num_partitions);
+    size_t num_cut_edges = 0, num_dependencies = 0;
+    for (size_t x = 0; x < num_partitions; x++) {
+      for (size_t y = 0; y < num_partitions; y++) {
+        bool depends = x != y && (num_links[x * num_partitions + y] > 0 ||
+                                  num_links[y * num_partitions + x] > 0);
+        communication_matrix_[x * num_partitions + y] = depends;
+        num_cut_edges += x != y ? num_links[x * num_partitions + y] : 0;
+        num_dependencies += depends;
+      }
+    }
+    LOG_INFO("Cut links: ", num_cut_edges,
+             " dependencies: ", num_dependencies, " / ",
+             num_partitions * (num_partitions - 1));
+  }
+
   std::vector<graphs::Graph<GID_T, VID_T, VDATA_T, EDATA_T>*>* GetFragments() {
     return fragments_;
   }
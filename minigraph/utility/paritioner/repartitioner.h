@@ -0,0 +1,388 @@
+#ifndef MINIGRAPH_UTILITY_REPARTITIONER_H
+#define MINIGRAPH_UTILITY_REPARTITIONER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graphs/csr_builder.h"
+#include "graphs/immutable_csr.h"
+#include "portability/sys_data_structure.h"
+#include "portability/sys_types.h"
+#include "rapidcsv.h"
+#include "utility/bitmap.h"
+#include "utility/io/data_mngr.h"
+#include "utility/logging.h"
+#include "utility/paritioner/partitioner_base.h"
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+// Repartitioner reshapes an edge-cut workspace after a run, from the
+// SuperstepInfo the run wrote to minigraph_si/supersteps.csv:
+//  - hot fragments, whose total PEval + IncEval time exceeds hot_ratio times
+//    the mean, are split in two halves of about the same number of edges.
+//  - cold fragments, that changed in at most cold_supersteps supersteps, are
+//    merged two by two, smallest first.
+// Only the fragments involved are read and rewritten. A merge keeps the
+// smaller gid and a split gives its second half a freed gid or a new one;
+// gids left unused are then filled by renaming the last fragments.
+// vid_map.bin, global_border_vid_map.bin and the communication matrix are
+// updated in place. Border bits only change for vertexes of rewritten
+// fragments, as any other vertex keeps all its neighbors' fragments apart
+// from its own. Dependencies follow the fragments: a merge takes those of
+// both, and both halves of a split take those of the whole and depend on each
+// other, which may add dependencies that no edge backs but never drops one.
+template <typename GRAPH_T>
+class Repartitioner {
+  using GID_T = typename GRAPH_T::gid_t;
+  using VID_T = typename GRAPH_T::vid_t;
+  using VDATA_T = typename GRAPH_T::vdata_t;
+  using EDATA_T = typename GRAPH_T::edata_t;
+  using CSR_T = graphs::ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>;
+  using CSR_BUILDER_T = graphs::CSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T>;
+
+ public:
+  Repartitioner(const std::string& work_space, const size_t cores = 1) {
+    work_space_ = work_space;
+    cores_ = cores == 0 ? 1 : cores;
+  }
+  ~Repartitioner() = default;
+
+  bool Repartition(const std::string& superstep_info_pt,
+                   const double hot_ratio = 2.0,
+                   const size_t cold_supersteps = 1) {
+    std::string communication_matrix_pt =
+        work_space_ + "minigraph_border_vertexes/communication_matrix.bin";
+    if (!data_mngr_.Exist(communication_matrix_pt) ||
+        !data_mngr_.Exist(superstep_info_pt)) {
+      XLOG(ERR, "Read file fault: ", communication_matrix_pt, " or ",
+           superstep_info_pt);
+      return false;
+    }
+    auto communication_matrix =
+        data_mngr_.ReadCommunicationMatrix(communication_matrix_pt);
+    num_graphs_ = communication_matrix.first;
+    depends_.assign(num_graphs_, std::vector<bool>(num_graphs_, false));
+    for (size_t x = 0; x < num_graphs_; x++)
+      for (size_t y = 0; y < num_graphs_; y++)
+        depends_[x][y] = communication_matrix.second[x * num_graphs_ + y];
+    free(communication_matrix.second);
+
+    // Compute time and number of changing supersteps of each fragment.
+    std::vector<double> elapsed_time(num_graphs_, 0);
+    std::vector<size_t> num_active_supersteps(num_graphs_, 0);
+    {
+      rapidcsv::Document doc(superstep_info_pt, rapidcsv::LabelParams(),
+                             rapidcsv::SeparatorParams(','));
+      std::vector<size_t> gids = doc.GetColumn<size_t>("gid");
+      std::vector<size_t> changed = doc.GetColumn<size_t>("changed");
+      std::vector<double> times = doc.GetColumn<double>("elapsed_time");
+      for (size_t i = 0; i < gids.size(); i++) {
+        if (gids[i] >= num_graphs_) continue;
+        elapsed_time[gids[i]] += times[i];
+        num_active_supersteps[gids[i]] += changed[i];
+      }
+    }
+    double mean_time = 0;
+    for (auto t : elapsed_time) mean_time += t / num_graphs_;
+
+    std::vector<GID_T> splits;
+    std::vector<std::pair<size_t, GID_T>> cold;
+    for (GID_T gid = 0; gid < num_graphs_; gid++) {
+      StatisticInfo si = data_mngr_.ReadStatisticInfo(SiPt(gid));
+      if (elapsed_time[gid] > hot_ratio * mean_time) {
+        if (si.num_vertexes > 1) splits.push_back(gid);
+      } else if (num_active_supersteps[gid] <= cold_supersteps) {
+        cold.push_back(std::make_pair(si.num_vertexes, gid));
+      }
+    }
+    std::sort(cold.begin(), cold.end());
+    std::vector<std::pair<GID_T, GID_T>> merges;
+    for (size_t i = 0; i + 1 < cold.size(); i += 2)
+      merges.push_back(std::make_pair(std::min(cold[i].second,
+                                               cold[i + 1].second),
+                                      std::max(cold[i].second,
+                                               cold[i + 1].second)));
+    LOG_INFO("Repartition(): num_graphs: ", num_graphs_,
+             " splits: ", splits.size(), " merges: ", merges.size());
+    if (splits.empty() && merges.empty()) return true;
+
+    std::string vid_map_pt = work_space_ + "minigraph_message/vid_map.bin";
+    std::string border_pt =
+        work_space_ + "minigraph_message/global_border_vid_map.bin";
+    auto vid_map = data_mngr_.ReadVidMap(vid_map_pt);
+    num_vid_map_ = vid_map.first;
+    vid_map_ = vid_map.second;
+    global_border_vid_map_ = data_mngr_.ReadBitmap(border_pt).second;
+
+    std::vector<GID_T> free_gids;
+    for (auto& merge : merges) {
+      Rebuild({merge.first, merge.second}, {merge.first});
+      RemoveFragment(merge.second);
+      MergeDependencies(merge.first, merge.second);
+      free_gids.push_back(merge.second);
+    }
+    size_t num_graphs = num_graphs_;
+    for (auto gid : splits) {
+      GID_T new_gid = num_graphs;
+      if (free_gids.empty()) {
+        num_graphs++;
+      } else {
+        new_gid = free_gids.back();
+        free_gids.pop_back();
+      }
+      Rebuild({gid}, {gid, new_gid});
+      SplitDependencies(gid, new_gid);
+    }
+
+    // Fill the gids left by merges with the last fragments.
+    std::sort(free_gids.begin(), free_gids.end());
+    while (!free_gids.empty()) {
+      GID_T last = num_graphs - 1;
+      num_graphs--;
+      auto iter = std::find(free_gids.begin(), free_gids.end(), last);
+      if (iter != free_gids.end()) {
+        free_gids.erase(iter);
+        continue;
+      }
+      RenameFragment(last, free_gids.front());
+      MoveDependencies(last, free_gids.front());
+      free_gids.erase(free_gids.begin());
+    }
+    num_graphs_ = num_graphs;
+
+    LOG_INFO("Run: Write vid_map, global_border_vid_map, communication matrix");
+    data_mngr_.WriteVidMap(num_vid_map_, vid_map_, vid_map_pt);
+    remove(border_pt.c_str());
+    data_mngr_.WriteBitmap(global_border_vid_map_, border_pt);
+    bool* matrix = (bool*)malloc(sizeof(bool) * num_graphs_ * num_graphs_);
+    for (size_t x = 0; x < num_graphs_; x++)
+      for (size_t y = 0; y < num_graphs_; y++)
+        matrix[x * num_graphs_ + y] = x != y && depends_[x][y];
+    data_mngr_.WriteCommunicationMatrix(communication_matrix_pt, matrix,
+                                        num_graphs_);
+    free(matrix);
+    free(vid_map_);
+    vid_map_ = nullptr;
+    delete global_border_vid_map_;
+    global_border_vid_map_ = nullptr;
+    LOG_INFO("Repartition(): num_graphs: ", num_graphs_);
+    return true;
+  }
+
+  size_t get_num_graphs() const { return num_graphs_; }
+
+ private:
+  std::string work_space_;
+  size_t cores_ = 1;
+  size_t num_graphs_ = 0;
+  size_t num_vid_map_ = 0;
+  VID_T* vid_map_ = nullptr;
+  Bitmap* global_border_vid_map_ = nullptr;
+  // depends_[x][y] if x consumes messages of y.
+  std::vector<std::vector<bool>> depends_;
+  io::DataMngr<CSR_T> data_mngr_;
+
+  std::string MetaPt(const GID_T gid) const {
+    return work_space_ + "minigraph_meta/" + std::to_string(gid) + ".bin";
+  }
+  std::string DataPt(const GID_T gid) const {
+    return work_space_ + "minigraph_data/" + std::to_string(gid) + ".bin";
+  }
+  std::string VdataPt(const GID_T gid) const {
+    return work_space_ + "minigraph_vdata/" + std::to_string(gid) + ".bin";
+  }
+  std::string SiPt(const GID_T gid) const {
+    return work_space_ + "minigraph_si/" + std::to_string(gid) + ".yaml";
+  }
+
+  // Read the fragments in src_gids and write their vertexes back as
+  // fragments dst_gids, split in parts of about the same number of edges.
+  void Rebuild(const std::vector<GID_T>& src_gids,
+               const std::vector<GID_T>& dst_gids) {
+    std::vector<CSR_T*> graphs;
+    for (auto gid : src_gids) {
+      auto graph = new CSR_T;
+      data_mngr_.csr_io_adapter_->Read(graph, csr_bin, gid, MetaPt(gid),
+                                       DataPt(gid), VdataPt(gid));
+      graphs.push_back(graph);
+    }
+    auto is_member = [&graphs](const VID_T vid) {
+      for (auto graph : graphs)
+        if (graph->IsInGraph(vid)) return true;
+      return false;
+    };
+
+    // Out-edges of members, and in-edges from other fragments only, so that
+    // edges between members are taken once.
+    std::vector<VID_T> edges;
+    std::vector<VID_T> members;
+    std::vector<size_t> degrees;
+    VID_T max_vid = 0;
+    for (auto graph : graphs) {
+      for (size_t i = 0; i < graph->get_num_vertexes(); i++) {
+        VID_T vid = graph->globalid_by_index_[i];
+        members.push_back(vid);
+        degrees.push_back(graph->indegree_[i] + graph->outdegree_[i]);
+        max_vid = std::max(max_vid, vid);
+        auto out_edges = graph->out_edges_ + graph->out_offset_[i];
+        for (size_t j = 0; j < graph->outdegree_[i]; j++) {
+          edges.push_back(vid);
+          edges.push_back(out_edges[j]);
+          max_vid = std::max(max_vid, out_edges[j]);
+        }
+        auto in_edges = graph->in_edges_ + graph->in_offset_[i];
+        for (size_t j = 0; j < graph->indegree_[i]; j++) {
+          if (is_member(in_edges[j])) continue;
+          edges.push_back(in_edges[j]);
+          edges.push_back(vid);
+          max_vid = std::max(max_vid, in_edges[j]);
+        }
+      }
+    }
+    for (auto graph : graphs) delete graph;
+    if (max_vid >= num_vid_map_) {
+      vid_map_ = (VID_T*)realloc(vid_map_, sizeof(VID_T) * (max_vid + 1));
+      memset(vid_map_ + num_vid_map_, 0,
+             sizeof(VID_T) * (max_vid + 1 - num_vid_map_));
+      num_vid_map_ = max_vid + 1;
+    }
+    if (max_vid >= global_border_vid_map_->size_)
+      GrowGlobalBorderVidMap((size_t)max_vid + 1);
+
+    CSR_BUILDER_T csr_builder(edges.data(), edges.size() / 2, max_vid,
+                              cores_);
+    edges.clear();
+    edges.shrink_to_fit();
+    size_t sum_degrees = 0;
+    for (auto degree : degrees) sum_degrees += degree;
+    size_t begin = 0, prefix = 0;
+    for (size_t part = 0; part < dst_gids.size(); part++) {
+      // Sized as the builder's own bitmaps, which Build() scans, and holding
+      // max_vid + 1 bits.
+      Bitmap bitmap(csr_builder.get_aligned_max_vid());
+      bitmap.clear();
+      size_t end = begin;
+      size_t target = sum_degrees * (part + 1) / dst_gids.size();
+      while (end < members.size() &&
+             (part + 1 == dst_gids.size() || prefix < target ||
+              end == begin)) {
+        bitmap.set_bit(members[end]);
+        prefix += degrees[end++];
+      }
+      WriteFragment(csr_builder, dst_gids[part], &bitmap);
+      begin = end;
+    }
+  }
+
+  void WriteFragment(CSR_BUILDER_T& csr_builder, const GID_T gid,
+                     Bitmap* bitmap) {
+    auto graph = csr_builder.Build(gid, bitmap, vid_map_);
+    graph->InitVdata2AllX(0);
+    graph->Sort(cores_);
+    LOG_INFO("  GID: ", gid, " num_vertexes: ", graph->get_num_vertexes(),
+             " num_edges: ", graph->get_num_edges());
+
+    // A member is a border vertex iff one of its neighbors is not a member.
+    for (size_t i = 0; i < graph->get_num_vertexes(); i++) {
+      VID_T vid = graph->globalid_by_index_[i];
+      bool is_border = false;
+      auto out_edges = graph->out_edges_ + graph->out_offset_[i];
+      for (size_t j = 0; j < graph->outdegree_[i] && !is_border; j++)
+        is_border = !graph->IsInGraph(out_edges[j]);
+      auto in_edges = graph->in_edges_ + graph->in_offset_[i];
+      for (size_t j = 0; j < graph->indegree_[i] && !is_border; j++)
+        is_border = !graph->IsInGraph(in_edges[j]);
+      if (is_border)
+        global_border_vid_map_->set_bit(vid);
+      else
+        global_border_vid_map_->rm_bit(vid);
+    }
+
+    data_mngr_.csr_io_adapter_->Write(*graph, csr_bin, false, MetaPt(gid),
+                                      DataPt(gid), VdataPt(gid));
+    StatisticInfo&& si =
+        PartitionerBase<GRAPH_T>::ParallelSetStatisticInfo(*graph, cores_);
+    data_mngr_.WriteStatisticInfo(si, SiPt(gid));
+    delete graph;
+  }
+
+  // Make room for size bits in global_border_vid_map_, which may be short of
+  // the largest vid in workspaces written before it held max_vid + 1 bits.
+  void GrowGlobalBorderVidMap(const size_t size) {
+    auto bitmap = new Bitmap(size);
+    bitmap->clear();
+    memcpy(bitmap->data_, global_border_vid_map_->data_,
+           sizeof(unsigned long) *
+               (WORD_OFFSET(global_border_vid_map_->size_) + 1));
+    delete global_border_vid_map_;
+    global_border_vid_map_ = bitmap;
+  }
+
+  void ReserveDependencies(const GID_T gid) {
+    size_t size = std::max(depends_.size(), (size_t)gid + 1);
+    depends_.resize(size);
+    for (auto& row : depends_) row.resize(size, false);
+  }
+
+  // gid takes the dependencies of other, which is left with none.
+  void MergeDependencies(const GID_T gid, const GID_T other) {
+    for (size_t z = 0; z < depends_.size(); z++) {
+      depends_[gid][z] = depends_[gid][z] || depends_[other][z];
+      depends_[z][gid] = depends_[z][gid] || depends_[z][other];
+      depends_[other][z] = false;
+      depends_[z][other] = false;
+    }
+    depends_[gid][gid] = false;
+  }
+
+  void SplitDependencies(const GID_T gid, const GID_T half) {
+    ReserveDependencies(half);
+    for (size_t z = 0; z < depends_.size(); z++) {
+      depends_[half][z] = depends_[gid][z];
+      depends_[z][half] = depends_[z][gid];
+    }
+    depends_[half][half] = false;
+    depends_[gid][half] = true;
+    depends_[half][gid] = true;
+  }
+
+  void MoveDependencies(const GID_T src_gid, const GID_T dst_gid) {
+    for (size_t z = 0; z < depends_.size(); z++) {
+      depends_[dst_gid][z] = depends_[src_gid][z];
+      depends_[src_gid][z] = false;
+    }
+    for (size_t z = 0; z < depends_.size(); z++) {
+      depends_[z][dst_gid] = depends_[z][src_gid];
+      depends_[z][src_gid] = false;
+    }
+    depends_[dst_gid][dst_gid] = false;
+  }
+
+  void RemoveFragment(const GID_T gid) {
+    remove(MetaPt(gid).c_str());
+    remove(DataPt(gid).c_str());
+    remove(VdataPt(gid).c_str());
+    remove(SiPt(gid).c_str());
+  }
+
+  void RenameFragment(const GID_T src_gid, const GID_T dst_gid) {
+    LOG_INFO("  Rename GID: ", src_gid, " -> ", dst_gid);
+    rename(MetaPt(src_gid).c_str(), MetaPt(dst_gid).c_str());
+    rename(DataPt(src_gid).c_str(), DataPt(dst_gid).c_str());
+    rename(VdataPt(src_gid).c_str(), VdataPt(dst_gid).c_str());
+    rename(SiPt(src_gid).c_str(), SiPt(dst_gid).c_str());
+  }
+};
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_REPARTITIONER_H
@@ -0,0 +1,284 @@
+#ifndef MINIGRAPH_UTILITY_STREAMING_PARTITIONER_H
+#define MINIGRAPH_UTILITY_STREAMING_PARTITIONER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graphs/csr_builder.h"
+#include "portability/sys_types.h"
+#include "utility/bitmap.h"
+#include "utility/io/csv_edge_parser.h"
+#include "utility/io/external_csr_builder.h"
+#include "utility/logging.h"
+#include "utility/paritioner/partitioner_base.h"
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace utility {
+namespace partitioner {
+
+// StreamingPartitioner places vertexes in a single pass over the edges,
+// which are read in chunks, and then cuts edge-cut fragments out of the
+// result. The vertexes of a chunk are placed in vid order, each with its in-
+// and out-neighbors in the chunk, and go to the fragment that scores best
+// given the neighbors placed so far, including those of earlier chunks:
+//  - ldg, Linear Deterministic Greedy:
+//      |N(v) in P_i| * (1 - |P_i| / C)
+//  - fennel:
+//      |N(v) in P_i| - alpha * gamma * |P_i|^(gamma - 1), with gamma = 1.5
+//      and alpha = sqrt(k) * m / n^1.5
+// where C = nu * n / k is the capacity of a fragment, and n and m count the
+// vertexes and edges read so far; full fragments take no more vertexes. Ties
+// go to the least loaded fragment. A vertex keeps its fragment once placed,
+// so that apart from the chunk the pass only keeps the fragment of each
+// vertex and the load of each fragment.
+//
+// StreamPartition() reads the edge list from disk in chunks of a bounded
+// size and writes the fragments out of core with ExternalCSRBuilder.
+// ParallelPartition() takes an edge list already in memory as a single
+// chunk, i.e. each vertex sees all its neighbors.
+template <typename GRAPH_T>
+class StreamingPartitioner : public PartitionerBase<GRAPH_T> {
+  using GID_T = typename GRAPH_T::gid_t;
+  using VID_T = typename GRAPH_T::vid_t;
+  using VDATA_T = typename GRAPH_T::vdata_t;
+  using EDATA_T = typename GRAPH_T::edata_t;
+  using CSR_T = graphs::ImmutableCSR<GID_T, VID_T, VDATA_T, EDATA_T>;
+  using CSR_BUILDER_T = graphs::CSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T>;
+  using EDGE_LIST_T =
+      minigraph::graphs::EdgeList<gid_t, vid_t, vdata_t, edata_t>;
+
+ public:
+  StreamingPartitioner(const std::string& heuristic = "fennel",
+                       const double nu = 1.1) {
+    heuristic_ = heuristic;
+    nu_ = nu;
+  }
+  ~StreamingPartitioner() = default;
+
+  bool ParallelPartition(EDGE_LIST_T* edgelist_graph,
+                         const size_t num_partitions = 1,
+                         const size_t cores = 1, const std::string dst_pt = "",
+                         bool delete_graph = false) override {
+    LOG_INFO("ParallelPartition(): Streaming ", heuristic_);
+    if (!Reset(num_partitions)) return false;
+    this->max_vid_ = edgelist_graph->get_max_vid();
+    this->num_edges_ = edgelist_graph->get_num_edges();
+    this->num_vertexes_ = edgelist_graph->get_num_vertexes();
+
+    LOG_INFO("Run: Stream vertexes");
+    AssignChunk(edgelist_graph->buf_graph_, this->num_edges_);
+    ShowLoad();
+
+    LOG_INFO("Run: Count degrees, scan offsets and scatter edges");
+    CSR_BUILDER_T csr_builder(edgelist_graph->buf_graph_, this->num_edges_,
+                              this->max_vid_, cores, true);
+    delete edgelist_graph;
+    // As vid_map_ and the border bits, set from csr_builder.
+    this->aligned_max_vid_ = csr_builder.get_aligned_max_vid();
+    gid_by_vid_.resize((size_t)this->max_vid_ + 1, GID_MAX);
+
+    this->BuildEdgeCutFragments(csr_builder, gid_by_vid_, num_partitions,
+                                cores, dst_pt, delete_graph);
+    return true;
+  }
+
+  // Partition the edge list at src_pt, in edgelist_csv or edgelist_bin format
+  // as for ExternalCSRBuilder::Build(), into the workspace dst_pt. Edges are
+  // read once in chunks taking at most mem_budget bytes to place vertexes,
+  // and once more by ExternalCSRBuilder, with the same budget, to write the
+  // fragments.
+  bool StreamPartition(const std::string& src_pt,
+                       const GraphFormat& graph_format,
+                       const std::string& dst_pt,
+                       const size_t num_partitions = 1, const size_t cores = 1,
+                       const char separator_params = ',',
+                       const size_t mem_budget = (size_t)1 << 30) {
+    LOG_INFO("StreamPartition(): Streaming ", heuristic_);
+    if (!Reset(num_partitions)) return false;
+    // Each edge of a chunk takes 2 vids as read and 4 in the adjacency.
+    size_t chunk_size = mem_budget / (6 * sizeof(VID_T));
+    if (chunk_size == 0) chunk_size = 1;
+
+    LOG_INFO("Run: Stream vertexes. chunk_size: ", chunk_size);
+    bool tag = false;
+    if (graph_format == edgelist_csv)
+      tag = StreamCSV(src_pt, chunk_size, cores, separator_params);
+    else if (graph_format == edgelist_bin)
+      tag = StreamBin(src_pt + "minigraph_meta.bin",
+                      src_pt + "minigraph_data.bin", chunk_size);
+    if (!tag || num_seen_edges_ == 0) {
+      XLOG(ERR, "StreamPartition: no edges are read from ", src_pt);
+      return false;
+    }
+    ShowLoad();
+
+    io::ExternalCSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T>
+        external_csr_builder(mem_budget, cores);
+    return external_csr_builder.Build(src_pt, graph_format, dst_pt,
+                                      num_partitions, separator_params,
+                                      &gid_by_vid_);
+  }
+
+  // Fragment of each vertex, GID_MAX for vids not in the graph.
+  const std::vector<GID_T>& GetGidByVid() const { return gid_by_vid_; }
+
+ private:
+  std::string heuristic_ = "fennel";
+  double nu_ = 1.1;
+
+  // State of the pass.
+  std::vector<GID_T> gid_by_vid_;
+  std::vector<size_t> load_;
+  size_t num_seen_vertexes_ = 0;
+  size_t num_seen_edges_ = 0;
+
+  bool Reset(const size_t num_partitions) {
+    if (heuristic_ != "ldg" && heuristic_ != "fennel") {
+      XLOG(ERR, "Unknown streaming heuristic: ", heuristic_);
+      return false;
+    }
+    gid_by_vid_.clear();
+    load_.assign(num_partitions == 0 ? 1 : num_partitions, 0);
+    num_seen_vertexes_ = 0;
+    num_seen_edges_ = 0;
+    return true;
+  }
+
+  bool StreamCSV(const std::string& pt, const size_t chunk_size,
+                 const size_t cores, const char separator) {
+    io::CSVEdgeParser<VID_T> parser(pt, cores, separator);
+    if (!parser.Open()) return false;
+    VID_T* buf = (VID_T*)malloc(sizeof(VID_T) * 2 * chunk_size);
+    while (parser.NextWindow(chunk_size)) {
+      size_t n = 0;
+      if (!parser.Parse(buf, buf + 1, &n, 2, nullptr, true)) {
+        free(buf);
+        return false;
+      }
+      AssignChunk(buf, n);
+    }
+    free(buf);
+    return true;
+  }
+
+  bool StreamBin(const std::string& meta_pt, const std::string& data_pt,
+                 const size_t chunk_size) {
+    std::ifstream meta_file(meta_pt, std::ios::binary);
+    std::ifstream data_file(data_pt, std::ios::binary);
+    if (!meta_file || !data_file) {
+      XLOG(ERR, "Read file fault: ", data_pt);
+      return false;
+    }
+    size_t meta_buff[2] = {0};
+    meta_file.read((char*)meta_buff, sizeof(size_t) * 2);
+    VID_T* buf = (VID_T*)malloc(sizeof(VID_T) * 2 * chunk_size);
+    size_t remain = meta_buff[1];
+    while (remain > 0) {
+      size_t n = std::min(remain, chunk_size);
+      data_file.read((char*)buf, sizeof(VID_T) * 2 * n);
+      remain -= n;
+      // Drop self loops, as ExternalCSRBuilder does.
+      size_t count = 0;
+      for (size_t i = 0; i < n; i++) {
+        if (buf[i * 2] == buf[i * 2 + 1]) continue;
+        buf[count * 2] = buf[i * 2];
+        buf[count * 2 + 1] = buf[i * 2 + 1];
+        count++;
+      }
+      AssignChunk(buf, count);
+    }
+    free(buf);
+    return true;
+  }
+
+  // Place the vertexes of a chunk of num_edges <src, dst> pairs that have
+  // not been placed by an earlier chunk.
+  void AssignChunk(const VID_T* edges, const size_t num_edges) {
+    if (num_edges == 0) return;
+    std::vector<std::pair<VID_T, VID_T>> adj;
+    adj.reserve(num_edges * 2);
+    VID_T max_vid = 0;
+    for (size_t i = 0; i < num_edges; i++) {
+      VID_T src = edges[i * 2], dst = edges[i * 2 + 1];
+      if (src == dst) continue;
+      adj.emplace_back(src, dst);
+      adj.emplace_back(dst, src);
+      max_vid < src ? max_vid = src : 0;
+      max_vid < dst ? max_vid = dst : 0;
+    }
+    if (adj.empty()) return;
+    std::sort(adj.begin(), adj.end());
+    if (gid_by_vid_.size() <= max_vid)
+      gid_by_vid_.resize((size_t)max_vid + 1, GID_MAX);
+
+    // Vertexes seen for the first time count towards n before any of them is
+    // placed.
+    for (size_t i = 0; i < adj.size(); i++)
+      if ((i == 0 || adj[i].first != adj[i - 1].first) &&
+          gid_by_vid_[adj[i].first] == GID_MAX)
+        num_seen_vertexes_++;
+    num_seen_edges_ += adj.size() / 2;
+
+    size_t num_partitions = load_.size();
+    double n = num_seen_vertexes_;
+    double m = num_seen_edges_;
+    double capacity = ceil(nu_ * n / num_partitions);
+    double gamma = 1.5;
+    double alpha = sqrt((double)num_partitions) * m / pow(n, gamma);
+    bool is_ldg = heuristic_ == "ldg";
+    std::vector<size_t> num_nbrs(num_partitions, 0);
+    std::vector<GID_T> touched;
+
+    for (size_t begin = 0, end = 0; begin < adj.size(); begin = end) {
+      VID_T u = adj[begin].first;
+      end = begin;
+      while (end < adj.size() && adj[end].first == u) end++;
+      if (gid_by_vid_[u] != GID_MAX) continue;
+      for (size_t i = begin; i < end; i++) {
+        GID_T gid = gid_by_vid_[adj[i].second];
+        if (gid == GID_MAX) continue;
+        if (num_nbrs[gid]++ == 0) touched.push_back(gid);
+      }
+      GID_T best = GID_MAX;
+      double best_score = 0;
+      for (GID_T gid = 0; gid < num_partitions; gid++) {
+        if (load_[gid] >= capacity) continue;
+        double score = is_ldg ? num_nbrs[gid] * (1 - load_[gid] / capacity)
+                              : num_nbrs[gid] - alpha * gamma *
+                                                    pow(load_[gid], gamma - 1);
+        if (best == GID_MAX || score > best_score ||
+            (score == best_score && load_[gid] < load_[best])) {
+          best = gid;
+          best_score = score;
+        }
+      }
+      // Only if nu < 1.
+      if (best == GID_MAX)
+        best = std::min_element(load_.begin(), load_.end()) - load_.begin();
+      gid_by_vid_[u] = best;
+      load_[best]++;
+      for (auto gid : touched) num_nbrs[gid] = 0;
+      touched.clear();
+    }
+  }
+
+  void ShowLoad() const {
+    LOG_INFO("num_vertexes: ", num_seen_vertexes_,
+             " num_edges: ", num_seen_edges_);
+    for (size_t i = 0; i < load_.size(); i++)
+      LOG_INFO("  GID: ", i, " num_vertexes: ", load_[i]);
+  }
+};
+
+}  // namespace partitioner
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_STREAMING_PARTITIONER_H
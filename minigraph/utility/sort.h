@@ -2,9 +2,15 @@
 #define SORT_H
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
 #include <iostream>
 #include <math.h>
+#include <mutex>
 #include <stdio.h>
+#include <type_traits>
+#include <vector>
 
 using namespace std;
 
@@ -39,4 +45,151 @@ void QuickSort(T* r, int low, int hight) {
   }
 }
 
+// Lists no longer than this are insertion sorted.
+constexpr size_t kInsertionSortThreshold = 32;
+
+template <typename T>
+void InsertionSort(T* r, const size_t n) {
+  for (size_t i = 1; i < n; i++) {
+    T key = r[i];
+    size_t j = i;
+    while (j > 0 && r[j - 1] > key) {
+      r[j] = r[j - 1];
+      j--;
+    }
+    r[j] = key;
+  }
+}
+
+template <typename T>
+size_t SignificantBits(const T max_key) {
+  return max_key == 0 ? 0 : 64 - __builtin_clzll((unsigned long long)max_key);
+}
+
+// LSD radix sort of unsigned keys on 8-bit digits. Only the digits within the
+// lowest bits are visited and a pass is skipped if all keys share the digit.
+// tmp must hold n elements.
+template <typename T>
+void RadixSort(T* r, const size_t n, T* tmp, const size_t bits) {
+  static_assert(std::is_unsigned<T>::value, "RadixSort needs unsigned keys");
+  T* src = r;
+  T* dst = tmp;
+  size_t count[256];
+  for (size_t shift = 0; shift < bits; shift += 8) {
+    memset(count, 0, sizeof(count));
+    for (size_t i = 0; i < n; i++) count[(src[i] >> shift) & 0xff]++;
+    if (count[(src[0] >> shift) & 0xff] == n) continue;
+    size_t sum = 0;
+    for (size_t d = 0; d < 256; d++) {
+      size_t c = count[d];
+      count[d] = sum;
+      sum += c;
+    }
+    for (size_t i = 0; i < n; i++)
+      dst[count[(src[i] >> shift) & 0xff]++] = src[i];
+    swap(src, dst);
+  }
+  if (src != r) memcpy(r, src, sizeof(T) * n);
+}
+
+// Sort r[0, n): tiny lists by insertion sort, sorted lists are left as they
+// are and the others by radix sort. tmp must hold n elements.
+template <typename T>
+void AdaptiveSort(T* r, const size_t n, T* tmp) {
+  if (n < 2) return;
+  if (n <= kInsertionSortThreshold) {
+    InsertionSort(r, n);
+    return;
+  }
+  bool sorted = true;
+  T max_key = r[0];
+  for (size_t i = 1; i < n; i++) {
+    if (r[i] < r[i - 1]) sorted = false;
+    if (r[i] > max_key) max_key = r[i];
+  }
+  if (sorted) return;
+  RadixSort(r, n, tmp, SignificantBits(max_key));
+}
+
+// Run f(tid) for tid in [0, cores) on pool and wait for all of them.
+template <typename POOL, typename F>
+void ParallelFor(POOL& pool, const size_t cores, F&& f) {
+  std::mutex mtx;
+  std::condition_variable finish_cv;
+  std::unique_lock<std::mutex> lck(mtx);
+  std::atomic<size_t> pending_packages(cores);
+  for (size_t tid = 0; tid < cores; tid++) {
+    pool.Commit([tid, &f, &pending_packages, &finish_cv]() {
+      f(tid);
+      if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+      return;
+    });
+  }
+  finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+}
+
+// Sort one large list with cores threads of pool. Each thread histograms its
+// block on the top 8 significant bits and scatters it into tmp, then the 256
+// buckets are handed out to the threads, sorted on the remaining bits and
+// copied back. tmp must hold n elements.
+template <typename T, typename POOL>
+void ParallelRadixSort(T* r, const size_t n, T* tmp, const size_t cores,
+                       POOL& pool) {
+  if (cores <= 1 || n < cores * kInsertionSortThreshold) {
+    AdaptiveSort(r, n, tmp);
+    return;
+  }
+  size_t step = (n + cores - 1) / cores;
+  std::vector<T> block_max(cores, 0);
+  std::vector<char> block_sorted(cores, 1);
+  ParallelFor(pool, cores, [&](size_t tid) {
+    size_t begin = std::min(tid * step, n), end = std::min(begin + step, n);
+    for (size_t i = begin; i < end; i++) {
+      if (i > 0 && r[i] < r[i - 1]) block_sorted[tid] = 0;
+      if (r[i] > block_max[tid]) block_max[tid] = r[i];
+    }
+  });
+  if (std::find(block_sorted.begin(), block_sorted.end(), 0) ==
+      block_sorted.end())
+    return;
+
+  size_t bits =
+      SignificantBits(*std::max_element(block_max.begin(), block_max.end()));
+  size_t shift = bits > 8 ? bits - 8 : 0;
+  std::vector<size_t> count(cores * 256, 0);
+  ParallelFor(pool, cores, [&](size_t tid) {
+    size_t begin = std::min(tid * step, n), end = std::min(begin + step, n);
+    size_t* local_count = count.data() + tid * 256;
+    for (size_t i = begin; i < end; i++) local_count[r[i] >> shift]++;
+  });
+  std::vector<size_t> bucket_begin(257, 0);
+  size_t sum = 0;
+  for (size_t d = 0; d < 256; d++) {
+    bucket_begin[d] = sum;
+    for (size_t tid = 0; tid < cores; tid++) {
+      size_t c = count[tid * 256 + d];
+      count[tid * 256 + d] = sum;
+      sum += c;
+    }
+  }
+  bucket_begin[256] = sum;
+  ParallelFor(pool, cores, [&](size_t tid) {
+    size_t begin = std::min(tid * step, n), end = std::min(begin + step, n);
+    size_t* local_count = count.data() + tid * 256;
+    for (size_t i = begin; i < end; i++)
+      tmp[local_count[r[i] >> shift]++] = r[i];
+  });
+
+  std::atomic<size_t> next_bucket(0);
+  ParallelFor(pool, cores, [&](size_t tid) {
+    for (size_t d = next_bucket.fetch_add(1); d < 256;
+         d = next_bucket.fetch_add(1)) {
+      size_t begin = bucket_begin[d], len = bucket_begin[d + 1] - begin;
+      if (len == 0) continue;
+      AdaptiveSort(tmp + begin, len, r + begin);
+      memcpy(r + begin, tmp + begin, sizeof(T) * len);
+    }
+  });
+}
+
 #endif
\ No newline at end of file
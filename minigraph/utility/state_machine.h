@@ -3,17 +3,12 @@
 #define MINIGRAPH_UTILITY_STATE_MACHINE_H_
 
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
-#include <map>
 #include <memory>
-#include <stdio.h>
-#include <string.h>
-#include <unordered_map>
 #include <vector>
 
-#include <boost/sml.hpp>
-#include <folly/AtomicHashMap.h>
-
 #include "portability/sys_types.h"
 #include "utility/logging.h"
 
@@ -21,321 +16,232 @@
 namespace minigraph {
 namespace utility {
 
-namespace sml = boost::sml;
-using namespace sml;
-
-// Define Events
-struct Load {};
-struct Unload {};
-struct NothingChanged {};
-struct Changed {};
-struct Aggregate {};
-struct Fixpoint {};
-struct Shortcut {};
-struct GoOn {};
-struct ShortcutRead {};
-
-// Define State Machine for each single graph.
-struct GraphStateMachine {
-  auto operator()() const {
-    using namespace sml;
-    front::event<Load> event_load;
-    front::event<ShortcutRead> event_shortcut_read;
-    front::event<Unload> event_unload;
-    front::event<NothingChanged> event_nothing_changed;
-    front::event<Changed> event_changed;
-    front::event<Aggregate> event_aggregate;
-    front::event<Shortcut> event_shortcut;
-    front::event<Fixpoint> event_fix_point;
-    front::event<GoOn> event_go_on;
-    return make_transition_table(
-        *"Idle"_s + event_load = "Active"_s, "Idle"_s + event_unload = "Idle"_s,
-        "Idle"_s + event_shortcut_read = "RT"_s,
-        "Active"_s + event_nothing_changed = "RT"_s,
-        "Active"_s + event_changed = "RC"_s,
-        "RC"_s + event_aggregate = "Idle"_s, "RC"_s + event_shortcut = "RTS"_s,
-        "RT"_s + event_go_on = "Idle"_s, "RTS"_s + event_go_on = "Idle"_s,
-        "RT"_s + event_fix_point = X);
-  }
-};
-
-// State Machine definition for each graph.
-struct SystemStateMachine {
-  auto operator()() const {
-    using namespace sml;
-    front::event<GoOn> event_go_on;
-    front::event<Fixpoint> event_fix_point;
-    return make_transition_table(*"Run"_s + event_go_on = "Run"_s,
-                                 "Run"_s + event_fix_point = X);
+// Transition table of the state machine of each single graph. Return the
+// state that event leads to from state, or 0 if event is not handled in
+// state, in which case the state is left as is.
+constexpr char GraphTransition(const char state, const char event) {
+  switch (state) {
+    case IDLE:
+      if (event == LOAD) return ACTIVE;
+      if (event == UNLOAD) return IDLE;
+      if (event == SHORTCUTREAD) return RT;
+      break;
+    case ACTIVE:
+      if (event == NOTHINGCHANGED) return RT;
+      if (event == CHANGED) return RC;
+      break;
+    case RC:
+      if (event == AGGREGATE) return IDLE;
+      if (event == SHORTCUT) return RTS;
+      break;
+    case RT:
+      if (event == GOON) return IDLE;
+      if (event == FIXPOINT) return TERMINATE;
+      break;
+    case RTS:
+      if (event == GOON) return IDLE;
+      break;
+    default:
+      break;
   }
-};
+  return 0;
+}
 
 // Class for state machine maintained in the system.
 // It start from the begining of the system and destroyed when fixpoint is
-// reached. At any point of time, a sub-graph is in one of five states:
-// Active('A'), Idle('I'), Ready-to-Terminate, i.e RT ('R'),
-// Ready-to-be-Collect, i.e RC ('C), and Terminate, i.e X('X').
+// reached. At any point of time, a sub-graph is in one of six states:
+// Active('A'), Idle('I'), Ready-to-Terminate, i.e RT ('R'), RT after a
+// shortcut, i.e RTS ('S'), Ready-to-be-Collect, i.e RC ('C), and Terminate,
+// i.e X('X').
 // The transition from one state to another is triggered by an event.
-// There are seven types of events for graph_state_: Load, Unload, ...,
-// Fixpoint. and two types of events for system_state_: GoOn and Fixpoint.
+// There are nine types of events for graph states: Load, Unload, ...,
+// Fixpoint, following GraphTransition().
 //
-// On ProcessEvent(GID_T gid, const char event), the state machine of gid
-// changed according to transition table of GraphStateMachine.
+// The state of each graph is one atomic byte in an array indexed by gid, and
+// is changed by compare-and-swap, so that no lock is taken. The number of
+// graphs in each state is kept along, hence IsTerminated() and
+// CountInState() are O(1). Counters are updated right after the state, so
+// they may lag behind a transition in flight on another thread.
 //
-// system_state_ changed from Run to X only if all state of graphs reach RT, i.e
+// The system is terminated only if all graphs reach RT or RTS, i.e
 // Fixpoint.
 template <typename GID_T>
 class StateMachine {
  public:
   StateMachine(const std::vector<GID_T>& vec_gid) {
+    if (vec_gid.empty()) return;
+    size_ = (size_t)*std::max_element(vec_gid.begin(), vec_gid.end()) + 1;
+    graph_state_ = std::make_unique<std::atomic<char>[]>(size_);
+    for (size_t i = 0; i < size_; i++) graph_state_[i].store(0);
     for (auto& iter : vec_gid) {
-      graph_state_.insert(
-          std::make_pair(iter, std::make_unique<sml::sm<GraphStateMachine>>()));
+      if (graph_state_[iter].exchange(IDLE) == 0) num_graphs_++;
     }
+    num_in_state_[StateIndex(IDLE)].store(num_graphs_);
   };
   StateMachine() {}
 
   ~StateMachine(){};
 
   void ShowGraphState(const GID_T& gid) const {
-    auto iter = graph_state_.find(gid);
-    if (iter != graph_state_.end()) {
-      iter->second->visit_current_states(
-          [](auto state) { std::cout << state.c_str() << std::endl; });
-    }
+    if (!Contains(gid)) return;
+    std::cout << StateName(graph_state_[gid].load()) << std::endl;
   };
 
-  char GetState(const GID_T& gid) {
-    assert(graph_state_.find(gid) != graph_state_.end());
-    auto iter = graph_state_.find(gid);
-    char out_state;
-    iter->second->visit_current_states([&out_state](auto state) {
-      if (strcmp(state.c_str(), "RT") == 0) out_state = RT;
-      if (strcmp(state.c_str(), "Idle") == 0) out_state = IDLE;
-      if (strcmp(state.c_str(), "RC") == 0) out_state = RC;
-      if (strcmp(state.c_str(), "RTS") == 0) out_state = RTS;
-    });
-    return out_state;
+  char GetState(const GID_T& gid) const {
+    assert(Contains(gid));
+    return graph_state_[gid].load();
   }
 
   bool GraphIs(const GID_T& gid, const char& state) const {
     assert(state == IDLE || state == ACTIVE || state == RT || state == RC ||
            state == TERMINATE || state == RTS);
-    auto iter = graph_state_.find(gid);
-    using namespace sml;
-    if (iter != graph_state_.end()) {
-      switch (state) {
-        case IDLE:
-          return iter->second->is("Idle"_s);
-        case ACTIVE:
-          return iter->second->is("Active"_s);
-        case RT:
-          return iter->second->is("RT"_s);
-        case RTS:
-          return iter->second->is("RTS"_s);
-        case RC:
-          return iter->second->is("RC"_s);
-        case TERMINATE:
-          return iter->second->is(X);
-        default:
-          break;
-      }
-    }
-    return false;
+    return Contains(gid) && graph_state_[gid].load() == state;
   };
 
+  // Number of graphs in state.
+  size_t CountInState(const char state) const {
+    return num_in_state_[StateIndex(state)].load();
+  }
+
   bool IsTerminated() {
-    using namespace sml;
-    unsigned count = 0;
-    for (auto& iter : graph_state_) {
-      iter.second->is("RT"_s) ? ++count : 0;
-      iter.second->is("RTS"_s) ? ++count : 0;
-    }
-    if (count < graph_state_.size()) {
-      return false;
-    } else {
-      system_state_.process_event(Fixpoint{});
-      assert(system_state_.is(X));
-      return true;
-    }
+    return CountInState(RT) + CountInState(RTS) == num_graphs_;
   };
 
-  GID_T GetXStateOf(const char state) {
+  GID_T GetXStateOf(const char state) const {
     GID_T gid = MINIGRAPH_GID_MAX;
-    for (auto& iter : graph_state_) {
-      switch (state) {
-        case IDLE:
-          if (iter.second->is("Idle"_s)) gid = iter.first;
-          break;
-        case ACTIVE:
-          if (iter.second->is("Active"_s)) gid = iter.first;
-          break;
-        case RT:
-          if (iter.second->is("RT"_s)) gid = iter.first;
-          break;
-        case RTS:
-          if (iter.second->is("RTS"_s)) gid = iter.first;
-          break;
-        case RC:
-          if (iter.second->is("RC"_s)) gid = iter.first;
-          break;
-        case TERMINATE:
-          if (iter.second->is(X)) gid = iter.first;
-          break;
-        default:
-          break;
-      }
-    }
+    if (CountInState(state) == 0) return gid;
+    for (size_t i = 0; i < size_; i++)
+      if (graph_state_[i].load() == state) gid = (GID_T)i;
     return gid;
   }
 
   bool ProcessEvent(GID_T gid, const char event) {
-    using namespace sml;
     assert(event == LOAD || event == UNLOAD || event == NOTHINGCHANGED ||
            event == CHANGED || event == AGGREGATE || event == FIXPOINT ||
            event == GOON || event == SHORTCUT || event == SHORTCUTREAD);
-    auto iter = graph_state_.find(gid);
-    if (iter != graph_state_.end()) {
-      switch (event) {
-        case LOAD:
-          iter->second->process_event(Load{});
-          assert(iter->second->is("Active"_s));
-          break;
-        case UNLOAD:
-          iter->second->process_event(Unload{});
-          assert(iter->second->is("Idle"_s));
-          break;
-        case NOTHINGCHANGED:
-          assert(iter->second->is("Active"_s));
-          iter->second->process_event(NothingChanged{});
-          assert(iter->second->is("RT"_s));
-          break;
-        case CHANGED:
-          assert(iter->second->is("Active"_s));
-          iter->second->process_event(Changed{});
-          assert(iter->second->is("RC"_s));
-          break;
-        case SHORTCUT:
-          iter->second->process_event(Shortcut{});
-          assert(iter->second->is("RTS"_s));
-          break;
-        case AGGREGATE:
-          iter->second->process_event(Aggregate{});
-          assert(iter->second->is("Idle"_s));
-          break;
-        case FIXPOINT:
-          iter->second->process_event(Fixpoint{});
-          assert(iter->second->is(X));
-          break;
-        case GOON:
-          iter->second->process_event(GoOn{});
-          assert(iter->second->is("Idle"_s));
-          break;
-        case SHORTCUTREAD:
-          iter->second->process_event(ShortcutRead{});
-          assert(iter->second->is("RT"_s));
-          break;
-        default:
-          break;
-      }
-      return true;
-    }
-    return false;
+    if (!Contains(gid)) return false;
+    char to = Transit(gid, event);
+    assert(to != 0);
+    (void)to;
+    return true;
   }
 
-  std::vector<GID_T> GetAllinStateX(const char state) {
+  std::vector<GID_T> GetAllinStateX(const char state) const {
     std::vector<GID_T> out;
+    if (state != RT && state != RC && state != RTS) return out;
+    size_t count = CountInState(state);
+    if (count == 0) return out;
+    out.reserve(count);
+    for (size_t i = 0; i < size_; i++)
+      if (graph_state_[i].load() == state) out.push_back((GID_T)i);
+    return out;
+  }
+
+  std::vector<GID_T> EvokeAllX(const char state) {
+    std::vector<GID_T> out = GetAllinStateX(state);
+    for (auto& iter : out) EvokeX(iter, state);
+    return out;
+  }
+
+  void EvokeX(const GID_T gid, const char state) {
+    assert(Contains(gid));
     switch (state) {
       case RT:
-        for (auto& iter : graph_state_) {
-          if (iter.second->is("RT"_s)) out.push_back(iter.first);
-        }
+      case RTS:
+        TransitFrom(gid, state, GOON);
         break;
       case RC:
-        for (auto& iter : graph_state_) {
-          if (iter.second->is("RC"_s)) out.push_back(iter.first);
-        }
-        break;
-      case RTS:
-        for (auto& iter : graph_state_) {
-          if (iter.second->is("RTS"_s)) out.push_back(iter.first);
-        }
+        TransitFrom(gid, state, AGGREGATE);
         break;
       default:
-        break;
+        return;
     }
-    return out;
+    assert(GraphIs(gid, IDLE));
   }
 
-  std::vector<GID_T> EvokeAllX(const char state) {
-    std::vector<GID_T> out;
+  void ShowAllState() const {
+    std::cout << "All state: ";
+    for (size_t i = 0; i < size_; i++) {
+      char state = graph_state_[i].load();
+      if (state != 0) std::cout << StateName(state) << "  ";
+    }
+    std::cout << std::endl;
+  }
+
+ private:
+  static size_t StateIndex(const char state) {
     switch (state) {
+      case IDLE:
+        return 0;
+      case ACTIVE:
+        return 1;
       case RT:
-        for (auto& iter : graph_state_) {
-          if (iter.second->is("RT"_s)) {
-            iter.second->process_event(GoOn{});
-            assert(iter.second->is("Idle"_s));
-            out.push_back(iter.first);
-          }
-        }
-        break;
-      case RC:
-        for (auto& iter : graph_state_) {
-          if (iter.second->is("RC"_s)) {
-            iter.second->process_event(Aggregate{});
-            assert(iter.second->is("Idle"_s));
-            out.push_back(iter.first);
-          }
-        }
-        break;
+        return 2;
       case RTS:
-        for (auto& iter : graph_state_) {
-          if (iter.second->is("RTS"_s)) {
-            iter.second->process_event(GoOn{});
-            assert(iter.second->is("Idle"_s));
-            out.push_back(iter.first);
-          }
-        }
-        break;
+        return 3;
+      case RC:
+        return 4;
+      case TERMINATE:
+        return 5;
       default:
-        break;
+        assert(false);
+        return 0;
     }
-    return out;
   }
 
-  void EvokeX(const GID_T gid, const char state) {
-    std::vector<GID_T> output;
-    auto iter = graph_state_.find(gid);
-    assert(iter != graph_state_.end());
+  static const char* StateName(const char state) {
     switch (state) {
+      case IDLE:
+        return "Idle";
+      case ACTIVE:
+        return "Active";
       case RT:
-        iter->second->is("RT"_s) ? iter->second->process_event(GoOn{}) : 0;
-        assert(iter->second->is("Idle"_s));
-        break;
-      case RC:
-        iter->second->is("RC"_s) ? iter->second->process_event(Aggregate{}) : 0;
-        assert(iter->second->is("Idle"_s));
-        break;
+        return "RT";
       case RTS:
-        iter->second->is("RTS"_s) ? iter->second->process_event(GoOn{}) : 0;
-        assert(iter->second->is("Idle"_s));
-        break;
+        return "RTS";
+      case RC:
+        return "RC";
+      case TERMINATE:
+        return "X";
+      default:
+        return "?";
     }
   }
 
-  void ShowAllState() {
-    std::cout << "All state: ";
-    for (auto& iter : graph_state_) {
-      iter.second->visit_current_states(
-          [](auto state) { std::cout << state.c_str() << "  "; });
-    }
-    std::cout << std::endl;
+  bool Contains(const GID_T gid) const {
+    return (size_t)gid < size_ && graph_state_[gid].load() != 0;
   }
 
- private:
-  std::unordered_map<GID_T, std::unique_ptr<sml::sm<GraphStateMachine>>>
-      graph_state_;
-  sml::sm<SystemStateMachine> system_state_;
+  // Apply event to gid, and return the state it leads to, or 0 if event is
+  // not handled in the current state.
+  char Transit(const GID_T gid, const char event) {
+    char from = graph_state_[gid].load();
+    char to;
+    do {
+      to = GraphTransition(from, event);
+      if (to == 0) return 0;
+    } while (!graph_state_[gid].compare_exchange_weak(from, to));
+    Count(from, to);
+    return to;
+  }
+
+  // Apply event to gid only if it is in state from.
+  void TransitFrom(const GID_T gid, char from, const char event) {
+    char to = GraphTransition(from, event);
+    if (graph_state_[gid].compare_exchange_strong(from, to)) Count(from, to);
+  }
+
+  void Count(const char from, const char to) {
+    if (from == to) return;
+    num_in_state_[StateIndex(from)].fetch_sub(1);
+    num_in_state_[StateIndex(to)].fetch_add(1);
+  }
+
+  // State of each graph, indexed by gid, and 0 for gids not in the system.
+  std::unique_ptr<std::atomic<char>[]> graph_state_;
+  size_t size_ = 0;
+  size_t num_graphs_ = 0;
+  std::atomic<size_t> num_in_state_[6] = {};
 };
 
 }  // namespace utility
@@ -0,0 +1,181 @@
+#ifndef MINIGRAPH_UTILITY_TRACER_H
+#define MINIGRAPH_UTILITY_TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utility/logging.h"
+
+namespace minigraph {
+namespace utility {
+
+// Tracer records spans of the LC -> CC -> DC pipeline, e.g. reads, PEval /
+// IncEval, writes and waits in queues, and writes them as a Chrome trace,
+// to be opened in chrome://tracing or ui.perfetto.dev. Each thread appends
+// to its own ring buffer of kCapacity spans without locking; when a buffer
+// is full its oldest spans are overwritten. Nothing is recorded until
+// Enable(), so that a disabled Tracer costs one relaxed load per span.
+class Tracer {
+ public:
+  static constexpr size_t kCapacity = 1 << 16;
+  // Waits of a fragment between the hand-offs of the pipeline, i.e. from
+  // being passed to CC, or to DC, until it is taken up.
+  static constexpr char kComputeWait[] = "ComputeWait";
+  static constexpr char kDischargeWait[] = "DischargeWait";
+
+  struct Span {
+    const char* name = nullptr;
+    const char* cat = nullptr;
+    // Phase of the Chrome trace event: 'X' for a complete span, 'b' / 'e'
+    // for the begin / end of a wait.
+    char ph = 'X';
+    size_t gid = 0;
+    // In microseconds.
+    int64_t begin = 0;
+    int64_t dur = 0;
+  };
+
+  static Tracer& Get() {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  static int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void Enable() {
+    start_time_ = Now();
+    enabled_.store(true, std::memory_order_relaxed);
+  }
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // name and cat must outlive the Tracer, e.g. be string literals.
+  void Record(const char* name, const char* cat, const size_t gid,
+              const int64_t begin, const int64_t end) {
+    if (!IsEnabled()) return;
+    Append(name, cat, 'X', gid, begin, end - begin);
+  }
+
+  // A fragment starts waiting in queue, one of the k*Wait above, and ends
+  // waiting in Dequeue(), usually on another thread. Both ends go to the
+  // buffer of the calling thread, and are paired by the trace viewer as
+  // async events with the gid as id.
+  void Enqueue(const char* queue, const size_t gid) {
+    if (!IsEnabled()) return;
+    Append(queue, "queue", 'b', gid, Now(), 0);
+  }
+
+  void Dequeue(const char* queue, const size_t gid) {
+    if (!IsEnabled()) return;
+    Append(queue, "queue", 'e', gid, Now(), 0);
+  }
+
+  // Write all spans as complete ("X") or async ("b" / "e") events of the
+  // Chrome trace format, with one tid per recording thread.
+  bool WriteChromeTrace(const std::string& pt) {
+    std::ofstream fout(pt);
+    if (!fout) {
+      XLOG(ERR, "Write file fault: ", pt);
+      return false;
+    }
+    std::lock_guard<std::mutex> lck(buffers_mtx_);
+    fout << "{\"traceEvents\": [";
+    bool first = true;
+    size_t num_spans = 0;
+    for (size_t tid = 0; tid < buffers_.size(); tid++) {
+      auto& buffer = buffers_[tid];
+      size_t end = buffer->size.load(std::memory_order_acquire);
+      size_t begin = end > kCapacity ? end - kCapacity : 0;
+      for (size_t i = begin; i < end; i++) {
+        auto& span = buffer->spans[i % kCapacity];
+        fout << (first ? "\n" : ",\n") << "{\"name\": \"" << span.name
+             << "\", \"cat\": \"" << span.cat << "\", \"ph\": \"" << span.ph
+             << "\", \"pid\": 0, \"tid\": " << tid
+             << ", \"ts\": " << span.begin - start_time_;
+        if (span.ph == 'X')
+          fout << ", \"dur\": " << span.dur;
+        else
+          fout << ", \"id\": " << span.gid;
+        fout << ", \"args\": {\"gid\": " << span.gid << "}}";
+        first = false;
+        num_spans++;
+      }
+    }
+    fout << "\n]}" << std::endl;
+    LOG_INFO("Tracer: write ", num_spans, " spans to ", pt);
+    return true;
+  }
+
+ private:
+  struct Buffer {
+    std::atomic<size_t> size{0};
+    std::vector<Span> spans;
+    Buffer() : spans(kCapacity) {}
+  };
+
+  std::atomic<bool> enabled_{false};
+  int64_t start_time_ = 0;
+
+  std::mutex buffers_mtx_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+
+  Tracer() = default;
+
+  void Append(const char* name, const char* cat, const char ph,
+              const size_t gid, const int64_t begin, const int64_t dur) {
+    auto buffer = GetThreadBuffer();
+    size_t i = buffer->size.load(std::memory_order_relaxed);
+    auto& span = buffer->spans[i % kCapacity];
+    span.name = name;
+    span.cat = cat;
+    span.ph = ph;
+    span.gid = gid;
+    span.begin = begin;
+    span.dur = dur;
+    buffer->size.store(i + 1, std::memory_order_release);
+  }
+
+  // Buffers are registered once per thread, and live as long as the Tracer.
+  Buffer* GetThreadBuffer() {
+    thread_local Buffer* buffer = nullptr;
+    if (buffer == nullptr) {
+      std::lock_guard<std::mutex> lck(buffers_mtx_);
+      buffers_.push_back(std::make_unique<Buffer>());
+      buffer = buffers_.back().get();
+    }
+    return buffer;
+  }
+};
+
+// TraceSpan records the span between its construction and destruction.
+class TraceSpan {
+ public:
+  TraceSpan(const char* name, const char* cat, const size_t gid = 0)
+      : name_(name), cat_(cat), gid_(gid) {
+    if (Tracer::Get().IsEnabled()) begin_ = Tracer::Now();
+  }
+  ~TraceSpan() {
+    if (begin_ != 0)
+      Tracer::Get().Record(name_, cat_, gid_, begin_, Tracer::Now());
+  }
+
+ private:
+  const char* name_;
+  const char* cat_;
+  size_t gid_;
+  int64_t begin_ = 0;
+};
+
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_TRACER_H
@@ -0,0 +1,243 @@
+#ifndef MINIGRAPH_UTILITY_VERTEX_REORDERER_H
+#define MINIGRAPH_UTILITY_VERTEX_REORDERER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graphs/csr_builder.h"
+#include "graphs/edgelist.h"
+#include "portability/sys_types.h"
+#include "utility/logging.h"
+#include "utility/thread_pool.h"
+
+namespace minigraph {
+namespace utility {
+
+// VertexReorderer relabels the vertexes of an edge list before partitioning,
+// so that vertexes accessed together get close ids and thus close slots in
+// vdata_. Supported orders:
+//  - degree: by total degree, descending.
+//  - rcm: reverse Cuthill-McKee on the undirected graph, i.e. a BFS starting
+//    from vertexes of minimum degree that visits neighbors by increasing
+//    degree, reversed.
+//  - gorder: a greedy Gorder-like order. The next vertex is the one that
+//    shares the most edges and common in-neighbors with the last kWindow
+//    placed vertexes.
+// Vertexes of the edge list are relabeled to [0, num_vertexes), and
+// GetOldVidByNew() maps the new ids back to the input ones.
+template <typename GID_T, typename VID_T, typename VDATA_T, typename EDATA_T>
+class VertexReorderer {
+  using EDGE_LIST_T = graphs::EdgeList<GID_T, VID_T, VDATA_T, EDATA_T>;
+  using CSR_BUILDER_T = graphs::CSRBuilder<GID_T, VID_T, VDATA_T, EDATA_T>;
+
+ public:
+  VertexReorderer(const size_t cores = 1) { cores_ = cores == 0 ? 1 : cores; }
+
+  ~VertexReorderer() {
+    if (old_vid_by_new_ != nullptr) free(old_vid_by_new_);
+  }
+
+  bool Reorder(EDGE_LIST_T* edgelist_graph, const std::string& order) {
+    if (order != "degree" && order != "rcm" && order != "gorder") {
+      XLOG(ERR, "Unknown vertex order: ", order);
+      return false;
+    }
+    LOG_INFO("Reorder(): ", order);
+    CSR_BUILDER_T csr_builder(edgelist_graph->buf_graph_,
+                              edgelist_graph->get_num_edges(),
+                              edgelist_graph->get_max_vid(), cores_);
+    num_vertexes_ = csr_builder.get_num_vertexes();
+
+    std::vector<VID_T> vertexes;
+    vertexes.reserve(num_vertexes_);
+    auto vertex_indicator = csr_builder.GetVertexIndicator();
+    for (size_t vid = 0; vid <= edgelist_graph->get_max_vid(); vid++)
+      if (vertex_indicator->get_bit(vid)) vertexes.push_back(vid);
+
+    std::vector<VID_T> new_order;
+    if (order == "degree")
+      new_order = DegreeOrder(csr_builder, vertexes);
+    else if (order == "rcm")
+      new_order = RCMOrder(csr_builder, vertexes);
+    else
+      new_order = GOrder(csr_builder, vertexes);
+    assert(new_order.size() == num_vertexes_);
+
+    if (old_vid_by_new_ != nullptr) free(old_vid_by_new_);
+    old_vid_by_new_ = (VID_T*)malloc(sizeof(VID_T) * num_vertexes_);
+    memcpy(old_vid_by_new_, new_order.data(), sizeof(VID_T) * num_vertexes_);
+    VID_T* new_vid_by_old = (VID_T*)malloc(
+        sizeof(VID_T) * ((size_t)edgelist_graph->get_max_vid() + 1));
+    for (size_t i = 0; i < num_vertexes_; i++)
+      new_vid_by_old[old_vid_by_new_[i]] = i;
+
+    LOG_INFO("Run: Relabel edges");
+    auto thread_pool = CPUThreadPool(cores_, 1);
+    std::mutex mtx;
+    std::condition_variable finish_cv;
+    std::unique_lock<std::mutex> lck(mtx);
+    std::atomic<size_t> pending_packages(cores_);
+    size_t num_ids = edgelist_graph->get_num_edges() * 2;
+    VID_T* buf_graph = edgelist_graph->buf_graph_;
+    for (size_t tid = 0; tid < cores_; tid++) {
+      thread_pool.Commit([this, tid, num_ids, buf_graph, new_vid_by_old,
+                          &pending_packages, &finish_cv]() {
+        for (size_t i = tid; i < num_ids; i += cores_)
+          buf_graph[i] = new_vid_by_old[buf_graph[i]];
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
+    }
+    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+    free(new_vid_by_old);
+
+    edgelist_graph->max_vid_ = num_vertexes_ == 0 ? 0 : num_vertexes_ - 1;
+    edgelist_graph->aligned_max_vid_ =
+        ceil(((size_t)edgelist_graph->max_vid_ + 1) / ALIGNMENT_FACTOR) *
+        ALIGNMENT_FACTOR;
+    edgelist_graph->num_vertexes_ = num_vertexes_;
+    LOG_INFO("Reorder(): num_vertexes: ", num_vertexes_,
+             " max_vid: ", edgelist_graph->max_vid_);
+    return true;
+  }
+
+  VID_T* GetOldVidByNew() { return old_vid_by_new_; }
+  size_t get_num_vertexes() const { return num_vertexes_; }
+
+ private:
+  // Number of recently placed vertexes that GOrder() scores against.
+  static constexpr size_t kWindow = 5;
+
+  size_t cores_ = 1;
+  size_t num_vertexes_ = 0;
+  VID_T* old_vid_by_new_ = nullptr;
+
+  static size_t Degree(const CSR_BUILDER_T& csr_builder, const VID_T vid) {
+    return csr_builder.get_indegree(vid) + csr_builder.get_outdegree(vid);
+  }
+
+  std::vector<VID_T> DegreeOrder(const CSR_BUILDER_T& csr_builder,
+                                 std::vector<VID_T> vertexes) {
+    std::stable_sort(vertexes.begin(), vertexes.end(),
+                     [&csr_builder](VID_T a, VID_T b) {
+                       return Degree(csr_builder, a) > Degree(csr_builder, b);
+                     });
+    return vertexes;
+  }
+
+  std::vector<VID_T> RCMOrder(const CSR_BUILDER_T& csr_builder,
+                              std::vector<VID_T> vertexes) {
+    std::stable_sort(vertexes.begin(), vertexes.end(),
+                     [&csr_builder](VID_T a, VID_T b) {
+                       return Degree(csr_builder, a) < Degree(csr_builder, b);
+                     });
+    std::vector<char> visited(csr_builder.get_max_vid() + 1, 0);
+    std::vector<VID_T> order;
+    order.reserve(vertexes.size());
+    std::vector<VID_T> nbrs;
+    for (auto root : vertexes) {
+      if (visited[root]) continue;
+      visited[root] = 1;
+      order.push_back(root);
+      // order doubles as the BFS queue.
+      for (size_t head = order.size() - 1; head < order.size(); head++) {
+        VID_T u = order[head];
+        nbrs.clear();
+        auto in_edges = csr_builder.get_in_edges(u);
+        for (size_t i = 0; i < csr_builder.get_indegree(u); i++) {
+          if (visited[in_edges[i]]) continue;
+          visited[in_edges[i]] = 1;
+          nbrs.push_back(in_edges[i]);
+        }
+        auto out_edges = csr_builder.get_out_edges(u);
+        for (size_t i = 0; i < csr_builder.get_outdegree(u); i++) {
+          if (visited[out_edges[i]]) continue;
+          visited[out_edges[i]] = 1;
+          nbrs.push_back(out_edges[i]);
+        }
+        std::stable_sort(nbrs.begin(), nbrs.end(),
+                         [&csr_builder](VID_T a, VID_T b) {
+                           return Degree(csr_builder, a) <
+                                  Degree(csr_builder, b);
+                         });
+        order.insert(order.end(), nbrs.begin(), nbrs.end());
+      }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+  }
+
+  // Scores live in a lazy max-heap: every change pushes a new entry and
+  // entries that no longer match the score are dropped when popped.
+  // Siblings are not expanded through in-neighbors of degree above
+  // max(64, sqrt(num_vertexes)) to bound the cost on hubs. Once no candidate
+  // has a positive score, the next vertex is the unplaced one of the highest
+  // degree.
+  std::vector<VID_T> GOrder(const CSR_BUILDER_T& csr_builder,
+                            const std::vector<VID_T>& vertexes) {
+    std::vector<VID_T> by_degree = DegreeOrder(csr_builder, vertexes);
+    size_t hub_degree =
+        std::max((size_t)64, (size_t)sqrt((double)vertexes.size()));
+    std::vector<int> score(csr_builder.get_max_vid() + 1, 0);
+    std::vector<char> placed(csr_builder.get_max_vid() + 1, 0);
+    std::priority_queue<std::pair<int, VID_T>> heap;
+
+    auto bump = [&](VID_T u, int delta) {
+      if (placed[u]) return;
+      score[u] += delta;
+      if (score[u] > 0) heap.push(std::make_pair(score[u], u));
+    };
+    auto update = [&](VID_T v, int delta) {
+      auto out_edges = csr_builder.get_out_edges(v);
+      for (size_t i = 0; i < csr_builder.get_outdegree(v); i++)
+        bump(out_edges[i], delta);
+      auto in_edges = csr_builder.get_in_edges(v);
+      for (size_t i = 0; i < csr_builder.get_indegree(v); i++) {
+        VID_T x = in_edges[i];
+        bump(x, delta);
+        if (csr_builder.get_outdegree(x) > hub_degree) continue;
+        auto siblings = csr_builder.get_out_edges(x);
+        for (size_t j = 0; j < csr_builder.get_outdegree(x); j++)
+          if (siblings[j] != v) bump(siblings[j], delta);
+      }
+    };
+
+    std::vector<VID_T> order;
+    order.reserve(vertexes.size());
+    size_t cursor = 0;
+    while (order.size() < vertexes.size()) {
+      bool found = false;
+      VID_T v = 0;
+      while (!heap.empty()) {
+        auto top = heap.top();
+        heap.pop();
+        if (placed[top.second] || score[top.second] != top.first) continue;
+        v = top.second;
+        found = true;
+        break;
+      }
+      if (!found) {
+        while (placed[by_degree[cursor]]) cursor++;
+        v = by_degree[cursor];
+      }
+      placed[v] = 1;
+      order.push_back(v);
+      update(v, 1);
+      if (order.size() > kWindow) update(order[order.size() - 1 - kWindow], -1);
+    }
+    return order;
+  }
+};
+
+}  // namespace utility
+}  // namespace minigraph
+
+#endif  // MINIGRAPH_UTILITY_VERTEX_REORDERER_H
@@ -0,0 +1,231 @@
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "portability/sys_data_structure.h"
+#include "portability/sys_types.h"
+#include "utility/logging.h"
+
+// benchmark runs every app of -bench_apps on every combination of
+// -bench_graphs, -bench_partitioners, -bench_schedulers, -bench_cores and
+// -bench_buffer_sizes, -bench_repeats times, and writes one row per run to
+// -bench_out, in csv or json (-bench_format). Edge lists are partitioned
+// into [-o]<graph>_<partitioner>/ with -n fragments first; graphs ending
+// with '/' are taken as workspaces as they are. Apps write their RunInfo
+// with -bench_out, which is read back after each run. Failed runs keep their
+// rows, with the exit status and the step that failed as error: runs on a
+// graph whose partitioning failed are not run, and fail as "partition".
+
+struct BenchmarkSetting {
+  std::string app;
+  std::string graph;
+  std::string partitioner;
+  std::string scheduler;
+  size_t cores = 1;
+  size_t buffer_size = 1;
+  size_t repeat = 0;
+};
+
+struct BenchmarkResult {
+  BenchmarkSetting setting;
+  int status = 0;
+  // "partition" or "run" if failed, empty otherwise.
+  std::string error;
+  double partition_time = 0;
+  RunInfo run_info;
+};
+
+std::vector<std::string> Split(const std::string& str) {
+  std::vector<std::string> out;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    if (item != "") out.push_back(item);
+  return out;
+}
+
+std::string GetBaseName(const std::string& pt) {
+  std::string name = pt.substr(pt.find_last_of('/') + 1);
+  return name.substr(0, name.find_last_of('.'));
+}
+
+// Run cmd, return its exit status and wall time in seconds.
+int Run(const std::string& cmd, double* elapsed_time) {
+  LOG_INFO("Run: ", cmd);
+  auto start_time = std::chrono::system_clock::now();
+  int status = std::system(cmd.c_str());
+  *elapsed_time = std::chrono::duration<double>(
+                      std::chrono::system_clock::now() - start_time)
+                      .count();
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Read the one line json object written by MiniGraphSys::WriteRunInfo().
+bool ReadRunInfo(const std::string& pt, RunInfo* run_info) {
+  std::ifstream fin(pt);
+  std::string line;
+  if (!fin || !std::getline(fin, line)) return false;
+  auto get = [&line](const std::string& key) {
+    auto pos = line.find("\"" + key + "\": ");
+    if (pos == std::string::npos) return 0.0;
+    return atof(line.c_str() + pos + key.size() + 4);
+  };
+  run_info->elapsed_time = get("elapsed_time");
+  run_info->read_time = get("read_time");
+  run_info->peval_time = get("peval_time");
+  run_info->inc_eval_time = get("inc_eval_time");
+  run_info->write_time = get("write_time");
+  run_info->bytes_read = get("bytes_read");
+  run_info->bytes_written = get("bytes_written");
+  run_info->supersteps = get("supersteps");
+  run_info->peak_rss = get("peak_rss");
+  return true;
+}
+
+void WriteResults(const std::vector<BenchmarkResult>& results,
+                  const std::string& pt, const bool json) {
+  std::ofstream fout(pt);
+  if (!fout) {
+    XLOG(ERR, "Write file fault: ", pt);
+    return;
+  }
+  if (json)
+    fout << "[" << std::endl;
+  else
+    fout << "app,graph,partitioner,scheduler,cores,buffer_size,repeat,status,"
+            "error,partition_time,elapsed_time,read_time,peval_time,"
+            "inc_eval_time,write_time,bytes_read,bytes_written,supersteps,"
+            "peak_rss"
+         << std::endl;
+  for (size_t i = 0; i < results.size(); i++) {
+    auto& s = results[i].setting;
+    auto& r = results[i].run_info;
+    if (json) {
+      fout << "  {\"app\": \"" << s.app << "\", \"graph\": \"" << s.graph
+           << "\", \"partitioner\": \"" << s.partitioner
+           << "\", \"scheduler\": \"" << s.scheduler
+           << "\", \"cores\": " << s.cores
+           << ", \"buffer_size\": " << s.buffer_size
+           << ", \"repeat\": " << s.repeat
+           << ", \"status\": " << results[i].status
+           << ", \"error\": \"" << results[i].error << "\""
+           << ", \"partition_time\": " << results[i].partition_time
+           << ", \"elapsed_time\": " << r.elapsed_time
+           << ", \"read_time\": " << r.read_time
+           << ", \"peval_time\": " << r.peval_time
+           << ", \"inc_eval_time\": " << r.inc_eval_time
+           << ", \"write_time\": " << r.write_time
+           << ", \"bytes_read\": " << r.bytes_read
+           << ", \"bytes_written\": " << r.bytes_written
+           << ", \"supersteps\": " << r.supersteps
+           << ", \"peak_rss\": " << r.peak_rss << "}"
+           << (i + 1 < results.size() ? "," : "") << std::endl;
+    } else {
+      fout << s.app << "," << s.graph << "," << s.partitioner << ","
+           << s.scheduler << "," << s.cores << "," << s.buffer_size << ","
+           << s.repeat << "," << results[i].status << "," << results[i].error
+           << "," << results[i].partition_time << "," << r.elapsed_time << ","
+           << r.read_time << "," << r.peval_time << "," << r.inc_eval_time
+           << "," << r.write_time << "," << r.bytes_read << ","
+           << r.bytes_written << "," << r.supersteps << "," << r.peak_rss
+           << std::endl;
+    }
+  }
+  if (json) fout << "]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  assert(FLAGS_bench_graphs != "" && FLAGS_bench_out != "");
+  assert(FLAGS_bench_format == "csv" || FLAGS_bench_format == "json");
+  std::string bin_dir = FLAGS_bin_dir;
+  std::string run_info_pt = FLAGS_bench_out + ".run";
+  std::vector<size_t> cores_list, buffer_sizes;
+  for (auto& cores : Split(FLAGS_bench_cores))
+    cores_list.push_back(std::stoul(cores));
+  for (auto& buffer_size : Split(FLAGS_bench_buffer_sizes))
+    buffer_sizes.push_back(std::stoul(buffer_size));
+  // -sep defaults to a placeholder, not to a separator.
+  std::string sep =
+      gflags::GetCommandLineFlagInfoOrDie("sep").is_default ? "," : FLAGS_sep;
+  size_t max_cores = 1;
+  for (auto cores : cores_list) max_cores = std::max(max_cores, cores);
+
+  std::vector<BenchmarkResult> results;
+  for (auto& graph : Split(FLAGS_bench_graphs)) {
+    bool is_work_space = graph.back() == '/';
+    std::vector<std::string> partitioners = Split(FLAGS_bench_partitioners);
+    if (is_work_space) partitioners = {"-"};
+    for (auto& partitioner : partitioners) {
+      BenchmarkResult result;
+      std::string work_space = graph;
+      if (!is_work_space) {
+        work_space = FLAGS_o + GetBaseName(graph) + "_" + partitioner + "/";
+        mkdir(work_space.c_str(), 0777);
+        result.status = Run(
+            bin_dir + "graph_partition_exec -t csr_bin -p -tobin -n " +
+                std::to_string(FLAGS_n) + " -i " + graph + " -sep \"" + sep +
+                "\" -o " + work_space + " -cores " +
+                std::to_string(max_cores) + " -partitioner " + partitioner,
+            &result.partition_time);
+        if (result.status != 0) {
+          XLOG(ERR, "Partition fault: ", graph, " ", partitioner,
+               " status: ", result.status);
+          result.error = "partition";
+        }
+      }
+      bool partitioned = result.status == 0;
+
+      for (auto& app : Split(FLAGS_bench_apps))
+        for (auto& scheduler : Split(FLAGS_bench_schedulers))
+          for (auto cores : cores_list)
+            for (auto buffer_size : buffer_sizes)
+              for (size_t repeat = 0; repeat < FLAGS_bench_repeats;
+                   repeat++) {
+                result.setting = {app,   graph,       partitioner, scheduler,
+                                  cores, buffer_size, repeat};
+                result.run_info = RunInfo();
+                if (!partitioned) {
+                  results.push_back(result);
+                  continue;
+                }
+                remove(run_info_pt.c_str());
+                double elapsed_time = 0;
+                result.status = Run(
+                    bin_dir + app + "_exec -i " + work_space +
+                        " -lc 1 -cc 1 -dc 1 -cores " + std::to_string(cores) +
+                        " -buffer_size " + std::to_string(buffer_size) +
+                        " -scheduler " + scheduler + " -niters " +
+                        std::to_string(FLAGS_niters) + " -bench_out " +
+                        run_info_pt,
+                    &elapsed_time);
+                result.error = "";
+                if (!ReadRunInfo(run_info_pt, &result.run_info)) {
+                  XLOG(ERR, "Run fault: ", app, " on ", work_space,
+                       " status: ", result.status);
+                  if (result.status == 0) result.status = -1;
+                  result.error = "run";
+                  result.run_info.elapsed_time = elapsed_time;
+                }
+                results.push_back(result);
+                // Rewritten after each run, so that results survive a crash.
+                WriteResults(results, FLAGS_bench_out,
+                             FLAGS_bench_format == "json");
+              }
+      if (!partitioned)
+        WriteResults(results, FLAGS_bench_out, FLAGS_bench_format == "json");
+    }
+  }
+  remove(run_info_pt.c_str());
+  LOG_INFO("Finished: ", results.size(), " runs, save at ", FLAGS_bench_out);
+  gflags::ShutDownCommandLineFlags();
+}
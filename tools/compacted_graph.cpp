@@ -11,6 +11,7 @@
 #include "portability/sys_types.h"
 #include "utility/atomic.h"
 #include "utility/bitmap.h"
+#include "utility/io/csv_edge_parser.h"
 #include "utility/io/edge_list_io_adapter.h"
 #include "utility/logging.h"
 #include "utility/thread_pool.h"
@@ -32,40 +33,23 @@ void CompressEdgelistCSV2EdgeListCSV(const std::string input_pt,
 
   auto thread_pool = minigraph::utility::CPUThreadPool(cores, 1);
 
-  rapidcsv::Document* doc =
-      new rapidcsv::Document(input_pt, rapidcsv::LabelParams((-1, -1)),
-                             rapidcsv::SeparatorParams(separator_params));
-  std::vector<VID_T>* src = new std::vector<VID_T>();
-  *src = doc->GetColumn<VID_T>(0);
-  std::vector<VID_T>* dst = new std::vector<VID_T>();
-  *dst = doc->GetColumn<VID_T>(1);
-
-  size_t num_edges = src->size();
+  minigraph::utility::io::CSVEdgeParser<VID_T> parser(input_pt, cores,
+                                                      separator_params);
+  if (!parser.Open()) return;
+  size_t num_edges = parser.CountEdges();
   VID_T* src_v = (VID_T*)malloc(sizeof(VID_T) * num_edges);
   VID_T* dst_v = (VID_T*)malloc(sizeof(VID_T) * num_edges);
-  memset(src_v, 0, sizeof(VID_T) * num_edges);
-  memset(dst_v, 0, sizeof(VID_T) * num_edges);
   VID_T max_vid(0);
+  if (!parser.Parse(src_v, dst_v, &num_edges, 1, &max_vid)) {
+    free(src_v);
+    free(dst_v);
+    return;
+  }
+  parser.Close();
 
   LOG_INFO("Read ", num_edges, " edges");
-  LOG_INFO("Run: get maximum vid");
-  for (size_t i = 0; i < cores; i++) {
-    size_t tid = i;
-    thread_pool.Commit([tid, &cores, &src_v, &dst_v, &src, &dst, &max_vid,
-                        &pending_packages, &finish_cv]() {
-      for (size_t j = tid; j < src->size(); j += cores) {
-        dst_v[j] = dst->at(j);
-        src_v[j] = src->at(j);
-        write_max(&max_vid, dst->at(j));
-        write_max(&max_vid, src->at(j));
-      }
-      if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-      return;
-    });
-  }
-  finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
   auto aligned_max_vid =
-      (ceil((float)max_vid / ALIGNMENT_FACTOR)) * ALIGNMENT_FACTOR;
+      ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
   LOG_INFO("#maximum vid: ", max_vid);
   VID_T* vid_map = (VID_T*)malloc(sizeof(VID_T) * aligned_max_vid);
   memset(vid_map, 0, sizeof(VID_T) * aligned_max_vid);
@@ -165,8 +149,6 @@ void CompressEdgelistCSV2EdgelistBin(const std::string input_pt,
   std::atomic<size_t> pending_packages(cores);
 
   auto thread_pool = minigraph::utility::CPUThreadPool(cores, 1);
-  std::vector<size_t>* src = new std::vector<size_t>();
-  std::vector<size_t>* dst = new std::vector<size_t>();
 
   size_t num_edges = 0;
   VID_T* src_v = nullptr;
@@ -175,38 +157,18 @@ void CompressEdgelistCSV2EdgelistBin(const std::string input_pt,
 
   const char* s = &separator_params;
   if (read_num_edges == 0) {
-    rapidcsv::Document* doc =
-        new rapidcsv::Document(input_pt, rapidcsv::LabelParams(-1, -1),
-                               rapidcsv::SeparatorParams(separator_params));
-    *src = doc->GetColumn<size_t>(0);
-    *dst = doc->GetColumn<size_t>(1);
-    num_edges = src->size();
+    minigraph::utility::io::CSVEdgeParser<VID_T> parser(input_pt, cores,
+                                                        separator_params);
+    if (!parser.Open()) return;
+    num_edges = parser.CountEdges();
     src_v = (VID_T*)malloc(sizeof(VID_T) * num_edges);
     dst_v = (VID_T*)malloc(sizeof(VID_T) * num_edges);
-    memset(src_v, 0, sizeof(VID_T) * num_edges);
-    memset(dst_v, 0, sizeof(VID_T) * num_edges);
-    delete doc;
-
-    for (size_t i = 0; i < cores; i++) {
-      size_t tid = i;
-      thread_pool.Commit([tid, &cores, &src_v, &dst_v, &src, &dst,
-                          &pending_packages, &finish_cv, &max_vid]() {
-        for (size_t j = tid; j < src->size(); j += cores) {
-          dst_v[j] = dst->at(j);
-          src_v[j] = src->at(j);
-          write_max(&max_vid, dst_v[j]);
-          write_max(&max_vid, src_v[j]);
-        }
-        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-        return;
-      });
+    if (!parser.Parse(src_v, dst_v, &num_edges, 1, &max_vid)) {
+      free(src_v);
+      free(dst_v);
+      return;
     }
-    finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
-    VID_T aligned_max_vid =
-        ceil((float)max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
-    delete src;
-    delete dst;
-
+    parser.Close();
   } else {
     std::string line;
     std::ifstream in(input_pt);
@@ -234,7 +196,7 @@ void CompressEdgelistCSV2EdgelistBin(const std::string input_pt,
   LOG_INFO("Read ", num_edges, " edges #");
 
   VID_T aligned_max_vid =
-      (ceil((float)max_vid / ALIGNMENT_FACTOR)) * ALIGNMENT_FACTOR;
+      ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
   LOG_INFO("Run: get maximum vid", aligned_max_vid);
 
   LOG_INFO("Max vid: ", aligned_max_vid);
@@ -295,7 +257,7 @@ void CompressEdgelistCSV2EdgelistBin(const std::string input_pt,
   graph->max_vid_ = local_id;
   graph->num_vertexes_ = local_id;
   graph->aligned_max_vid_ =
-      ceil(float(local_id) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+      ceil(((size_t)local_id + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
 
   graph->vdata_ = (VDATA_T*)malloc(sizeof(VDATA_T) * graph->get_num_vertexes());
   memset(graph->vdata_, 0, sizeof(VDATA_T) * graph->get_num_vertexes());
@@ -366,7 +328,7 @@ void CompressEdgelistBin2EdgelistBin(const std::string input_pt,
   finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
 
   VID_T aligned_max_vid =
-      ceil((float)max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+      ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
   VID_T* vid_map = (VID_T*)malloc(sizeof(VID_T) * aligned_max_vid);
   memset(vid_map, 0, sizeof(VID_T) * aligned_max_vid);
   Bitmap* visited = new Bitmap(aligned_max_vid);
@@ -427,7 +389,7 @@ void CompressEdgelistBin2EdgelistBin(const std::string input_pt,
   graph->max_vid_ = local_id;
   graph->num_vertexes_ = local_id;
   graph->aligned_max_vid_ =
-      ceil((float)graph->max_vid_ / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+      ceil(((size_t)graph->max_vid_ + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
 
   edgelist_io_adapter.Write(*graph, edgelist_bin, dst_meta_pt, dst_data_pt,
                             dst_vdata_pt);
@@ -491,7 +453,7 @@ void CompressEdgeListBin2EdgelistCSV(const std::string input_pt,
   finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
 
   VID_T aligned_max_vid =
-      ceil((float)max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+      ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
   VID_T* vid_map = (VID_T*)malloc(sizeof(VID_T) * aligned_max_vid);
   memset(vid_map, 0, sizeof(VID_T) * aligned_max_vid);
   Bitmap* visited = new Bitmap(aligned_max_vid);
@@ -552,7 +514,7 @@ void CompressEdgeListBin2EdgelistCSV(const std::string input_pt,
   graph->max_vid_ = local_id;
   graph->num_vertexes_ = local_id;
   graph->aligned_max_vid_ =
-      ceil((float)graph->max_vid_ / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+      ceil(((size_t)graph->max_vid_ + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
 
   std::vector<VID_T>* out_src = new std::vector<VID_T>;
   std::vector<VID_T>* out_dst = new std::vector<VID_T>;
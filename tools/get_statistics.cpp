@@ -3,12 +3,12 @@
 #include <string>
 
 #include <gflags/gflags.h>
-#include "rapidcsv.h"
 
 #include "graphs/edgelist.h"
 #include "portability/sys_types.h"
 #include "utility/atomic.h"
 #include "utility/bitmap.h"
+#include "utility/io/csv_edge_parser.h"
 #include "utility/io/edge_list_io_adapter.h"
 #include "utility/logging.h"
 #include "utility/thread_pool.h"
@@ -28,45 +28,27 @@ void GetGraphStatisticFromCSV(const std::string input_pt,
   std::atomic<size_t> pending_packages(cores);
   auto thread_pool = minigraph::utility::CPUThreadPool(cores, 1);
 
-  rapidcsv::Document* doc =
-      new rapidcsv::Document(input_pt, rapidcsv::LabelParams(-1, -1),
-                             rapidcsv::SeparatorParams(separator_params));
-  std::vector<VID_T>* src = new std::vector<VID_T>();
-  std::vector<VID_T>* dst = new std::vector<VID_T>();
-  src->reserve(expected_edges);
-  dst->reserve(expected_edges);
-  *src = doc->GetColumn<VID_T>(0);
-  *dst = doc->GetColumn<VID_T>(1);
-
-  size_t num_edges = src->size();
+  minigraph::utility::io::CSVEdgeParser<VID_T> parser(input_pt, cores,
+                                                      separator_params);
+  if (!parser.Open()) return;
+  size_t num_edges = parser.CountEdges();
   VID_T* src_v = (VID_T*)malloc(sizeof(VID_T) * num_edges);
   VID_T* dst_v = (VID_T*)malloc(sizeof(VID_T) * num_edges);
-  memset(src_v, 0, sizeof(VID_T) * num_edges);
-  memset(dst_v, 0, sizeof(VID_T) * num_edges);
+  VID_T max_vid = 0;
+  if (!parser.Parse(src_v, dst_v, &num_edges, 1, &max_vid)) {
+    free(src_v);
+    free(dst_v);
+    return;
+  }
+  parser.Close();
 
   LOG_INFO("read: ", num_edges, " edges");
-  VID_T max_vid = 0;
   size_t max_indegree(0);
   size_t max_outdegree(0);
   size_t max_degree(0);
 
-  for (size_t i = 0; i < cores; i++) {
-    size_t tid = i;
-    thread_pool.Commit([tid, &cores, &src_v, &dst_v, &src, &dst, &num_edges,
-                        &pending_packages, &finish_cv, &max_vid]() {
-      for (size_t j = tid; j < num_edges; j += cores) {
-        dst_v[j] = dst->at(j);
-        src_v[j] = src->at(j);
-        write_max(&max_vid, dst_v[j]);
-        write_max(&max_vid, src_v[j]);
-      }
-      if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-      return;
-    });
-  }
-  finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
-
-  auto aligned_max_vid = ceil(max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+  auto aligned_max_vid =
+      ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
 
   Bitmap visited(aligned_max_vid);
   visited.clear();
@@ -98,12 +80,11 @@ void GetGraphStatisticFromCSV(const std::string input_pt,
   LOG_INFO("Aggregate indegree and outdegree");
   pending_packages.store(cores);
   for (size_t i = 0; i < cores; i++) {
-    thread_pool.Commit([i, &cores, &src_v, &dst_v, &src, &dst, &outdegree,
-                        &indegree, &num_edges, &pending_packages,
-                        &finish_cv]() {
+    thread_pool.Commit([i, &cores, &src_v, &dst_v, &outdegree, &indegree,
+                        &num_edges, &pending_packages, &finish_cv]() {
       for (size_t j = i; j < num_edges; j += cores) {
-        __sync_fetch_and_add(indegree + dst->at(j), 1);
-        __sync_fetch_and_add(outdegree + src->at(j), 1);
+        __sync_fetch_and_add(indegree + dst_v[j], 1);
+        __sync_fetch_and_add(outdegree + src_v[j], 1);
       }
       if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
       return;
@@ -211,7 +192,8 @@ void GetGraphStatisticFromBin(const std::string input_pt,
   }
   finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
 
-  VID_T aligned_max_vid = ceil(max_vid / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
+  VID_T aligned_max_vid =
+      ceil(((size_t)max_vid + 1) / ALIGNMENT_FACTOR) * ALIGNMENT_FACTOR;
   size_t* outdegree = (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
   size_t* indegree = (size_t*)malloc(sizeof(size_t) * aligned_max_vid);
   memset(outdegree, 0, sizeof(size_t) * aligned_max_vid);
@@ -1,21 +1,29 @@
+#include <fcntl.h>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <sys/stat.h>
 #include <math.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>
+#include <fstream>
 #include <iostream>
-#include <random>
+#include <mutex>
 #include <string>
-
-#include <rapidcsv.h>
+#include <vector>
 
 #include "portability/sys_types.h"
-#include "utility/bitmap.h"
 #include "utility/logging.h"
 #include "utility/thread_pool.h"
 
+using VID_T = vid_t;
+using VDATA_T = vdata_t;
+using EDATA_T = edata_t;
 
 class GraphGen {
  public:
@@ -63,204 +71,370 @@ class GraphGen {
   };
 };
 
+// RMAT generates a Kronecker graph of 2^power vertexes and num_edges edges:
+// each edge descends power times into one of the quadrants a, b, c, d of the
+// adjacency matrix, where b and d raise the dst bit and c and d the src bit.
+// Random numbers are drawn from a counter-based generator keyed by seed and
+// the edge index, so the graph only depends on seed, never on the number of
+// cores. Edges are generated and written chunk by chunk, so memory stays
+// bounded whatever num_edges is. Duplicated edges and self loops are kept.
+//
+// With scramble, vids are relabeled by a seeded bijection of [0, 2^power),
+// so that high degree vertexes are not all at small vids. With max_weight
+// > 0, each edge gets a weight in [1, max_weight].
 class RMAT final : public GraphGen {
  public:
   RMAT(const size_t power, const size_t num_edges, const std::string& out_pt,
-       const float a, const float b, const float c, const float d)
-      : GraphGen(std::pow(2, power), num_edges, out_pt) {
-    a_ = a;
-    b_ = b;
-    c_ = c;
-    d_ = d;
-    x_ = b_ + d_;
-    y_ = c_ + d_;
+       const double a, const double b, const double c, const double d,
+       const uint64_t seed = 0, const bool scramble = false,
+       const size_t max_weight = 0)
+      : GraphGen((size_t)1 << power, num_edges, out_pt) {
+    // Normalize, in case a + b + c + d is not 1.
+    double sum = a + b + c + d;
+    a_ = a / sum;
+    ab_ = (a + b) / sum;
+    abc_ = (a + b + c) / sum;
     power_ = power;
-    x_signal_ = (bool*)malloc(sizeof(bool) * this->num_vertexes_);
-    y_signal_ = (bool*)malloc(sizeof(bool) * this->num_vertexes_);
-    memset(x_signal_, 0, sizeof(bool) * this->num_vertexes_);
-    memset(y_signal_, 0, sizeof(bool) * this->num_vertexes_);
+    mask_ = this->num_vertexes_ - 1;
+    seed_ = Mix(seed);
+    scramble_ = scramble;
+    max_weight_ = max_weight;
+    scramble_mul_[0] = Mix(seed_ + 1) | 1;
+    scramble_mul_[1] = Mix(seed_ + 2) | 1;
+    scramble_add_ = Mix(seed_ + 3);
     std::cout << "GraphInfo. num_vertexes: " << 2 << "^" << power_ << "="
-              << std::pow(2, power) << ", num_edges: " << num_edges
-              << ", a: " << a_ << ", b: " << b_ << ", c: " << c_
-              << ", d_: " << d_ << std::endl;
+              << this->num_vertexes_ << ", num_edges: " << num_edges
+              << ", a: " << a_ << ", b: " << ab_ - a_
+              << ", c: " << abc_ - ab_ << ", d: " << 1 - abc_
+              << ", seed: " << seed << ", scramble: " << scramble
+              << ", max_weight: " << max_weight << std::endl;
   }
 
-  RMAT(const size_t power, const size_t num_edges, const std::string& out_pt,
-       const float x, const float y)
-      : GraphGen(std::pow(2, power), num_edges, out_pt) {
-    x_ = x;
-    y_ = y;
-    power_ = power;
-    x_signal_ = (bool*)malloc(sizeof(bool) * this->num_vertexes_);
-    y_signal_ = (bool*)malloc(sizeof(bool) * this->num_vertexes_);
-    x_signal_bit_ = new Bitmap(this->num_vertexes_);
-    y_signal_bit_ = new Bitmap(this->num_vertexes_);
+  // Generate the graph with cores threads into num_shards shards of about
+  // the same number of edges. In edgelist_bin format (tobin), shard i is
+  // written at prefix out_pt/i/, or at out_pt if there is one shard, as
+  // minigraph_{meta, data, vdata}.bin, plus minigraph_edata.bin for weights.
+  // In csv format, shard i is written to out_pt.i, or to out_pt if there is
+  // one shard, as src,dst[,weight] lines.
+  bool Run(const size_t cores, const bool tobin, const size_t num_shards) {
+    num_shards_ = num_shards == 0 ? 1 : num_shards;
+    shard_size_ = (this->num_edges_ + num_shards_ - 1) / num_shards_;
+    if (shard_size_ == 0) shard_size_ = 1;
+    bool tag = tobin ? RunBin(cores) : RunCSV(cores);
+    if (tag)
+      LOG_INFO("Save to ", this->out_pt_, " num_edges: ", this->num_edges_,
+               " num_shards: ", num_shards_);
+    return tag;
+  }
 
-    memset(x_signal_, 0, sizeof(bool) * this->num_vertexes_);
-    memset(y_signal_, 0, sizeof(bool) * this->num_vertexes_);
-    std::cout << "GraphInfo. num_vertexes: " << 2 << "^" << power_ << "="
-              << std::pow(2, power) << ", num_edges: " << num_edges
-              << ", x: " << x_ << ", y_: " << y_ << std::endl;
+ private:
+  static constexpr size_t kChunkEdges = 1 << 16;
+
+  size_t power_ = 0;
+  double a_ = 0;
+  double ab_ = 0;
+  double abc_ = 0;
+  uint64_t mask_ = 0;
+  uint64_t seed_ = 0;
+  bool scramble_ = false;
+  size_t max_weight_ = 0;
+  uint64_t scramble_mul_[2] = {1, 1};
+  uint64_t scramble_add_ = 0;
+  size_t num_shards_ = 1;
+  size_t shard_size_ = 1;
+
+  // SplitMix64 finalizer.
+  static inline uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
   }
 
-  std::pair<std::vector<size_t>, std::vector<size_t>> Run() {
-    std::vector<size_t> src;
-    std::vector<size_t> dst;
-    src.reserve(this->num_edges_);
-    dst.reserve(this->num_edges_);
+  static inline uint64_t Next(uint64_t* state) {
+    *state += 0x9E3779B97F4A7C15ULL;
+    return Mix(*state);
+  }
+
+  // Multiplications by odd numbers, additions and xorshifts are bijections
+  // modulo 2^power.
+  inline uint64_t Scramble(uint64_t v) const {
+    size_t shift = power_ / 2 + 1;
+    v = (v * scramble_mul_[0]) & mask_;
+    v ^= v >> shift;
+    v = (v + scramble_add_) & mask_;
+    v = (v * scramble_mul_[1]) & mask_;
+    v ^= v >> shift;
+    return v;
+  }
 
-    for (size_t i = 0; i < this->num_edges_; i++) {
-      auto xy = Falling();
-      if (x_signal_[xy.first] && y_signal_[xy.second]) {
-        continue;
+  inline void GetEdge(const size_t eid, VID_T* src, VID_T* dst,
+                      EDATA_T* weight) const {
+    uint64_t state = seed_ ^ Mix(eid);
+    uint64_t u = 0, v = 0;
+    for (size_t i = 0; i < power_; i++) {
+      double r = (Next(&state) >> 11) * 0x1.0p-53;
+      u <<= 1;
+      v <<= 1;
+      if (r < a_) continue;
+      if (r < ab_) {
+        v |= 1;
+      } else if (r < abc_) {
+        u |= 1;
       } else {
-        x_signal_[xy.first] ? 0 : x_signal_[xy.first] = true;
-        y_signal_[xy.second] ? 0 : y_signal_[xy.second] = true;
-        src.push_back(xy.first);
-        dst.push_back(xy.second);
+        u |= 1;
+        v |= 1;
       }
     }
-    return std::make_pair(src, dst);
+    if (scramble_) {
+      u = Scramble(u);
+      v = Scramble(v);
+    }
+    *src = u;
+    *dst = v;
+    *weight = max_weight_ > 0 ? 1 + Next(&state) % max_weight_ : 0;
   }
 
-  std::pair<std::vector<size_t>, std::vector<size_t>> ParallelRun(
-      const size_t cores) {
-    std::vector<size_t>** p_src = new std::vector<size_t>*[cores];
-    std::vector<size_t>** p_dst = new std::vector<size_t>*[cores];
-
-    for (size_t i = 0; i < cores; i++) {
-      p_src[i] = new std::vector<size_t>;
-      p_dst[i] = new std::vector<size_t>;
-      p_src[i]->reserve(this->num_edges_ / cores);
-      p_dst[i]->reserve(this->num_edges_ / cores);
-    }
+  size_t GetNumChunks() const {
+    return (this->num_edges_ + kChunkEdges - 1) / kChunkEdges;
+  }
 
+  // Run f(tid) on cores threads and wait for all of them.
+  template <typename F>
+  void ForEachThread(const size_t cores, F&& f) {
     auto thread_pool = minigraph::utility::CPUThreadPool(cores, 1);
-
-    x_signal_bit_->clear();
-    y_signal_bit_->clear();
-
     std::mutex mtx;
     std::condition_variable finish_cv;
     std::unique_lock<std::mutex> lck(mtx);
     std::atomic<size_t> pending_packages(cores);
-    for (size_t i = 0; i < cores; i++) {
-      thread_pool.Commit(
-          [this, i, cores, &p_src, &p_dst, &pending_packages, &finish_cv]() {
-            for (size_t j = i; j < this->num_edges_; j += cores) {
-              auto xy = Falling();
-              if (x_signal_bit_->get_bit(xy.first) != 0 &&
-                  y_signal_bit_->get_bit(xy.second) != 0)
-                continue;
-              x_signal_bit_->set_bit(xy.first);
-              y_signal_bit_->set_bit(xy.second);
-              p_src[i]->push_back(xy.first);
-              p_dst[i]->push_back(xy.second);
-            }
-            if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
-            return;
-          });
+    for (size_t tid = 0; tid < cores; tid++) {
+      thread_pool.Commit([tid, &f, &pending_packages, &finish_cv]() {
+        f(tid);
+        if (pending_packages.fetch_sub(1) == 1) finish_cv.notify_all();
+        return;
+      });
     }
-
     finish_cv.wait(lck, [&] { return pending_packages.load() == 0; });
+  }
 
-    std::vector<size_t>* src = new std::vector<size_t>;
-    std::vector<size_t>* dst = new std::vector<size_t>;
-    src->reserve(this->num_edges_);
-    dst->reserve(this->num_edges_);
+  std::string GetBinPrefix(const size_t shard) const {
+    if (num_shards_ == 1) return this->out_pt_;
+    return this->out_pt_ + std::to_string(shard) + "/";
+  }
 
-    for (size_t i = 0; i < cores; i++) {
-      src->insert(src->end(), p_src[i]->begin(), p_src[i]->end());
-      dst->insert(dst->end(), p_dst[i]->begin(), p_dst[i]->end());
-      delete p_src[i];
-      delete p_dst[i];
-    }
-    return std::make_pair(*src, *dst);
+  size_t GetShardEdges(const size_t shard) const {
+    size_t begin = std::min(shard * shard_size_, this->num_edges_);
+    size_t end = std::min(begin + shard_size_, this->num_edges_);
+    return end - begin;
   }
 
-  void WriteEdgeList(
-      const std::pair<std::vector<size_t>, std::vector<size_t>>& data,
-      const std::string& out_pt) {
-    rapidcsv::Document doc("", rapidcsv::LabelParams(-1, -1),
-                           rapidcsv::SeparatorParams(',', false, false));
-    doc.SetColumnName(0, "src");
-    doc.SetColumnName(1, "dst");
-    doc.SetColumn<size_t>(0, data.first);
-    doc.SetColumn<size_t>(1, data.second);
-    doc.Save(out_pt);
-    std::cout << "Save to " << out_pt << " num edges: " << data.first.size()
-              << std::endl;
-  };
+  // Edges of each chunk are written with pwrite at their fixed offset, so
+  // threads never wait on each other.
+  bool RunBin(const size_t cores) {
+    std::vector<int> data_fds(num_shards_, -1);
+    std::vector<int> edata_fds(num_shards_, -1);
+    for (size_t shard = 0; shard < num_shards_; shard++) {
+      std::string prefix = GetBinPrefix(shard);
+      MakeDirectory(prefix);
+      std::string data_pt = prefix + "minigraph_data.bin";
+      data_fds[shard] = open(data_pt.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (data_fds[shard] < 0) {
+        XLOG(ERR, "open fault: ", data_pt);
+        return false;
+      }
+      if (max_weight_ == 0) continue;
+      std::string edata_pt = prefix + "minigraph_edata.bin";
+      edata_fds[shard] =
+          open(edata_pt.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (edata_fds[shard] < 0) {
+        XLOG(ERR, "open fault: ", edata_pt);
+        return false;
+      }
+    }
 
- private:
-  size_t power_ = 0;
-  float a_ = 0;
-  float b_ = 0;
-  float c_ = 0;
-  float d_ = 0;
-  float x_ = 0;
-  float y_ = 0;
+    size_t num_chunks = GetNumChunks();
+    std::atomic<size_t> next_chunk(0);
+    std::atomic<bool> tag(true);
+    ForEachThread(cores, [&](size_t tid) {
+      VID_T* edges = (VID_T*)malloc(sizeof(VID_T) * 2 * kChunkEdges);
+      EDATA_T* weights = (EDATA_T*)malloc(sizeof(EDATA_T) * kChunkEdges);
+      for (size_t chunk = next_chunk.fetch_add(1); chunk < num_chunks;
+           chunk = next_chunk.fetch_add(1)) {
+        size_t begin = chunk * kChunkEdges;
+        size_t end = std::min(begin + kChunkEdges, this->num_edges_);
+        for (size_t eid = begin; eid < end; eid++)
+          GetEdge(eid, edges + 2 * (eid - begin), edges + 2 * (eid - begin) + 1,
+                  weights + eid - begin);
+        // A chunk may straddle two shards.
+        for (size_t eid = begin; eid < end;) {
+          size_t shard = eid / shard_size_;
+          size_t piece_end = std::min(end, (shard + 1) * shard_size_);
+          size_t offset = eid - shard * shard_size_;
+          size_t n = piece_end - eid;
+          if (pwrite(data_fds[shard], edges + 2 * (eid - begin),
+                     sizeof(VID_T) * 2 * n,
+                     sizeof(VID_T) * 2 * offset) < 0)
+            tag = false;
+          if (max_weight_ > 0 &&
+              pwrite(edata_fds[shard], weights + eid - begin,
+                     sizeof(EDATA_T) * n, sizeof(EDATA_T) * offset) < 0)
+            tag = false;
+          eid = piece_end;
+        }
+      }
+      free(edges);
+      free(weights);
+    });
+    for (size_t shard = 0; shard < num_shards_; shard++) {
+      close(data_fds[shard]);
+      if (edata_fds[shard] >= 0) close(edata_fds[shard]);
+    }
+    if (!tag) {
+      XLOG(ERR, "pwrite fault: ", this->out_pt_);
+      return false;
+    }
+    for (size_t shard = 0; shard < num_shards_; shard++)
+      if (!WriteBinMeta(shard, cores)) return false;
+    return true;
+  }
 
-  bool* x_signal_ = nullptr;
-  bool* y_signal_ = nullptr;
-  Bitmap* x_signal_bit_ = nullptr;
-  Bitmap* y_signal_bit_ = nullptr;
+  // meta holds num_vertexes, num_edges and max_vid, and vdata the vdata of
+  // all vertexes (zeros) followed by their global ids, as EdgeListIOAdapter
+  // reads them.
+  bool WriteBinMeta(const size_t shard, const size_t cores) {
+    std::string prefix = GetBinPrefix(shard);
+    std::string meta_pt = prefix + "minigraph_meta.bin";
+    std::ofstream meta_file(meta_pt, std::ios::binary | std::ios::trunc);
+    if (!meta_file) {
+      XLOG(ERR, "open fault: ", meta_pt);
+      return false;
+    }
+    size_t meta_buff[2] = {this->num_vertexes_, GetShardEdges(shard)};
+    VID_T max_vid = this->num_vertexes_ - 1;
+    meta_file.write((char*)meta_buff, 2 * sizeof(size_t));
+    meta_file.write((char*)&max_vid, sizeof(VID_T));
+    meta_file.close();
 
-  std::pair<size_t, size_t> GetCoordinate() {
-    std::random_device rd;
-    std::default_random_engine e(rd());
-    std::srand((unsigned)time(NULL));
-    std::bernoulli_distribution X(x_);
-    std::bernoulli_distribution Y(y_);
-    auto x = X(e);
-    auto y = Y(e);
-    return std::make_pair(x, y);
+    std::string vdata_pt = prefix + "minigraph_vdata.bin";
+    int fd = open(vdata_pt.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      XLOG(ERR, "open fault: ", vdata_pt);
+      return false;
+    }
+    size_t globalid_offset = sizeof(VDATA_T) * this->num_vertexes_;
+    if (ftruncate(fd, globalid_offset + sizeof(VID_T) * this->num_vertexes_) <
+        0) {
+      close(fd);
+      XLOG(ERR, "ftruncate fault: ", vdata_pt);
+      return false;
+    }
+    size_t num_chunks =
+        (this->num_vertexes_ + kChunkEdges - 1) / kChunkEdges;
+    std::atomic<size_t> next_chunk(0);
+    std::atomic<bool> tag(true);
+    ForEachThread(cores, [&](size_t tid) {
+      VID_T* globalids = (VID_T*)malloc(sizeof(VID_T) * kChunkEdges);
+      for (size_t chunk = next_chunk.fetch_add(1); chunk < num_chunks;
+           chunk = next_chunk.fetch_add(1)) {
+        size_t begin = chunk * kChunkEdges;
+        size_t end = std::min(begin + kChunkEdges, this->num_vertexes_);
+        for (size_t vid = begin; vid < end; vid++) globalids[vid - begin] = vid;
+        if (pwrite(fd, globalids, sizeof(VID_T) * (end - begin),
+                   globalid_offset + sizeof(VID_T) * begin) < 0)
+          tag = false;
+      }
+      free(globalids);
+    });
+    close(fd);
+    if (!tag) XLOG(ERR, "pwrite fault: ", vdata_pt);
+    return tag;
   }
 
-  std::pair<size_t, size_t> Falling() {
-    std::pair<size_t, size_t> X_scope =
-        std::make_pair(0, std::pow(2, power_) - 1);
-    std::pair<size_t, size_t> Y_scope =
-        std::make_pair(0, std::pow(2, power_) - 1);
-    size_t scope = std::pow(2, power_);
-    for (size_t i = 0; i < power_; i++) {
-      auto coordinate = this->GetCoordinate();
-      scope = scope >> 1;
-      if (coordinate.first == 0) {
-        X_scope.second -= scope;
-      } else {
-        X_scope.first += scope;
+  // csv lines have varying lengths, so chunks are formatted in parallel and
+  // appended in order: a thread holds at most one formatted chunk.
+  bool RunCSV(const size_t cores) {
+    std::vector<std::ofstream> files(num_shards_);
+    for (size_t shard = 0; shard < num_shards_; shard++) {
+      std::string pt = num_shards_ == 1
+                           ? this->out_pt_
+                           : this->out_pt_ + "." + std::to_string(shard);
+      files[shard].open(pt, std::ios::out | std::ios::trunc);
+      if (!files[shard]) {
+        XLOG(ERR, "open fault: ", pt);
+        return false;
       }
-      if (coordinate.second == 0) {
-        Y_scope.second -= scope;
-      } else {
-        Y_scope.first += scope;
+    }
+
+    size_t num_chunks = GetNumChunks();
+    std::atomic<size_t> next_chunk(0);
+    size_t next_write = 0;
+    std::mutex write_mtx;
+    std::condition_variable write_cv;
+    ForEachThread(cores, [&](size_t tid) {
+      std::vector<std::string> pieces;
+      for (size_t chunk = next_chunk.fetch_add(1); chunk < num_chunks;
+           chunk = next_chunk.fetch_add(1)) {
+        size_t begin = chunk * kChunkEdges;
+        size_t end = std::min(begin + kChunkEdges, this->num_edges_);
+        size_t first_shard = begin / shard_size_;
+        pieces.assign((end - 1) / shard_size_ - first_shard + 1, "");
+        VID_T src, dst;
+        EDATA_T weight;
+        char line[64];
+        for (size_t eid = begin; eid < end; eid++) {
+          GetEdge(eid, &src, &dst, &weight);
+          int len = max_weight_ > 0
+                        ? snprintf(line, sizeof(line), "%u,%u,%u\n",
+                                   (unsigned)src, (unsigned)dst,
+                                   (unsigned)weight)
+                        : snprintf(line, sizeof(line), "%u,%u\n",
+                                   (unsigned)src, (unsigned)dst);
+          pieces[eid / shard_size_ - first_shard].append(line, len);
+        }
+        std::unique_lock<std::mutex> lck(write_mtx);
+        write_cv.wait(lck, [&] { return next_write == chunk; });
+        for (size_t i = 0; i < pieces.size(); i++)
+          files[first_shard + i] << pieces[i];
+        next_write++;
+        write_cv.notify_all();
       }
+    });
+    bool tag = true;
+    for (auto& file : files) {
+      file.close();
+      tag = tag && !file.fail();
     }
-    // LOG_INFO(X_scope.first, " ", Y_scope.second);
-    return std::make_pair(X_scope.first, Y_scope.second);
+    if (!tag) XLOG(ERR, "write fault: ", this->out_pt_);
+    return tag;
   }
 };
 
 int main(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
-  float x = FLAGS_x;
-  float y = FLAGS_y;
   size_t power = FLAGS_power;
   size_t num_edges = FLAGS_edges;
   std::string output_pt = FLAGS_o;
   size_t cores = FLAGS_cores;
-  std::cout << "RmatGen: x = " << x << ", y = " << y
-            << ", num_vertexes: " << pow(2, power)
-            << ", num_edges: " << num_edges << std::endl;
-  RMAT rmat(power, num_edges, output_pt, x, y);
-  // std::pair<std::vector<size_t>, std::vector<size_t>>&& data = rmat.Run();
-  std::pair<std::vector<size_t>, std::vector<size_t>>&& data =
-      rmat.ParallelRun(cores);
-  if (!RMAT::IsExist(output_pt)) {
-    RMAT::Touch(output_pt);
+  assert(output_pt != "" && power > 0 && power <= sizeof(VID_T) * 8);
+
+  // -a, -b, -c, -d give the quadrant probabilities; otherwise they derive
+  // from the probabilities -x of a high dst bit and -y of a high src bit.
+  double a = FLAGS_a, b = FLAGS_b, c = FLAGS_c, d = FLAGS_d;
+  if (gflags::GetCommandLineFlagInfoOrDie("a").is_default &&
+      gflags::GetCommandLineFlagInfoOrDie("b").is_default &&
+      gflags::GetCommandLineFlagInfoOrDie("c").is_default &&
+      gflags::GetCommandLineFlagInfoOrDie("d").is_default) {
+    a = (1 - FLAGS_x) * (1 - FLAGS_y);
+    b = FLAGS_x * (1 - FLAGS_y);
+    c = (1 - FLAGS_x) * FLAGS_y;
+    d = FLAGS_x * FLAGS_y;
   }
-  rmat.WriteEdgeList(data, output_pt);
+  std::cout << "RmatGen: num_vertexes: " << pow(2, power)
+            << ", num_edges: " << num_edges << ", cores: " << cores
+            << std::endl;
+  RMAT rmat(power, num_edges, output_pt, a, b, c, d, FLAGS_seed,
+            FLAGS_scramble, FLAGS_max_weight);
+  bool tag = rmat.Run(cores, FLAGS_tobin, FLAGS_shards);
 
   gflags::ShutDownCommandLineFlags();
-}
\ No newline at end of file
+  return tag ? 0 : -1;
+}
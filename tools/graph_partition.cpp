@@ -1,6 +1,8 @@
 #include <sys/stat.h>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "yaml-cpp/yaml.h"
 #include <gflags/gflags.h>
@@ -11,12 +13,18 @@
 #include "portability/sys_types.h"
 #include "utility/io/data_mngr.h"
 #include "utility/io/edge_list_io_adapter.h"
+#include "utility/io/external_csr_builder.h"
 #include "utility/paritioner/2DVC_partitioner.h"
+#include "utility/paritioner/cost_balanced_partitioner.h"
 #include "utility/paritioner/edge_cut_partitioner.h"
+#include "utility/paritioner/hdrf_partitioner.h"
 #include "utility/paritioner/hybrid_cut_partitioner.h"
+#include "utility/paritioner/multilevel_partitioner.h"
 #include "utility/paritioner/partitioner_base.h"
+#include "utility/paritioner/streaming_partitioner.h"
 #include "utility/paritioner/vertex_cut_partitioner.h"
 #include "utility/thread_pool.h"
+#include "utility/vertex_reorderer.h"
 
 using CSR_T = minigraph::graphs::ImmutableCSR<gid_t, vid_t, vdata_t, edata_t>;
 using GRAPH_BASE_T = minigraph::graphs::Graph<gid_t, vid_t, vdata_t, edata_t>;
@@ -28,9 +36,17 @@ void GraphPartitionEdgeList2CSR(std::string src_pt, std::string dst_pt,
                                 std::size_t cores, std::size_t num_partitions,
                                 char separator_params = ',',
                                 const bool frombin = false,
-                                const std::string t_partitioner = "edgecut") {
+                                const std::string t_partitioner = "edgecut",
+                                const size_t mem_budget = 0,
+                                const std::string reorder = "",
+                                const double hdrf_lambda = 1.0,
+                                const std::string cost_model_pt = "",
+                                const double load_bandwidth = 1024) {
   assert(t_partitioner == "edgecut" || t_partitioner == "vertexcut" ||
-         t_partitioner == "hybridcut" || t_partitioner == "2dvc");
+         t_partitioner == "hybridcut" || t_partitioner == "2dvc" ||
+         t_partitioner == "ldg" || t_partitioner == "fennel" ||
+         t_partitioner == "hdrf" || t_partitioner == "multilevel" ||
+         t_partitioner == "costbalanced");
 
   minigraph::utility::io::DataMngr<CSR_T> data_mngr;
   // Clean dst path.
@@ -77,6 +93,32 @@ void GraphPartitionEdgeList2CSR(std::string src_pt, std::string dst_pt,
     data_mngr.MakeDirectory(dst_pt + "minigraph_si/");
   }
 
+  // Out-of-core path: sort-based conversion with bounded memory.
+  if (mem_budget > 0 && t_partitioner == "edgecut") {
+    if (!reorder.empty())
+      LOG_INFO("Reordering is not supported out of core, skip: ", reorder);
+    minigraph::utility::io::ExternalCSRBuilder<gid_t, vid_t, vdata_t, edata_t>
+        external_csr_builder(mem_budget << 20, cores);
+    external_csr_builder.Build(src_pt, frombin ? edgelist_bin : edgelist_csv,
+                               dst_pt, num_partitions, separator_params);
+    LOG_INFO("End graph partition#");
+    return;
+  }
+
+  // Streaming path: ldg and fennel read edges from disk in bounded chunks.
+  // Reordering needs the whole graph, hence it goes the in-memory way.
+  if ((t_partitioner == "ldg" || t_partitioner == "fennel") &&
+      reorder.empty()) {
+    minigraph::utility::partitioner::StreamingPartitioner<CSR_T>
+        streaming_partitioner(t_partitioner);
+    streaming_partitioner.StreamPartition(
+        src_pt, frombin ? edgelist_bin : edgelist_csv, dst_pt, num_partitions,
+        cores, separator_params,
+        mem_budget > 0 ? mem_budget << 20 : (size_t)1 << 30);
+    LOG_INFO("End graph partition#");
+    return;
+  }
+
   minigraph::utility::io::EdgeListIOAdapter<gid_t, vid_t, vdata_t, edata_t>
       edgelist_io_adapter;
 
@@ -94,6 +136,28 @@ void GraphPartitionEdgeList2CSR(std::string src_pt, std::string dst_pt,
   else if (t_partitioner == "2dvc")
     partitioner =
         new minigraph::utility::partitioner::TwoDVCPartitioner < CSR_T > ();
+  else if (t_partitioner == "ldg" || t_partitioner == "fennel")
+    partitioner =
+        new minigraph::utility::partitioner::StreamingPartitioner<CSR_T>(
+            t_partitioner);
+  else if (t_partitioner == "hdrf")
+    partitioner = new minigraph::utility::partitioner::HDRFPartitioner<CSR_T>(
+        hdrf_lambda);
+  else if (t_partitioner == "multilevel")
+    partitioner =
+        new minigraph::utility::partitioner::MultilevelPartitioner<CSR_T>();
+  else if (t_partitioner == "costbalanced") {
+    minigraph::utility::CostModel cost_model;
+    std::vector<std::string> training_pts;
+    std::stringstream ss(cost_model_pt);
+    for (std::string pt; std::getline(ss, pt, ',');)
+      if (!pt.empty()) training_pts.push_back(pt);
+    if (!training_pts.empty() && !cost_model.Fit(training_pts))
+      LOG_INFO("Fall back to the default cost model.");
+    partitioner =
+        new minigraph::utility::partitioner::CostBalancedPartitioner<CSR_T>(
+            cost_model, load_bandwidth);
+  }
 
   // Read Graph
   auto edgelist_graph = new EDGE_LIST_T;
@@ -109,6 +173,19 @@ void GraphPartitionEdgeList2CSR(std::string src_pt, std::string dst_pt,
                                      src_pt);
   }
 
+  // Relabel vertexes and keep the permutation next to vid_map.bin, so that
+  // results can be mapped back to the input ids.
+  if (!reorder.empty()) {
+    minigraph::utility::VertexReorderer<gid_t, vid_t, vdata_t, edata_t>
+        vertex_reorderer(cores);
+    if (vertex_reorderer.Reorder(edgelist_graph, reorder)) {
+      remove((dst_pt + "minigraph_message/reorder_map.bin").c_str());
+      data_mngr.WriteVidMap(vertex_reorderer.get_num_vertexes(),
+                            vertex_reorderer.GetOldVidByNew(),
+                            dst_pt + "minigraph_message/reorder_map.bin");
+    }
+  }
+
   partitioner->ParallelPartition(edgelist_graph, num_partitions, cores, dst_pt,
                                  true);
 
@@ -174,7 +251,9 @@ int main(int argc, char* argv[]) {
 
     GraphPartitionEdgeList2CSR(src_pt, dst_pt, cores, num_partitions,
                                *FLAGS_sep.c_str(), FLAGS_frombin,
-                               FLAGS_partitioner);
+                               FLAGS_partitioner, FLAGS_mem_budget,
+                               FLAGS_reorder, FLAGS_hdrf_lambda,
+                               FLAGS_cost_model, FLAGS_load_bandwidth);
     LOG_INFO("Finished: save at ", dst_pt);
   }
 
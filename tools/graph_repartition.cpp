@@ -0,0 +1,35 @@
+#include <iostream>
+#include <string>
+
+#include <gflags/gflags.h>
+
+#include "graphs/immutable_csr.h"
+#include "portability/sys_types.h"
+#include "utility/logging.h"
+#include "utility/paritioner/repartitioner.h"
+
+using CSR_T = minigraph::graphs::ImmutableCSR<gid_t, vid_t, vdata_t, edata_t>;
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  assert(FLAGS_i != "");
+  std::string work_space = FLAGS_i;
+  // Statistics of the last run, written by MiniGraphSys.
+  std::string superstep_info_pt =
+      FLAGS_o != "" ? FLAGS_o : work_space + "minigraph_si/supersteps.csv";
+
+  std::cout << " #Repartitioning: "
+            << " workspace: " << work_space << " stats: " << superstep_info_pt
+            << " hot_ratio: " << FLAGS_hot_ratio
+            << " cold_supersteps: " << FLAGS_cold_supersteps
+            << " cores: " << FLAGS_cores << std::endl;
+
+  minigraph::utility::partitioner::Repartitioner<CSR_T> repartitioner(
+      work_space, FLAGS_cores);
+  if (!repartitioner.Repartition(superstep_info_pt, FLAGS_hot_ratio,
+                                 FLAGS_cold_supersteps))
+    return -1;
+  LOG_INFO("Finished: ", repartitioner.get_num_graphs(), " fragments at ",
+           work_space);
+  gflags::ShutDownCommandLineFlags();
+}
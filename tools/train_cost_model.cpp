@@ -0,0 +1,33 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "portability/sys_types.h"
+#include "utility/cost_model.h"
+#include "utility/logging.h"
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  assert(FLAGS_cost_model != "");
+  // The learned scheduler reads the model from the workspace given -i.
+  std::string model_pt =
+      FLAGS_o != "" ? FLAGS_o : FLAGS_i + "minigraph_si/cost_model.yaml";
+
+  std::vector<std::string> training_pts;
+  std::stringstream ss(FLAGS_cost_model);
+  for (std::string pt; std::getline(ss, pt, ',');)
+    if (!pt.empty()) training_pts.push_back(pt);
+
+  std::cout << " #Training cost model: "
+            << " training data: " << FLAGS_cost_model
+            << " model: " << model_pt << std::endl;
+
+  minigraph::utility::CostModel cost_model;
+  if (!cost_model.Fit(training_pts)) return -1;
+  if (!cost_model.Save(model_pt)) return -1;
+  LOG_INFO("Finished: ", model_pt);
+  gflags::ShutDownCommandLineFlags();
+}